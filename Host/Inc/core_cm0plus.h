@@ -0,0 +1,45 @@
+/**
+  * 主机仿真用的 core_cm0plus.h 垫片 (只在 make host-sim 的包含路径里, 排在 CMSIS 前面)
+  *
+  * 真正的内核头文件照常包含 (寄存器结构体、NVIC/SysTick 定义都用它的),
+  * 只把固件实际调用的几条 ARM 指令换成仿真引擎里的函数:
+  *   __disable_irq / __enable_irq / __get_PRIMASK / __set_PRIMASK -> 仿真的 PRIMASK
+  *   __WFI                                                       -> 推进仿真时间到下一个事件
+  * cmsis_gcc.h 里其余的内联汇编函数没人调用, 不会生成代码。
+  */
+#ifndef __HOST_CORE_CM0PLUS_SHIM_H
+#define __HOST_CORE_CM0PLUS_SHIM_H
+
+#include <stdint.h>
+
+// 先把 ARM 版本改名包含进来, 再用主机版本顶替
+#define __disable_irq   __cmsis_disable_irq
+#define __enable_irq    __cmsis_enable_irq
+#define __get_PRIMASK   __cmsis_get_PRIMASK
+#define __set_PRIMASK   __cmsis_set_PRIMASK
+#include "cmsis_compiler.h"
+#undef __disable_irq
+#undef __enable_irq
+#undef __get_PRIMASK
+#undef __set_PRIMASK
+#undef __WFI
+#undef __WFE
+#undef __NOP
+
+void     Host_DisableIrq(void);
+void     Host_EnableIrq(void);
+uint32_t Host_GetPrimask(void);
+void     Host_SetPrimask(uint32_t primask);
+void     Host_Wfi(void);
+
+#define __disable_irq()     Host_DisableIrq()
+#define __enable_irq()      Host_EnableIrq()
+#define __get_PRIMASK()     Host_GetPrimask()
+#define __set_PRIMASK(x)    Host_SetPrimask(x)
+#define __WFI()             Host_Wfi()
+#define __WFE()             Host_Wfi()
+#define __NOP()             ((void)0)
+
+#include_next <core_cm0plus.h>
+
+#endif
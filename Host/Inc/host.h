@@ -0,0 +1,145 @@
+#ifndef __HOST_H
+#define __HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================
+//  主机仿真 (make host-sim): 固件原样编译成 Linux 程序
+// ============================================================
+// 外设寄存器、Flash、内核外设都映射在芯片上的原地址 (host_sim.c), HAL 宏直接读写;
+// HAL 函数由 hal_mock.c 提供, 只做固件用得到的那部分。
+// 时间由事件驱动: 固件线程里的代码不花时间, __WFI / HAL_Delay / STOP 时推进到下一个事件,
+// 定时器、ADC 触发、过零、测速沿、串口字节都是事件, 到点置标志, 按 NVIC 优先级调中断。
+// 热模型 (host_plant.c) 按实际加热时间积分, 温度经 K 型分度换算成 ADC 码喂给 DMA 缓冲区。
+
+#define HOST_NS_PER_US      1000ULL
+#define HOST_NS_PER_MS      1000000ULL
+#define HOST_NS_PER_S       1000000000ULL
+
+// ------------------------------------------------------------
+//  引擎
+// ------------------------------------------------------------
+void     Host_Init(void);                   // 映射寄存器/Flash, 复位值; 在 app_main 之前调用
+uint64_t Host_NowNs(void);
+uint32_t Host_NowMs(void);
+void     Host_SetEnd(uint64_t end_ns);      // 到点 exit(Host_Finish())
+// 测试用: fork 之前先冲掉 stdout, 子进程的 stderr (仿真统计) 丢掉; 返回值同 fork
+int      Host_Fork(void);
+// 测试用: 子进程里 Host_Init + Host_SetQuiet(true) + setup() 后跑 app_main, *res_fd 是管道写端,
+// 钩子里把 n 字节的结果写进去再 Host_Exit; 父进程读到 out, 等子进程退出。读满返回 0, 否则 -1
+int      Host_RunFirmware(void (*setup)(void), int *res_fd, void *out, size_t n);
+void     Host_Exit(int code);               // 打印统计后退出 (场景里调用)
+bool     Host_InStop(void);
+
+// 场景回调: 每 period_ms 仿真时间调用一次 (STOP 里也照常, 长时间浸泡可以放大周期)
+typedef void (*HostTickFn)(uint32_t now_ms);
+void     Host_SetTickHook(HostTickFn fn, uint32_t period_ms);
+// 固件 printf 输出的每一行 (经遥测帧解码), 没有钩子时打印到 stdout
+void     Host_SetTextHook(void (*fn)(uint32_t now_ms, const char *line));
+// 遥测采样帧 / 远程命令应答 (type >= 0x80)
+void     Host_SetFrameHook(void (*fn)(uint32_t now_ms, uint8_t type, const uint8_t *payload, uint8_t len));
+// 串口发出的原始字节 (每次 DMA 发送完成时, 解码之前), 接 pty 之类的真实串口用
+void     Host_SetTxHook(void (*fn)(const uint8_t *data, size_t len));
+void     Host_SetQuiet(bool quiet);         // 不打印固件文本 (钩子照样调用)
+
+// ------------------------------------------------------------
+//  输入: 开关 / 按键 / 编码器 / 串口
+// ------------------------------------------------------------
+void     Host_SetIronSwitch(bool on);
+void     Host_SetGunSwitch(bool on);
+void     Host_SetHandleUp(bool up);         // 风枪拿起 (磁控断开)
+void     Host_SetKey(uint8_t raw);          // TM1637 读回的原始键码, 0xFF = 没按
+void     Host_EncoderTurn(int detents);     // 正 = 顺时针
+void     Host_UartRx(const uint8_t *data, size_t len);  // 原始字节 (460800 8N1 依次到达)
+void     Host_SendCommand(uint8_t cmd, const uint8_t *payload, uint8_t len);   // 组帧 (COBS + CRC16) 后发送
+
+// ------------------------------------------------------------
+//  输出
+// ------------------------------------------------------------
+// 数码管当前内容 (由 TM1637 总线解码), -1 = 灭
+int      Host_DisplayIron(void);
+int      Host_DisplayGun(void);
+uint32_t Host_DisplayFrames(void);          // 收到的显存帧数
+uint32_t Host_KeyReads(void);               // 读键次数
+
+typedef struct {
+    uint64_t iron_on_ns;        // 烙铁 PWM 高电平累计
+    uint64_t gun_on_ns;         // 可控硅导通累计
+    uint64_t overlap_ns;        // 两路同时导通累计 (功率仲裁要求为 0 时用)
+    uint64_t stop_ns;           // STOP 累计
+    uint32_t wdg_refresh;       // 喂狗次数
+    uint32_t wdg_resets;        // 看门狗超时次数
+    uint32_t flash_erases;
+    uint32_t flash_programs;
+    uint32_t isr_calls;
+    uint32_t events;
+} HostStats_t;
+const HostStats_t *Host_GetStats(void);
+
+// 看门狗超时: 默认打印后退出 (返回码 3); 测试可以换成自己的处理
+void     Host_SetWatchdogHook(void (*fn)(uint32_t now_ms));
+
+// Flash 镜像: 启动时从文件读, 退出时写回 (不调用就是一片全新的 Flash)
+void     Host_FlashLoad(const char *path);
+// 掉电注入: 每次擦除 / 编程一页之前调用, 返回这次实际完成的字数 (满 words = 正常完成);
+// 不满就按掉电处理: 已完成的部分留在镜像里, 写回文件后以返回码 5 退出
+typedef uint32_t (*HostFlashFn)(bool erase, uint32_t addr, uint32_t words);
+void     Host_SetFlashHook(HostFlashFn fn);
+
+// ------------------------------------------------------------
+//  热模型 / 风扇 / 市电 (host_plant.c)
+// ------------------------------------------------------------
+typedef struct {
+    // 环境
+    double ambient;             // °C
+    // 烙铁: 发热芯 (带测温) - 烙铁头 两个热容
+    double iron_w;              // 满占空比功率 (W)
+    double iron_c_heater;       // J/K
+    double iron_c_tip;          // J/K
+    double iron_g_ht;           // 发热芯 -> 烙铁头 (W/K)
+    double iron_g_loss;         // 烙铁头 -> 空气 (W/K)
+    double iron_g_load;         // 烙铁头 -> 焊件 (W/K), 场景里改 (碰大铜皮)
+    double iron_heater;         // 状态: 发热芯温度 (°C)
+    double iron_tip;            // 状态: 烙铁头温度 (°C)
+    // 风枪: 发热丝一个热容, 出风口测温一阶滞后
+    double gun_w;               // 导通时平均功率 (W)
+    double gun_c;               // J/K
+    double gun_g_still;         // 无风时的散热 (W/K)
+    double gun_g_air;           // 满风量时额外的散热 (W/K), 按转速比例
+    double gun_tau_sensor;      // 出风口测温滞后 (s)
+    double gun_heater;          // 状态
+    double gun_sensor;          // 状态
+    // 风扇
+    double fan_rpm_max;         // 满占空比转速
+    double fan_tau;             // 转速一阶响应 (s)
+    double fan_rpm;             // 状态
+    bool   fan_jammed;          // 故障注入: 转子卡死
+    bool   fan_pwm_glitch;      // PWM 斩波时在开通沿上多出一个假测速沿 (默认开)
+    // 市电
+    double mains_hz;
+    bool   mains_present;
+    // 测温故障注入
+    bool   iron_tc_open;        // 热电偶断线: 运放输出顶到满量程
+    bool   gun_tc_open;
+    bool   iron_tc_short;       // 热电偶短路: 读数停在冷端 (室温)
+    bool   iron_heater_open;    // 发热芯断路: 通电不发热
+    int    adc_noise;           // ADC 噪声幅度 (LSB, 均匀分布)
+    bool   adc_frozen;          // DMA 停了: 缓冲区不再更新
+} HostPlant_t;
+
+extern HostPlant_t host_plant;
+
+// K 型热电偶 (NIST ITS-90), 冷端按室温补偿后经放大送 ADC, 电路参数同 thermocouple.h
+double   Plant_TcMicrovolts(double t);          // 冷端 0°C 的热电势 (uV)
+uint16_t Plant_AdcCode(double t, double t_cj);  // 12 位码 (限幅)
+
+// 不跑固件时直接步进热模型 (单元测试里自己做控制回路); 跑固件时由仿真调用, 测试不要再调
+void     Plant_Reset(void);
+// dt 秒内烙铁/风枪实际收到的能量 (J), 风扇 PWM 占空比 (0~1)
+void     Plant_Step(double dt, double iron_j, double gun_j, double fan_duty);
+uint16_t Plant_IronCode(void);                  // 当前温度对应的 ADC 码 (含噪声和故障注入)
+uint16_t Plant_GunCode(void);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __HOST_BOARD_H
+#define __HOST_BOARD_H
+
+#include <stdint.h>
+
+// ============================================================
+//  主机仿真: 编译固件时用 -include 预先包含
+// ============================================================
+// board_config.h 里的 BOARD_PIN_HIGH / LOW 在这里先定义, 每次写引脚都交给引擎:
+// TM1637 总线解码、风枪门极和功率积分都要看到引脚的每一次跳变。
+// 此时 GPIO_TypeDef 还没定义, 端口按 void * 传。
+
+void Host_PinWrite(void *port, uint32_t pins, int level);
+
+#define BOARD_PIN_HIGH(port, pin)   Host_PinWrite((port), (pin), 1)
+#define BOARD_PIN_LOW(port, pin)    Host_PinWrite((port), (pin), 0)
+
+#endif
@@ -0,0 +1,573 @@
+#include "host_priv.h"
+#include "py32f0xx_bsp_printf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+// ============================================================
+//  HAL 替身: 只实现固件调用到的函数, 效果落在寄存器上, 时序交给 host_sim.c
+// ============================================================
+// 句柄状态只维护 DMA 的 (同 HAL: 没初始化或正在传时 Start 返回 HAL_BUSY);
+// 其余返回值都是 HAL_OK, 出错路径靠测试注入故障来走。
+
+__IO uint32_t uwTick;
+uint32_t uwTickPrio = (1UL << __NVIC_PRIO_BITS);
+uint32_t uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+uint32_t SystemCoreClock = 24000000;
+
+UART_HandleTypeDef DebugUartHandle;
+
+int _write(int file, char *ptr, int len);
+
+// ============================================================
+//  1. printf / BSP
+// ============================================================
+// 固件的 printf 在编译命令里改名成这个, 输出走固件自己的 _write (遥测帧)。
+// 目标板上 long 是 32 位, 固件用 %lu 打 uint32_t; 这里把单个 l 去掉按 int 取参数
+int Host_FwPrintf(const char *fmt, ...)
+{
+    char f[256];
+    char out[512];
+    size_t n = 0;
+
+    for (const char *p = fmt; *p && n < sizeof(f) - 1; p++) {
+        f[n++] = *p;
+        if (*p != '%') continue;
+        p++;
+        while (*p && strchr("-+ #0123456789.*", *p) && n < sizeof(f) - 1) f[n++] = *p++;
+        if (*p == 'l' && p[1] != 'l') p++;
+        if (!*p) break;
+        f[n++] = *p;
+    }
+    f[n] = 0;
+
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(out, sizeof(out), f, ap);
+    va_end(ap);
+    if (len > (int)sizeof(out) - 1) len = (int)sizeof(out) - 1;
+    if (len > 0) _write(1, out, len);
+    return len;
+}
+
+void BSP_USART_Config(void)
+{
+    DebugUartHandle.Instance = DEBUG_USART;
+    DebugUartHandle.Init.BaudRate = DEBUG_USART_BAUDRATE;
+    DebugUartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+    DebugUartHandle.Init.StopBits = UART_STOPBITS_1;
+    DebugUartHandle.Init.Parity = UART_PARITY_NONE;
+    DebugUartHandle.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    DebugUartHandle.Init.Mode = UART_MODE_TX_RX;
+    HAL_UART_Init(&DebugUartHandle);
+    HAL_NVIC_SetPriority(DEBUG_USART_IRQ, 0, 1);
+    HAL_NVIC_EnableIRQ(DEBUG_USART_IRQ);
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    huart->Instance->CR1 |= USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+    Host_UartSetBaud(huart->Init.BaudRate);
+    return HAL_OK;
+}
+
+// ============================================================
+//  2. 内核 / 节拍
+// ============================================================
+HAL_StatusTypeDef HAL_Init(void)
+{
+    uwTickPrio = TICK_INT_PRIORITY;
+    Host_NvicSetPriority(SysTick_IRQn, TICK_INT_PRIORITY);
+    HAL_MspInit();
+    return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+}
+
+// 线程里轮询节拍的循环 (等串口发完之类) 要看到时间在走: 每次调用算 1us
+uint32_t HAL_GetTick(void)
+{
+    if (Host_InThread()) {
+        Host_Advance(host_now + HOST_NS_PER_US);
+        Host_Service();
+    }
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t wait = Delay;
+
+    if (wait < HAL_MAX_DELAY) wait += uwTickFreq;
+    while (uwTick - start < wait) {
+        Host_Advance(HOST_NEVER);
+        Host_Service();
+    }
+}
+
+void HAL_SuspendTick(void)
+{
+    Host_TickSuspend(true);
+}
+
+void HAL_ResumeTick(void)
+{
+    Host_TickSuspend(false);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)SubPriority;
+    Host_NvicSetPriority(IRQn, PreemptPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    Host_NvicEnable(IRQn);
+}
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    (void)Regulator;
+    (void)STOPEntry;
+    Host_EnterStop();
+}
+
+// ============================================================
+//  3. 时钟: 一直是 HSI 24MHz
+// ============================================================
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    (void)RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+    SystemCoreClock = 24000000;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    (void)PeriphClkInit;
+    return HAL_OK;
+}
+
+// ============================================================
+//  4. GPIO
+// ============================================================
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    uint32_t mode = GPIO_Init->Mode;
+
+    for (uint32_t pos = 0; pos < 16; pos++) {
+        uint32_t bit = 1u << pos;
+        if (!(GPIO_Init->Pin & bit)) continue;
+
+        if ((mode & 3u) == 2u) {
+            uint32_t shift = (pos & 7u) * 4u;
+            MODIFY_REG(GPIOx->AFR[pos >> 3], 0xFu << shift, GPIO_Init->Alternate << shift);
+        }
+        MODIFY_REG(GPIOx->MODER, 3u << (pos * 2), (mode & 3u) << (pos * 2));
+        MODIFY_REG(GPIOx->OTYPER, bit, ((mode >> 4) & 1u) << pos);
+        MODIFY_REG(GPIOx->PUPDR, 3u << (pos * 2), GPIO_Init->Pull << (pos * 2));
+
+        if (mode & 0x10000000u) {
+            uint32_t shift = 8u * (pos & 3u);
+            MODIFY_REG(EXTI->EXTICR[pos >> 2], 0xFFu << shift, GPIO_GET_INDEX(GPIOx) << shift);
+            if (mode & 0x00010000u) EXTI->IMR |= bit;  else EXTI->IMR &= ~bit;
+            if (mode & 0x00020000u) EXTI->EMR |= bit;  else EXTI->EMR &= ~bit;
+            if (mode & 0x00100000u) EXTI->RTSR |= bit; else EXTI->RTSR &= ~bit;
+            if (mode & 0x00200000u) EXTI->FTSR |= bit; else EXTI->FTSR &= ~bit;
+        }
+    }
+    Host_GpioUpdate(GPIOx);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    Host_PinWrite(GPIOx, GPIO_Pin, PinState != GPIO_PIN_RESET);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+// ============================================================
+//  5. 定时器
+// ============================================================
+static uint32_t Tim_ChannelIndex(uint32_t channel)
+{
+    return channel >> 2;        // TIM_CHANNEL_1/2/3/4 = 0x0/0x4/0x8/0xC
+}
+
+static void Tim_BaseConfig(TIM_HandleTypeDef *htim)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    MODIFY_REG(tim->CR1, TIM_CR1_DIR | TIM_CR1_CMS | TIM_CR1_CKD | TIM_CR1_ARPE,
+               htim->Init.CounterMode | htim->Init.ClockDivision | htim->Init.AutoReloadPreload);
+    tim->ARR = htim->Init.Period;
+    tim->PSC = htim->Init.Prescaler;
+    tim->EGR = TIM_EGR_UG;
+    Host_TimLoad(tim);
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+    Tim_BaseConfig(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+    Tim_BaseConfig(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+    uint32_t idx = Tim_ChannelIndex(Channel);
+    volatile uint32_t *ccmr = (idx < 2) ? &tim->CCMR1 : &tim->CCMR2;
+    uint32_t shift = (idx & 1u) * 8u;
+
+    MODIFY_REG(*ccmr, 0xFFu << shift, (sConfig->OCMode | TIM_CCMR1_OC1PE | sConfig->OCFastMode) << shift);
+    MODIFY_REG(tim->CCER, TIM_CCER_CC1P << (idx * 4), sConfig->OCPolarity << (idx * 4));
+    (&tim->CCR1)[idx] = sConfig->Pulse;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->CCER |= TIM_CCER_CC1E << (Tim_ChannelIndex(Channel) * 4);
+    if (IS_TIM_BREAK_INSTANCE(tim)) tim->BDTR |= TIM_BDTR_MOE;
+    tim->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig)
+{
+    MODIFY_REG(htim->Instance->CR2, TIM_CR2_MMS, sMasterConfig->MasterOutputTrigger);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim)
+{
+    Tim_BaseConfig(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+    uint32_t idx = Tim_ChannelIndex(Channel);
+    volatile uint32_t *ccmr = (idx < 2) ? &tim->CCMR1 : &tim->CCMR2;
+    uint32_t shift = (idx & 1u) * 8u;
+
+    MODIFY_REG(*ccmr, 0xFFu << shift,
+               (sConfig->ICSelection | sConfig->ICPrescaler | (sConfig->ICFilter << 4)) << shift);
+    MODIFY_REG(tim->CCER, (TIM_CCER_CC1P | TIM_CCER_CC1NP) << (idx * 4), sConfig->ICPolarity << (idx * 4));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+    uint32_t idx = Tim_ChannelIndex(Channel);
+
+    tim->DIER |= TIM_DIER_CC1IE << idx;
+    tim->CCER |= TIM_CCER_CC1E << (idx * 4);
+    tim->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+// 同 HAL: 所有通道都关了才停计数器
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+    uint32_t idx = Tim_ChannelIndex(Channel);
+
+    tim->DIER &= ~(TIM_DIER_CC1IE << idx);
+    tim->CCER &= ~(TIM_CCER_CC1E << (idx * 4));
+    if (!(tim->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E))) tim->CR1 &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    Tim_BaseConfig(htim);
+    MODIFY_REG(tim->SMCR, TIM_SMCR_SMS, sConfig->EncoderMode);
+    tim->CCMR1 = sConfig->IC1Selection | (sConfig->IC1Filter << 4) |
+                 ((sConfig->IC2Selection | (sConfig->IC2Filter << 4)) << 8);
+    tim->CCER = sConfig->IC1Polarity | (sConfig->IC2Polarity << 4);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    (void)Channel;
+    htim->Instance->CCER |= TIM_CCER_CC1E | TIM_CCER_CC2E;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+// ============================================================
+//  6. DMA / ADC
+// ============================================================
+static uint32_t Dma_Shift(const DMA_Channel_TypeDef *ch)
+{
+    uint32_t n = ((uint32_t)(uintptr_t)ch - DMA1_Channel1_BASE) / (DMA1_Channel2_BASE - DMA1_Channel1_BASE);
+    return n * 4u;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    const DMA_InitTypeDef *in = &hdma->Init;
+
+    hdma->Instance->CCR = in->Direction | in->PeriphInc | in->MemInc | in->PeriphDataAlignment |
+                          in->MemDataAlignment | in->Mode | in->Priority;
+    hdma->DmaBaseAddress = DMA1;
+    hdma->ChannelIndex = Dma_Shift(hdma->Instance);
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+void HAL_DMA_ChannelMap(DMA_HandleTypeDef *hdma, uint32_t MapReqNum)
+{
+    (void)hdma;
+    (void)MapReqNum;
+}
+
+static void Dma_Setup(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len)
+{
+    DMA_Channel_TypeDef *ch = hdma->Instance;
+
+    ch->CCR &= ~DMA_CCR_EN;
+    ch->CNDTR = len;
+    if (ch->CCR & DMA_CCR_DIR) {
+        ch->CPAR = dst;
+        ch->CMAR = src;
+    } else {
+        ch->CPAR = src;
+        ch->CMAR = dst;
+    }
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    if (hdma->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    Dma_Setup(hdma, SrcAddress, DstAddress, DataLength);
+    hdma->Instance->CCR |= DMA_CCR_EN;
+    if (hdma->Instance == DMA1_Channel3) Host_UartRxDmaStart(DataLength);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    if (hdma->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    Dma_Setup(hdma, SrcAddress, DstAddress, DataLength);
+    hdma->Instance->CCR |= DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+    if (DstAddress == (uint32_t)(uintptr_t)&USART1->DR) {
+        Host_UartTxStart((const uint8_t *)(uintptr_t)SrcAddress, DataLength);
+    }
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    DMA_Channel_TypeDef *ch = hdma->Instance;
+    uint32_t shift = hdma->ChannelIndex;
+
+    Host_Sync();
+    if ((DMA1->ISR & (DMA_ISR_TCIF1 << shift)) && (ch->CCR & DMA_CCR_TCIE)) {
+        if (!(ch->CCR & DMA_CCR_CIRC)) {
+            ch->CCR &= ~(DMA_CCR_TCIE | DMA_CCR_TEIE);
+            ch->CNDTR = 0;
+        }
+        DMA1->IFCR = (DMA_IFCR_CGIF1 | DMA_IFCR_CTCIF1) << shift;
+        Host_Sync();
+        hdma->State = HAL_DMA_STATE_READY;
+        if (hdma->XferCpltCallback) hdma->XferCpltCallback(hdma);
+    }
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    const ADC_InitTypeDef *in = &hadc->Init;
+
+    hadc->Instance->CFGR1 = in->Resolution | in->DataAlign | in->ExternalTrigConv | in->ExternalTrigConvEdge |
+                            (in->DMAContinuousRequests == ENABLE ? ADC_CFGR1_DMACFG : 0) |
+                            (in->Overrun == ADC_OVR_DATA_OVERWRITTEN ? ADC_CFGR1_OVRMOD : 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    hadc->Instance->CHSELR |= 1u << (sConfig->Channel & 0x1Fu);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    MODIFY_REG(adc->CFGR1, ADC_CFGR1_AWDCH | ADC_CFGR1_AWDSGL | ADC_CFGR1_AWDEN,
+               AnalogWDGConfig->WatchdogMode | ((AnalogWDGConfig->Channel & 0x1Fu) << ADC_CFGR1_AWDCH_Pos));
+    adc->TR = (AnalogWDGConfig->HighThreshold << ADC_TR_HT_Pos) | AnalogWDGConfig->LowThreshold;
+    if (AnalogWDGConfig->ITMode == ENABLE) adc->IER |= ADC_IER_AWDIE;
+    else                                    adc->IER &= ~ADC_IER_AWDIE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    DMA_HandleTypeDef *hdma = hadc->DMA_Handle;
+
+    Dma_Setup(hdma, (uint32_t)(uintptr_t)&hadc->Instance->DR, (uint32_t)(uintptr_t)pData, Length);
+    hdma->Instance->CCR |= DMA_CCR_EN;
+    hadc->Instance->IER |= ADC_IER_OVRIE;
+    hadc->Instance->CR |= ADC_CR_ADSTART;
+    Host_AdcStart((uint16_t *)pData, Length);
+    return HAL_OK;
+}
+
+// ============================================================
+//  7. Flash (映射在 0x08000000 的内存镜像)
+// ============================================================
+static HostFlashFn flash_hook = NULL;
+static const char *flash_path = NULL;
+
+void Host_SetFlashHook(HostFlashFn fn)
+{
+    flash_hook = fn;
+}
+
+void Host_FlashLoad(const char *path)
+{
+    flash_path = path;
+    FILE *f = fopen(path, "rb");
+    if (!f) return;     // 第一次运行: 全新的 Flash
+    size_t n = fread((void *)FLASH_BASE, 1, FLASH_SIZE, f);
+    fclose(f);
+    (void)n;
+}
+
+void Host_FlashSave(void)
+{
+    if (!flash_path) return;
+    FILE *f = fopen(flash_path, "wb");
+    if (!f) return;
+    fwrite((const void *)FLASH_BASE, 1, FLASH_SIZE, f);
+    fclose(f);
+}
+
+static uint32_t Flash_Begin(bool erase, uint32_t addr, uint32_t words)
+{
+    Host_CountFlash(erase);
+    return flash_hook ? flash_hook(erase, addr, words) : words;
+}
+
+static void Flash_PowerLoss(void)
+{
+    fprintf(stderr, "host: power lost during flash operation at %.3f s\n", (double)host_now * 1e-9);
+    Host_Exit(5);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    const uint32_t words = FLASH_PAGE_SIZE / 4;
+
+    *PageError = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < pEraseInit->NbPages; i++) {
+        uint32_t addr = pEraseInit->PageAddress + i * FLASH_PAGE_SIZE;
+        uint32_t done = Flash_Begin(true, addr, words);
+        if (done > words) done = words;
+        memset((void *)(uintptr_t)addr, 0xFF, done * 4);
+        if (done < words) Flash_PowerLoss();
+    }
+    return HAL_OK;
+}
+
+// 页编程: 只能把 1 写成 0
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t *DataAddr)
+{
+    const uint32_t words = FLASH_PAGE_SIZE / 4;
+    volatile uint32_t *dst = (volatile uint32_t *)(uintptr_t)Address;
+
+    (void)TypeProgram;
+    uint32_t done = Flash_Begin(false, Address, words);
+    if (done > words) done = words;
+    for (uint32_t i = 0; i < done; i++) dst[i] &= DataAddr[i];
+    if (done < words) Flash_PowerLoss();
+    return HAL_OK;
+}
+
+// ============================================================
+//  8. 看门狗 / LPTIM
+// ============================================================
+HAL_StatusTypeDef HAL_IWDG_Init(IWDG_HandleTypeDef *hiwdg)
+{
+    uint32_t div = 4u << hiwdg->Init.Prescaler;
+    Host_IwdgStart(hiwdg->Init.Reload * div * 1000u / LSI_VALUE);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg)
+{
+    (void)hiwdg;
+    Host_IwdgRefresh();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LPTIM_Init(LPTIM_HandleTypeDef *hlptim)
+{
+    hlptim->Instance->CFGR = hlptim->Init.Prescaler | hlptim->Init.UpdateMode;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LPTIM_SetOnce_Stop_IT(LPTIM_HandleTypeDef *hlptim)
+{
+    hlptim->Instance->CR &= ~LPTIM_CR_ENABLE;
+    hlptim->Instance->IER &= ~LPTIM_IER_ARRMIE;
+    Host_Sync();
+    return HAL_OK;
+}
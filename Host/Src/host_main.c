@@ -0,0 +1,48 @@
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================
+//  make host-sim 的默认场景: 上电, 按命令行打开开关, 跑到指定时间
+// ============================================================
+// 用法: Build/host/host-sim [-t 秒] [-i] [-g] [-q] [-s 毫秒] [-f flash.bin]
+//   -i  烙铁开关打开        -g  风枪开关打开并拿起
+//   -q  不打印固件输出      -s  状态行间隔 (默认 1000ms, 0 = 不打印)
+//   -f  Flash 镜像文件 (读入, 退出时写回), 连续几次运行之间保留设置
+
+int app_main(void);     // User/main.c.bkup 的 main (编译时改名)
+
+static void Status(uint32_t now_ms)
+{
+    printf("[%10.3f] iron %6.1f C (tip %6.1f) disp %4d | gun %6.1f C disp %4d | fan %5.0f rpm\n",
+           now_ms / 1000.0, host_plant.iron_heater, host_plant.iron_tip, Host_DisplayIron(),
+           host_plant.gun_sensor, Host_DisplayGun(), host_plant.fan_rpm);
+}
+
+int main(int argc, char **argv)
+{
+    double   seconds = 60;
+    uint32_t status_ms = 1000;
+    int      opt;
+
+    Host_Init();
+    while ((opt = getopt(argc, argv, "t:igqs:f:")) != -1) {
+        switch (opt) {
+        case 't': seconds = atof(optarg); break;
+        case 'i': Host_SetIronSwitch(true); break;
+        case 'g': Host_SetGunSwitch(true); Host_SetHandleUp(true); break;
+        case 'q': Host_SetQuiet(true); break;
+        case 's': status_ms = (uint32_t)atoi(optarg); break;
+        case 'f': Host_FlashLoad(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-t seconds] [-i] [-g] [-q] [-s status_ms] [-f flash.bin]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (status_ms) Host_SetTickHook(Status, status_ms);
+    Host_SetEnd((uint64_t)(seconds * HOST_NS_PER_S));
+    app_main();
+    return 0;
+}
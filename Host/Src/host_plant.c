@@ -0,0 +1,136 @@
+#include "host_priv.h"
+#include <math.h>
+
+// ============================================================
+//  被控对象: 烙铁 / 风枪 / 风扇 / 热电偶放大 + ADC
+// ============================================================
+// 参数按常见 40W 烙铁和 700W 风枪取的量级, 不是某一把的实测值;
+// 测试需要别的对象时直接改 host_plant 里的字段。
+
+HostPlant_t host_plant;
+
+static uint32_t noise_state = 0x12345678u;
+
+void Plant_Reset(void)
+{
+    HostPlant_t *p = &host_plant;
+
+    p->ambient = 25.0;
+
+    // 烙铁: 发热芯 1.5 J/K + 烙铁头 3 J/K, 300°C 空载约 8W
+    p->iron_w = 40.0;
+    p->iron_c_heater = 1.5;
+    p->iron_c_tip = 3.0;
+    p->iron_g_ht = 0.5;
+    p->iron_g_loss = 8.0 / 275.0;
+    p->iron_g_load = 0;
+    p->iron_heater = p->ambient;
+    p->iron_tip = p->ambient;
+
+    // 风枪: 满风量 300°C 约 330W, 出风口测温滞后 3s
+    p->gun_w = 700.0;
+    p->gun_c = 20.0;
+    p->gun_g_still = 0.1;
+    p->gun_g_air = 1.1;
+    p->gun_tau_sensor = 3.0;
+    p->gun_heater = p->ambient;
+    p->gun_sensor = p->ambient;
+
+    p->fan_rpm_max = 6000;
+    p->fan_tau = 0.5;
+    p->fan_rpm = 0;
+    p->fan_jammed = false;
+    p->fan_pwm_glitch = true;
+
+    p->mains_hz = 50.0;
+    p->mains_present = true;
+
+    p->iron_tc_open = p->gun_tc_open = false;
+    p->iron_tc_short = p->iron_heater_open = false;
+    p->adc_noise = 2;       // 没有噪声时监控会把稳态读数当成 "DMA 停了"
+    p->adc_frozen = false;
+}
+
+// NIST ITS-90 K 型参考函数 (0 ~ 1372°C), 0°C 以下按线性外推
+double Plant_TcMicrovolts(double t)
+{
+    static const double c[10] = {
+        -0.176004136860e-01,  0.389212049750e-01,  0.185587700320e-04, -0.994575928740e-07,
+         0.318409457190e-09, -0.560728448890e-12,  0.560750590590e-15, -0.320207200030e-18,
+         0.971511471520e-22, -0.121047212750e-25,
+    };
+    if (t < 0) return t * 39.45;
+
+    double e = 0, x = 1;
+    for (int i = 0; i < 10; i++) {
+        e += c[i] * x;
+        x *= t;
+    }
+    e += 0.118597600000 * exp(-0.118343200000e-03 * (t - 126.9686) * (t - 126.9686));
+    return e * 1000.0;
+}
+
+// 热电偶只看得到热端和冷端的差; 放大 120 倍, 3.3V 满量程 12 位
+uint16_t Plant_AdcCode(double t, double t_cj)
+{
+    double uv = Plant_TcMicrovolts(t) - Plant_TcMicrovolts(t_cj);
+    double code = uv * 1e-6 * 120.0 / 3.3 * 4096.0;
+
+    if (code < 0) code = 0;
+    if (code > 4095) code = 4095;
+    return (uint16_t)lround(code);
+}
+
+static int Noise(void)
+{
+    if (host_plant.adc_noise <= 0) return 0;
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    return (int)(noise_state % (uint32_t)(2 * host_plant.adc_noise + 1)) - host_plant.adc_noise;
+}
+
+static uint16_t With_Noise(uint16_t code)
+{
+    int v = code + Noise();
+    if (v < 0) v = 0;
+    if (v > 4095) v = 4095;
+    return (uint16_t)v;
+}
+
+uint16_t Plant_IronCode(void)
+{
+    if (host_plant.iron_tc_open) return 4095;
+    if (host_plant.iron_tc_short) return With_Noise(0);
+    return With_Noise(Plant_AdcCode(host_plant.iron_heater, host_plant.ambient));
+}
+
+uint16_t Plant_GunCode(void)
+{
+    if (host_plant.gun_tc_open) return 4095;
+    return With_Noise(Plant_AdcCode(host_plant.gun_sensor, host_plant.ambient));
+}
+
+void Plant_Step(double dt, double iron_j, double gun_j, double fan_duty)
+{
+    HostPlant_t *p = &host_plant;
+    int    n = (int)ceil(dt / 0.01);
+    double h = dt / n;
+    double p_iron = iron_j / dt;
+    double p_gun = gun_j / dt;
+
+    // 风扇: 一阶, 输入在 dt 里不变, 用精确解
+    double target = p->fan_jammed ? 0 : fan_duty * p->fan_rpm_max;
+    p->fan_rpm += (target - p->fan_rpm) * (1 - exp(-dt / p->fan_tau));
+    double g_gun = p->gun_g_still + p->gun_g_air * p->fan_rpm / p->fan_rpm_max;
+
+    for (int i = 0; i < n; i++) {
+        double q_ht = p->iron_g_ht * (p->iron_heater - p->iron_tip);
+        double q_out = (p->iron_g_loss + p->iron_g_load) * (p->iron_tip - p->ambient);
+        p->iron_heater += h * (p_iron - q_ht) / p->iron_c_heater;
+        p->iron_tip += h * (q_ht - q_out) / p->iron_c_tip;
+
+        p->gun_heater += h * (p_gun - g_gun * (p->gun_heater - p->ambient)) / p->gun_c;
+        p->gun_sensor += (p->gun_heater - p->gun_sensor) * h / p->gun_tau_sensor;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef __HOST_PRIV_H
+#define __HOST_PRIV_H
+
+#include "py32f0xx_hal.h"
+#include "host.h"
+#include "host_board.h"
+#include "board_config.h"
+
+// ============================================================
+//  仿真内部接口 (Host/Src 之间用, 场景/测试只用 host.h)
+// ============================================================
+
+#define HOST_NEVER          UINT64_MAX
+
+// ------------------------------------------------------------
+//  host_sim.c: 时间 / 中断 / 外设模型
+// ------------------------------------------------------------
+extern uint64_t host_now;                       // 仿真时间 (ns)
+
+void Host_Sync(void);                           // 寄存器语义整理 + 计数器追到 host_now
+void Host_Service(void);                        // 按优先级进挂起的中断
+void Host_Advance(uint64_t until);              // 推进到 until 或下一个事件 (先到者) 并处理
+bool Host_InThread(void);                       // 当前不在中断里
+
+void Host_NvicSetPriority(IRQn_Type irq, uint32_t prio);
+void Host_NvicEnable(IRQn_Type irq);
+void Host_TickSuspend(bool suspend);
+void Host_EnterStop(void);
+
+void Host_TimLoad(TIM_TypeDef *tim);            // UG 事件: 预装载值生效, 计数清零
+void Host_AdcStart(uint16_t *buf, uint32_t len);
+void Host_UartSetBaud(uint32_t baud);
+void Host_UartTxStart(const uint8_t *data, uint32_t len);
+void Host_UartRxDmaStart(uint32_t len);
+void Host_IwdgStart(uint32_t timeout_ms);
+void Host_IwdgRefresh(void);
+void Host_CountFlash(bool erase);
+
+void Host_GpioUpdate(GPIO_TypeDef *port);       // 重新算 IDR (输出脚 = ODR, 输入脚 = 外部电平)
+
+// ------------------------------------------------------------
+//  host_tm1637.c: TM1637 芯片 (总线解码 + 按键应答)
+// ------------------------------------------------------------
+void     Tm_Bus(int clk, int dio);              // MCU 一侧 CLK / DIO 线电平变化
+int      Tm_DioDrive(void);                     // 芯片对 DIO 的驱动 (0 = 拉低, 1 = 释放)
+void     Tm_SetKey(uint8_t raw);
+int      Tm_DisplayIron(void);
+int      Tm_DisplayGun(void);
+uint32_t Tm_Frames(void);
+uint32_t Tm_KeyReads(void);
+
+// ------------------------------------------------------------
+//  hal_mock.c
+// ------------------------------------------------------------
+void     Host_FlashSave(void);
+
+#endif
@@ -0,0 +1,1216 @@
+#include "host_priv.h"
+#include "crc16.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ============================================================
+//  仿真引擎: 寄存器映射 / 事件 / 中断 / 外设模型
+// ============================================================
+// 固件直接读写外设寄存器 (宏展开成 TIMx->SR 之类), 寄存器就放在芯片上的原地址,
+// 引擎在每次进入时 (Host_Sync) 把固件写进去的值按硬件语义整理一遍:
+//   TIM SR  (rc_w0): 写 0 的位清掉, 写 1 不起作用 -> 真实标志 &= 写入值
+//   EXTI PR / ADC ISR (w1c): 读回值带一个标记位 (bit31), 标记没了说明固件写过
+//   DMA IFCR / LPTIM ICR: 非 0 就清对应标志, 然后写回 0
+//   CNT: 和上次写回的值不同 = 固件改过计数器, 从新值接着数
+// 固件代码本身不花时间, 时间只在 __WFI / HAL_GetTick / HAL_Delay / STOP 里推进。
+
+void SysTick_Handler(void);
+void TIM14_IRQHandler(void);
+void TIM16_IRQHandler(void);
+void TIM17_IRQHandler(void);
+void EXTI0_1_IRQHandler(void);
+void EXTI2_3_IRQHandler(void);
+void EXTI4_15_IRQHandler(void);
+void LPTIM1_IRQHandler(void);
+void TIM3_IRQHandler(void);
+void DMA1_Channel2_3_IRQHandler(void);
+void ADC_COMP_IRQHandler(void);
+void USART1_IRQHandler(void);
+int app_main(void);      // User/main.c.bkup 的 main (编译时改名), Host_RunFirmware 用
+
+uint64_t host_now = 0;
+
+static HostStats_t stats;
+static uint64_t    end_ns = HOST_NEVER;
+static struct timespec wall_start;
+
+// ============================================================
+//  1. 寄存器映射
+// ============================================================
+static void Map(uintptr_t base, size_t size, int fill)
+{
+    void *p = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void *)base) {
+        fprintf(stderr, "host: cannot map 0x%08lx (%zu bytes)\n", (unsigned long)base, size);
+        exit(2);
+    }
+    memset(p, fill, size);
+}
+
+// ============================================================
+//  2. NVIC / PRIMASK
+// ============================================================
+#define PRIO_THREAD     4u          // 线程模式: 比任何中断 (0~3) 都低
+#define SLOT_SYSTICK    32          // nvic_prio[] 里 SysTick 的位置
+
+static void (*const vectors[32])(void) = {
+    [EXTI0_1_IRQn]          = EXTI0_1_IRQHandler,
+    [EXTI2_3_IRQn]          = EXTI2_3_IRQHandler,
+    [EXTI4_15_IRQn]         = EXTI4_15_IRQHandler,
+    [DMA1_Channel2_3_IRQn]  = DMA1_Channel2_3_IRQHandler,
+    [ADC_COMP_IRQn]         = ADC_COMP_IRQHandler,
+    [TIM3_IRQn]             = TIM3_IRQHandler,
+    [LPTIM1_IRQn]           = LPTIM1_IRQHandler,
+    [TIM14_IRQn]            = TIM14_IRQHandler,
+    [TIM16_IRQn]            = TIM16_IRQHandler,
+    [TIM17_IRQn]            = TIM17_IRQHandler,
+    [USART1_IRQn]           = USART1_IRQHandler,
+};
+
+static uint8_t  nvic_prio[33];
+static uint32_t nvic_enabled = 0;
+static uint32_t primask = 0;
+static uint32_t active_prio = PRIO_THREAD;
+
+static bool     systick_on = false;         // HAL_Init 之后
+static bool     systick_suspended = false;
+static bool     systick_pending = false;
+static uint64_t systick_next = HOST_NEVER;
+
+void Host_NvicSetPriority(IRQn_Type irq, uint32_t prio)
+{
+    if (irq == SysTick_IRQn) {
+        nvic_prio[SLOT_SYSTICK] = (uint8_t)prio;
+        systick_on = true;
+        if (systick_next == HOST_NEVER) systick_next = host_now + HOST_NS_PER_MS;
+    } else if (irq >= 0) {
+        nvic_prio[irq] = (uint8_t)prio;
+    }
+}
+
+void Host_NvicEnable(IRQn_Type irq)
+{
+    if (irq >= 0) nvic_enabled |= 1u << irq;
+}
+
+void Host_TickSuspend(bool suspend)
+{
+    Host_Sync();
+    systick_suspended = suspend;
+    systick_next = suspend ? HOST_NEVER : host_now + HOST_NS_PER_MS;
+}
+
+bool Host_InThread(void)
+{
+    return active_prio == PRIO_THREAD;
+}
+
+// ============================================================
+//  3. 定时器 (TIM3 / TIM14 / TIM16 / TIM17, 都在 HSI 时钟域, STOP 里冻结)
+// ============================================================
+typedef struct {
+    TIM_TypeDef *r;
+    uint32_t     sr;            // 真实标志
+    uint32_t     cnt;           // t0 时刻的计数
+    uint64_t     t0;            // 对齐到计数沿
+    uint32_t     cnt_seen;      // 上次写回寄存器的 CNT
+    bool         run;
+} HostTim_t;
+
+enum { T3, T14, T16, T17, T_COUNT };
+static HostTim_t tims[T_COUNT];
+static bool      stop = false;
+
+// TIM3 的预装载 (CCR2 / CCR3 在更新事件时生效)
+static uint32_t t3_ccr2 = 0;
+static uint32_t t3_ccr3 = 0;
+
+static uint64_t Tim_TickNs(const HostTim_t *t)
+{
+    return ((uint64_t)t->r->PSC + 1) * 1000u / 24u;     // 24MHz
+}
+
+static uint32_t Tim_Top(const HostTim_t *t)
+{
+    uint32_t arr = t->r->ARR & 0xFFFF;
+    return (t->cnt <= arr) ? arr : 0xFFFF;
+}
+
+static void Tach_Capture(void);
+static void T3_Wrap(void);
+
+static void Tim_Catch(HostTim_t *t)
+{
+    TIM_TypeDef *r = t->r;
+    uint32_t sr = r->SR;
+
+    if (sr != t->sr) t->sr &= sr;
+    if (r->CNT != t->cnt_seen) {
+        t->cnt = r->CNT & 0xFFFF;
+        t->t0 = host_now;
+    }
+
+    bool run = (r->CR1 & TIM_CR1_CEN) && !stop;
+    if (t->run) {
+        uint64_t tick = Tim_TickNs(t);
+        uint64_t n = (host_now - t->t0) / tick;
+        if (n) {
+            uint32_t top = Tim_Top(t);
+            uint64_t c = t->cnt + n;
+            t->t0 += n * tick;
+            // 事件保证不会跨过溢出点, 这里正好等于 top + 1
+            if (c > top) {
+                c = (c - top - 1) % ((uint64_t)(r->ARR & 0xFFFF) + 1);
+                t->cnt = (uint32_t)c;
+                t->sr |= TIM_SR_UIF;
+                if (t == &tims[T3]) T3_Wrap();
+            }
+            t->cnt = (uint32_t)c;
+        }
+    }
+    if (!run) t->t0 = host_now;
+    t->run = run;
+
+    r->SR = t->sr;
+    r->CNT = t->cnt;
+    t->cnt_seen = t->cnt;
+}
+
+static uint64_t Tim_At(const HostTim_t *t, uint32_t cnt)
+{
+    return t->t0 + (uint64_t)(cnt - t->cnt) * Tim_TickNs(t);
+}
+
+static uint64_t Tim_NextUpdate(const HostTim_t *t)
+{
+    if (!t->run) return HOST_NEVER;
+    return Tim_At(t, Tim_Top(t) + 1);
+}
+
+// CNT 从现在起第一次等于 ccr 的时刻 (这一圈里已经过了就算下一圈, 由溢出事件重新算)
+static uint64_t Tim_NextMatch(const HostTim_t *t, uint32_t ccr)
+{
+    if (!t->run || ccr <= t->cnt || ccr > Tim_Top(t)) return HOST_NEVER;
+    return Tim_At(t, ccr);
+}
+
+void Host_TimLoad(TIM_TypeDef *tim)
+{
+    for (int i = 0; i < T_COUNT; i++) {
+        if (tims[i].r != tim) continue;
+        Tim_Catch(&tims[i]);
+        tims[i].cnt = 0;
+        tims[i].t0 = host_now;
+        tim->CNT = 0;
+        tims[i].cnt_seen = 0;
+    }
+    if (tim == TIM3) {
+        t3_ccr2 = TIM3->CCR2;
+        t3_ccr3 = TIM3->CCR3;
+    }
+}
+
+// ============================================================
+//  4. EXTI / 输入引脚
+// ============================================================
+#define W1C_TAG         0x80000000u
+
+static uint32_t exti_pr = 0;
+static uint16_t gpio_in[2] = { 0xFFFF, 0xFFFF };   // 外部电平 (默认都有上拉)
+
+static void Exti_Edge(uint32_t line, uint32_t port, bool rising)
+{
+    uint32_t bit = 1u << line;
+
+    if (line < 12) {
+        uint32_t sel = (EXTI->EXTICR[line >> 2] >> (8 * (line & 3))) & 0xFF;
+        if (sel != port) return;
+    }
+    if (!((rising ? EXTI->RTSR : EXTI->FTSR) & bit)) return;
+    if (!(EXTI->IMR & bit)) return;
+    exti_pr |= bit;
+}
+
+static GPIO_TypeDef *const gpio_ports[2] = { GPIOA, GPIOB };
+
+void Host_GpioUpdate(GPIO_TypeDef *port)
+{
+    int i = (port == GPIOA) ? 0 : 1;
+    uint32_t moder = port->MODER;
+    uint32_t out = 0;
+
+    for (int pin = 0; pin < 16; pin++) {
+        if (((moder >> (pin * 2)) & 3u) == 1u) out |= 1u << pin;
+    }
+    uint32_t idr = (port->ODR & out) | (gpio_in[i] & ~out);
+    // TM1637 DIO 是线与: 芯片拉低时谁也拉不高
+    if (port == TM1637_DIO_PORT && !Tm_DioDrive()) idr &= ~(uint32_t)TM1637_DIO_PIN;
+    port->IDR = idr & 0xFFFF;
+}
+
+static void Input_Set(int port, uint32_t pin_no, bool level)
+{
+    uint16_t bit = (uint16_t)(1u << pin_no);
+    bool old = (gpio_in[port] & bit) != 0;
+
+    if (old == level) return;
+    if (level) gpio_in[port] |= bit;
+    else       gpio_in[port] &= (uint16_t)~bit;
+    Host_GpioUpdate(gpio_ports[port]);
+    Exti_Edge(pin_no, (uint32_t)port, level);
+}
+
+// ============================================================
+//  5. 功率输出: 烙铁 PWM (TIM3_CH2) / 风枪可控硅 (PB7) / 风扇 (TIM3_CH3)
+// ============================================================
+static bool gun_gate = false;       // 门极有电流 (PB7 低)
+static bool gun_cond = false;       // 可控硅导通 (门极撤掉后维持到过零)
+
+// 烙铁输出在 [a, a + dt) 里高电平的时间 (ns); 调用时 TIM3 已经追到 a
+static uint64_t Iron_OnNs(uint64_t a, uint64_t dt)
+{
+    const HostTim_t *t = &tims[T3];
+    uint32_t mode = (TIM3->CCMR1 >> TIM_CCMR1_OC2M_Pos) & 7u;
+
+    if (!(TIM3->CCER & TIM_CCER_CC2E)) return 0;
+    if (mode == 5) return dt;               // 强制有效
+    if (mode != 6) return 0;                // 强制无效 / 冻结 (按低处理)
+
+    uint64_t tick = Tim_TickNs(t);
+    uint64_t on_end = (uint64_t)t3_ccr2 * tick;
+    if (!t->run) return (t->cnt < t3_ccr2) ? dt : 0;
+    uint64_t pa = (uint64_t)t->cnt * tick + (a - t->t0);
+    uint64_t pb = pa + dt;
+    if (pa >= on_end) return 0;
+    return ((pb < on_end) ? pb : on_end) - pa;
+}
+
+static double Fan_Duty(void)
+{
+    uint32_t mode = (TIM3->CCMR2 >> TIM_CCMR2_OC3M_Pos) & 7u;
+    uint32_t period = (TIM3->ARR & 0xFFFF) + 1;
+
+    if (stop || !tims[T3].run || !(TIM3->CCER & TIM_CCER_CC3E)) return 0;
+    if (mode == 5) return 1;
+    if (mode != 6) return 0;
+    if (t3_ccr3 >= period) return 1;
+    return (double)t3_ccr3 / period;
+}
+
+// 正弦平方的积分: 导通半波的平均功率是 gun_w, 瞬时功率 2 * gun_w * sin²
+static double Gun_Joules(uint64_t a, uint64_t b)
+{
+    double half = 0.5 / host_plant.mains_hz;
+    uint64_t half_ns = (uint64_t)(half * 1e9);
+    uint64_t base = a - a % half_ns;
+    double xa = (double)(a - base) * 1e-9;
+    double xb = (double)(b - base) * 1e-9;
+    double k = M_PI / half;
+
+    double fa = xa - sin(2 * k * xa) / (2 * k);
+    double fb = xb - sin(2 * k * xb) / (2 * k);
+    return host_plant.gun_w * (fb - fa);
+}
+
+void Host_PinWrite(void *p, uint32_t pins, int level)
+{
+    GPIO_TypeDef *port = p;
+
+    if (level) port->ODR |= pins;
+    else       port->ODR &= ~pins;
+
+    if (port == TM1637_CLK_PORT && (pins & (TM1637_CLK_PIN | TM1637_DIO_PIN))) {
+        uint32_t moder = port->MODER;
+        int dio_out = ((moder >> (TM1637_DIO_PIN_POS * 2)) & 3u) == 1u;
+        int dio = dio_out ? ((port->ODR & TM1637_DIO_PIN) != 0) : 1;
+        Tm_Bus((port->ODR & TM1637_CLK_PIN) != 0, dio);
+    }
+    if (port == GUN_HEATER_PORT && (pins & GUN_HEATER_PIN)) {
+        gun_gate = !level;
+        if (gun_gate && host_plant.mains_present) gun_cond = true;
+    }
+    Host_GpioUpdate(port);
+}
+
+// ============================================================
+//  6. 热模型步进 / ADC / 比较器 / 测速
+// ============================================================
+static double   acc_dt = 0, acc_iron = 0, acc_gun = 0, acc_fan = 0;
+static uint16_t *adc_buf = NULL;
+static uint32_t adc_len = 0;
+static uint32_t adc_pos = 0;
+static uint64_t comp_since = HOST_NEVER;    // 比较器原始输出变高的时刻
+static bool     comp_out = false;
+static uint64_t tach_next = HOST_NEVER;
+
+static void Plant_Flush(void)
+{
+    if (acc_dt <= 0) return;
+    Plant_Step(acc_dt, acc_iron, acc_gun, acc_fan / acc_dt);
+    acc_dt = acc_iron = acc_gun = acc_fan = 0;
+
+    // 比较器 (COMP1: 烙铁运放输出 vs 0.82 VCC), 带数字滤波
+    if (COMP1->CSR & COMP_CSR_EN) {
+        bool raw = Plant_IronCode() > (uint16_t)(4096.0 * 47.0 / 57.0);
+        uint64_t filt = (uint64_t)(COMP1->FR >> COMP_FR_FLTCNT_Pos) * 1000u / 24u;
+        if (!(COMP1->FR & COMP_FR_FLTEN)) filt = 0;
+        if (!raw) {
+            comp_since = HOST_NEVER;
+            comp_out = false;
+        } else {
+            if (comp_since == HOST_NEVER) comp_since = host_now;
+            if (!comp_out && host_now - comp_since >= filt) {
+                comp_out = true;
+                if ((EXTI->RTSR & EXTI_RTSR_RT17) && (EXTI->IMR & EXTI_IMR_IM17)) exti_pr |= EXTI_PR_PR17;
+            }
+        }
+    }
+
+    // 风扇转起来了就排下一个测速沿
+    if (tach_next == HOST_NEVER && host_plant.fan_rpm > 60) {
+        tach_next = host_now + (uint64_t)(60e9 / (host_plant.fan_rpm * 2));
+    }
+}
+
+static void Account(uint64_t a, uint64_t b)
+{
+    uint64_t dt = b - a;
+    if (dt == 0) return;
+
+    uint64_t iron_ns = Iron_OnNs(a, dt);
+    double   gun_j = 0;
+
+    stats.iron_on_ns += iron_ns;
+    if (gun_cond && host_plant.mains_present) {
+        stats.gun_on_ns += dt;
+        stats.overlap_ns += iron_ns;
+        gun_j = Gun_Joules(a, b);
+    }
+    if (stop) stats.stop_ns += dt;
+
+    double s = (double)dt * 1e-9;
+    acc_dt += s;
+    acc_iron += host_plant.iron_heater_open ? 0 : host_plant.iron_w * (double)iron_ns * 1e-9;
+    acc_gun += gun_j;
+    acc_fan += Fan_Duty() * s;
+}
+
+static uint32_t adc_isr = 0;
+
+static void Adc_Convert(void)
+{
+    Plant_Flush();
+    if (!adc_buf || host_plant.adc_frozen) return;
+
+    uint16_t code[2] = { Plant_IronCode(), Plant_GunCode() };
+    uint32_t ht = (ADC1->TR >> ADC_TR_HT_Pos) & 0xFFF;
+
+    for (int i = 0; i < 2; i++) {
+        adc_buf[adc_pos] = code[i];
+        adc_pos = (adc_pos + 1) % adc_len;
+        if ((ADC1->CFGR1 & ADC_CFGR1_AWDEN) && code[i] > ht) adc_isr |= ADC_ISR_AWD;
+    }
+    adc_isr |= ADC_ISR_EOC | ADC_ISR_EOSEQ;
+}
+
+void Host_AdcStart(uint16_t *buf, uint32_t len)
+{
+    adc_buf = buf;
+    adc_len = len;
+    adc_pos = 0;
+}
+
+static void Tach_Capture(void)
+{
+    HostTim_t *t = &tims[T17];
+
+    if (!(TIM17->CCER & TIM_CCER_CC1E) || !t->run) return;
+    if (t->sr & TIM_SR_CC1IF) t->sr |= TIM_SR_CC1OF;
+    t->sr |= TIM_SR_CC1IF;
+    TIM17->CCR1 = t->cnt;
+    TIM17->SR = t->sr;
+}
+
+// TIM3 每圈开头: 预装载生效, CCR1 = 0 的比较, 风扇 PWM 开通沿上的假测速沿
+static void T3_Wrap(void)
+{
+    uint32_t period = (TIM3->ARR & 0xFFFF) + 1;
+
+    t3_ccr2 = TIM3->CCR2;
+    t3_ccr3 = TIM3->CCR3;
+    if (TIM3->CCR1 == 0 && (TIM3->DIER & TIM_DIER_CC1IE)) tims[T3].sr |= TIM_SR_CC1IF;
+    if (host_plant.fan_pwm_glitch && t3_ccr3 > 0 && t3_ccr3 < period &&
+        (TIM3->CCER & TIM_CCER_CC3E)) {
+        Tim_Catch(&tims[T17]);
+        Tach_Capture();
+    }
+}
+
+// ============================================================
+//  7. 市电 / 过零检测
+// ============================================================
+#define ZC_LEAD_NS      (400 * HOST_NS_PER_US)
+
+static uint64_t Half_Ns(void)
+{
+    return (uint64_t)(0.5e9 / host_plant.mains_hz);
+}
+
+static uint64_t Next_Multiple(uint64_t t, uint64_t step, uint64_t offset)
+{
+    // 大于 t 的第一个 k * step - offset
+    uint64_t k = (t + offset) / step + 1;
+    return k * step - offset;
+}
+
+// ============================================================
+//  8. DMA / 串口
+// ============================================================
+static uint32_t dma_isr = 0;
+static uint32_t usart_sr = 0;
+static uint64_t byte_ns = 10 * HOST_NS_PER_S / 115200;
+
+static uint8_t  tx_data[1024];
+static uint32_t tx_len = 0;
+static uint64_t tx_end = HOST_NEVER;
+
+static uint8_t  rx_queue[4096];
+static uint32_t rx_head = 0, rx_tail = 0;
+static uint64_t rx_next = HOST_NEVER;
+static uint64_t idle_at = HOST_NEVER;
+static uint32_t rx_dma_len = 0;         // 接收 DMA 的总长 (循环模式重装用)
+
+void Host_UartSetBaud(uint32_t baud)
+{
+    byte_ns = 10 * HOST_NS_PER_S / baud;
+}
+
+void Host_UartRxDmaStart(uint32_t len)
+{
+    rx_dma_len = len;
+}
+
+void Host_UartTxStart(const uint8_t *data, uint32_t len)
+{
+    if (len > sizeof(tx_data)) len = sizeof(tx_data);
+    memcpy(tx_data, data, len);
+    tx_len = len;
+    tx_end = host_now + len * byte_ns;
+}
+
+// --- 遥测解码 (COBS + CRC16) ---
+static void (*text_hook)(uint32_t, const char *) = NULL;
+static void (*frame_hook)(uint32_t, uint8_t, const uint8_t *, uint8_t) = NULL;
+static void (*tx_hook)(const uint8_t *, size_t) = NULL;
+static bool quiet = false;
+static uint8_t  dec_buf[300];
+static uint32_t dec_len = 0;
+static char     line_buf[512];
+static uint32_t line_len = 0;
+
+static void Text_Line(void)
+{
+    line_buf[line_len] = 0;
+    if (text_hook) text_hook(Host_NowMs(), line_buf);
+    if (!quiet) printf("[%10.3f] %s\n", (double)host_now * 1e-9, line_buf);
+    line_len = 0;
+}
+
+static void Decode_Frame(void)
+{
+    uint8_t raw[300];
+    uint32_t n = 0, i = 0;
+
+    while (i < dec_len) {
+        uint8_t code = dec_buf[i++];
+        if (code == 0) return;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= dec_len) return;
+            raw[n++] = dec_buf[i++];
+        }
+        if (code < 0xFF && i < dec_len) raw[n++] = 0;
+    }
+    if (n < 3) return;
+    uint16_t crc = (uint16_t)(raw[n - 2] | (raw[n - 1] << 8));
+    if (CRC16(raw, n - 2) != crc) return;
+
+    uint8_t type = raw[0];
+    uint8_t len = (uint8_t)(n - 3);
+    if (type == 0x02) {
+        for (uint8_t k = 0; k < len; k++) {
+            char c = (char)raw[1 + k];
+            if (c == '\r') continue;
+            if (c == '\n' || line_len >= sizeof(line_buf) - 1) Text_Line();
+            if (c != '\n') line_buf[line_len++] = c;
+        }
+    } else if (frame_hook) {
+        frame_hook(Host_NowMs(), type, &raw[1], len);
+    }
+}
+
+static void Tx_Done(void)
+{
+    if (tx_hook) tx_hook(tx_data, tx_len);
+    for (uint32_t i = 0; i < tx_len; i++) {
+        uint8_t b = tx_data[i];
+        if (b == 0) {
+            Decode_Frame();
+            dec_len = 0;
+        } else if (dec_len < sizeof(dec_buf)) {
+            dec_buf[dec_len++] = b;
+        }
+    }
+    tx_len = 0;
+    tx_end = HOST_NEVER;
+    dma_isr |= DMA_ISR_GIF2 | DMA_ISR_TCIF2;
+}
+
+static void Rx_Byte(void)
+{
+    uint8_t b = rx_queue[rx_tail];
+    rx_tail = (rx_tail + 1) % sizeof(rx_queue);
+
+    DMA_Channel_TypeDef *ch = DMA1_Channel3;
+    if ((ch->CCR & DMA_CCR_EN) && (USART1->CR3 & USART_CR3_DMAR) && ch->CNDTR) {
+        uint8_t *mem = (uint8_t *)(uintptr_t)ch->CMAR;
+        mem[rx_dma_len - ch->CNDTR] = b;
+        ch->CNDTR--;
+        if (ch->CNDTR == 0 && (ch->CCR & DMA_CCR_CIRC)) ch->CNDTR = rx_dma_len;
+    }
+
+    if (rx_head != rx_tail) {
+        rx_next = host_now + byte_ns;
+    } else {
+        rx_next = HOST_NEVER;
+        idle_at = host_now + byte_ns;
+    }
+}
+
+void Host_UartRx(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint32_t next = (rx_head + 1) % sizeof(rx_queue);
+        if (next == rx_tail) break;
+        rx_queue[rx_head] = data[i];
+        rx_head = next;
+    }
+    if (rx_next == HOST_NEVER && rx_head != rx_tail) {
+        rx_next = host_now + byte_ns;
+        idle_at = HOST_NEVER;
+    }
+}
+
+void Host_SendCommand(uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    uint8_t raw[260];
+    uint8_t enc[264];
+    uint32_t n = 0;
+
+    raw[n++] = cmd;
+    if (len) memcpy(&raw[n], payload, len);
+    n += len;
+    uint16_t crc = CRC16(raw, n);
+    raw[n++] = (uint8_t)crc;
+    raw[n++] = (uint8_t)(crc >> 8);
+
+    // COBS
+    uint32_t code_pos = 0, out = 1;
+    uint8_t code = 1;
+    for (uint32_t i = 0; i < n; i++) {
+        if (raw[i] == 0) {
+            enc[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            enc[out++] = raw[i];
+            code++;
+        }
+    }
+    enc[code_pos] = code;
+    enc[out++] = 0;
+    Host_UartRx(enc, out);
+}
+
+// ============================================================
+//  9. LPTIM (LSI 256Hz, STOP 里照跑) / IWDG
+// ============================================================
+#define LP_TICK_NS      (HOST_NS_PER_S / 256)
+
+static uint32_t lp_isr = 0;
+static bool     lp_run = false;
+static uint64_t lp_t0 = 0;
+
+static uint64_t iwdg_timeout = 0;
+static uint64_t iwdg_last = 0;
+static void   (*wdg_hook)(uint32_t) = NULL;
+
+void Host_IwdgStart(uint32_t timeout_ms)
+{
+    iwdg_timeout = (uint64_t)timeout_ms * HOST_NS_PER_MS;
+    iwdg_last = host_now;
+}
+
+void Host_IwdgRefresh(void)
+{
+    iwdg_last = host_now;
+    stats.wdg_refresh++;
+}
+
+void Host_SetWatchdogHook(void (*fn)(uint32_t now_ms))
+{
+    wdg_hook = fn;
+}
+
+// ============================================================
+//  10. 同步: 寄存器语义 + 计数器
+// ============================================================
+void Host_Sync(void)
+{
+    for (int i = 0; i < T_COUNT; i++) Tim_Catch(&tims[i]);
+
+    // EXTI PR / ADC ISR: 写 1 清零
+    uint32_t v = EXTI->PR;
+    if (!(v & W1C_TAG)) exti_pr &= ~v;
+    EXTI->PR = exti_pr | W1C_TAG;
+
+    v = ADC1->ISR;
+    if (!(v & W1C_TAG)) adc_isr &= ~v;
+    ADC1->ISR = adc_isr | W1C_TAG;
+
+    // DMA
+    if (DMA1->IFCR) {
+        dma_isr &= ~DMA1->IFCR;
+        DMA1->IFCR = 0;
+    }
+    DMA1->ISR = dma_isr;
+
+    // 串口状态
+    USART1->SR = usart_sr | USART_SR_TXE | (tx_end == HOST_NEVER ? USART_SR_TC : 0);
+
+    // LPTIM
+    if (LPTIM1->ICR) {
+        lp_isr &= ~LPTIM1->ICR;
+        LPTIM1->ICR = 0;
+    }
+    if (!(LPTIM1->CR & LPTIM_CR_ENABLE)) lp_run = false;
+    if (LPTIM1->CR & LPTIM_CR_SNGSTRT) {
+        LPTIM1->CR &= ~LPTIM_CR_SNGSTRT;
+        if (LPTIM1->CR & LPTIM_CR_ENABLE) {
+            lp_run = true;
+            lp_t0 = host_now;
+        }
+    }
+    if (lp_run) LPTIM1->CNT = (uint32_t)((host_now - lp_t0) / LP_TICK_NS);
+    LPTIM1->ISR = lp_isr;
+
+    // 比较器输出
+    if (comp_out) COMP1->CSR |= COMP_CSR_COMP_OUT;
+    else          COMP1->CSR &= ~COMP_CSR_COMP_OUT;
+}
+
+// ============================================================
+//  11. 中断
+// ============================================================
+static uint32_t Irq_Lines(void)
+{
+    uint32_t l = 0;
+    const HostTim_t *t;
+
+    t = &tims[T14];
+    if (t->sr & TIM14->DIER & TIM_DIER_UIE) l |= 1u << TIM14_IRQn;
+    t = &tims[T16];
+    if (t->sr & TIM16->DIER & TIM_DIER_UIE) l |= 1u << TIM16_IRQn;
+    t = &tims[T17];
+    if (t->sr & TIM17->DIER & (TIM_DIER_UIE | TIM_DIER_CC1IE)) l |= 1u << TIM17_IRQn;
+    t = &tims[T3];
+    if (t->sr & TIM3->DIER & (TIM_DIER_UIE | TIM_DIER_CC1IE)) l |= 1u << TIM3_IRQn;
+
+    uint32_t pr = exti_pr & EXTI->IMR;
+    if (pr & 0x0003u) l |= 1u << EXTI0_1_IRQn;
+    if (pr & 0x000Cu) l |= 1u << EXTI2_3_IRQn;
+    if (pr & 0xFFF0u) l |= 1u << EXTI4_15_IRQn;
+    if ((pr & EXTI_PR_PR17) || (adc_isr & ADC1->IER & (ADC_IER_AWDIE | ADC_IER_OVRIE)))
+        l |= 1u << ADC_COMP_IRQn;
+
+    if (((dma_isr & DMA_ISR_TCIF2) && (DMA1_Channel2->CCR & DMA_CCR_TCIE)) ||
+        ((dma_isr & DMA_ISR_TCIF3) && (DMA1_Channel3->CCR & DMA_CCR_TCIE)))
+        l |= 1u << DMA1_Channel2_3_IRQn;
+
+    if ((usart_sr & USART_SR_IDLE) && (USART1->CR1 & USART_CR1_IDLEIE)) l |= 1u << USART1_IRQn;
+    if (lp_isr & LPTIM1->IER & LPTIM_IER_ARRMIE) l |= 1u << LPTIM1_IRQn;
+    return l;
+}
+
+static bool Wake_Pending(void)
+{
+    return systick_pending || (Irq_Lines() & nvic_enabled) != 0;
+}
+
+void Host_Service(void)
+{
+    static uint64_t storm_at = HOST_NEVER;
+    static uint32_t storm = 0;
+
+    for (;;) {
+        Host_Sync();
+        if (primask) return;
+
+        uint32_t lines = Irq_Lines() & nvic_enabled;
+        int      best = -1;
+        uint32_t bp = active_prio;
+
+        if (systick_pending && nvic_prio[SLOT_SYSTICK] < bp) {
+            best = SLOT_SYSTICK;
+            bp = nvic_prio[SLOT_SYSTICK];
+        }
+        for (int i = 0; i < 32; i++) {
+            if ((lines & (1u << i)) && nvic_prio[i] < bp) {
+                best = i;
+                bp = nvic_prio[i];
+            }
+        }
+        if (best < 0) return;
+
+        // 标志不清的中断会在同一时刻反复进: 多半是模型或固件的错, 直接停下
+        if (storm_at == host_now) {
+            if (++storm > 100000) {
+                fprintf(stderr, "host: interrupt storm on IRQ %d at %.6f s\n", best, (double)host_now * 1e-9);
+                Host_Exit(4);
+            }
+        } else {
+            storm_at = host_now;
+            storm = 0;
+        }
+
+        uint32_t saved = active_prio;
+        active_prio = bp;
+        stats.isr_calls++;
+        if (best == SLOT_SYSTICK) {
+            systick_pending = false;
+            SysTick_Handler();
+        } else if (vectors[best]) {
+            vectors[best]();
+            Host_Sync();
+            // 读 CCR1 清 CC1IF; 读 SR 再读 DR 清 IDLE
+            if (best == TIM17_IRQn) tims[T17].sr &= ~TIM_SR_CC1IF;
+            if (best == USART1_IRQn) usart_sr &= ~USART_SR_IDLE;
+        } else {
+            nvic_enabled &= ~(1u << best);
+        }
+        active_prio = saved;
+    }
+}
+
+void Host_DisableIrq(void)
+{
+    primask = 1;
+}
+
+void Host_EnableIrq(void)
+{
+    primask = 0;
+    Host_Service();
+}
+
+uint32_t Host_GetPrimask(void)
+{
+    return primask;
+}
+
+void Host_SetPrimask(uint32_t pm)
+{
+    primask = pm & 1u;
+    if (!primask) Host_Service();
+}
+
+// ============================================================
+//  12. 事件
+// ============================================================
+enum {
+    EV_HOOK, EV_SYSTICK,
+    EV_T3, EV_T14, EV_T16, EV_T17, EV_T3_CC1, EV_T3_ADC,
+    EV_MAINS, EV_ZC, EV_TACH, EV_TX, EV_RX, EV_IDLE, EV_LPTIM, EV_IWDG,
+    EV_END,                 // 同一时刻的其他事件先处理完
+};
+
+static HostTickFn hook = NULL;
+static uint64_t   hook_period = 0;
+static uint64_t   hook_next = HOST_NEVER;
+
+// 同一时刻到点的事件一起处理 (TIM3 溢出和市电过零之类经常重合, 只处理一个的话
+// 另一个在计数器追上之后就再也算不出来了)
+static void Pick(uint64_t t, int src, uint64_t *best, uint32_t *mask)
+{
+    if (t < *best) {
+        *best = t;
+        *mask = 1u << src;
+    } else if (t == *best && t != HOST_NEVER) {
+        *mask |= 1u << src;
+    }
+}
+
+static uint64_t Next_Event(uint32_t *src)
+{
+    uint64_t t = HOST_NEVER;
+    *src = 0;
+
+    Pick(end_ns, EV_END, &t, src);
+    Pick(hook_next, EV_HOOK, &t, src);
+    if (iwdg_timeout) Pick(iwdg_last + iwdg_timeout, EV_IWDG, &t, src);
+    if (lp_run) Pick(lp_t0 + (uint64_t)(LPTIM1->ARR & 0xFFFF) * LP_TICK_NS, EV_LPTIM, &t, src);
+    if (stop) return t;
+
+    Pick(systick_next, EV_SYSTICK, &t, src);
+    Pick(Tim_NextUpdate(&tims[T3]), EV_T3, &t, src);
+    Pick(Tim_NextUpdate(&tims[T14]), EV_T14, &t, src);
+    Pick(Tim_NextUpdate(&tims[T16]), EV_T16, &t, src);
+    Pick(Tim_NextUpdate(&tims[T17]), EV_T17, &t, src);
+    if (TIM3->DIER & TIM_DIER_CC1IE) Pick(Tim_NextMatch(&tims[T3], TIM3->CCR1 & 0xFFFF), EV_T3_CC1, &t, src);
+    if (adc_buf) Pick(Tim_NextMatch(&tims[T3], TIM3->CCR4 & 0xFFFF), EV_T3_ADC, &t, src);
+    if (host_plant.mains_present) {
+        uint64_t half = Half_Ns();
+        Pick(Next_Multiple(host_now, half, 0), EV_MAINS, &t, src);
+        Pick(Next_Multiple(host_now, half, ZC_LEAD_NS), EV_ZC, &t, src);
+    }
+    Pick(tach_next, EV_TACH, &t, src);
+    Pick(tx_end, EV_TX, &t, src);
+    Pick(rx_next, EV_RX, &t, src);
+    Pick(idle_at, EV_IDLE, &t, src);
+    return t;
+}
+
+static void Event(int src)
+{
+    switch (src) {
+    case EV_END:
+        Host_Exit(0);
+        break;
+    case EV_HOOK:
+        hook_next += hook_period;
+        Plant_Flush();
+        hook(Host_NowMs());
+        break;
+    case EV_SYSTICK:
+        systick_next += HOST_NS_PER_MS;
+        if (systick_on && !systick_suspended) systick_pending = true;
+        break;
+    case EV_T3_CC1:
+        tims[T3].sr |= TIM_SR_CC1IF;
+        break;
+    case EV_T3_ADC:
+        Adc_Convert();
+        break;
+    case EV_MAINS:
+        // 真正的过零: 门极没电流就关断
+        if (!gun_gate) gun_cond = false;
+        break;
+    case EV_ZC:
+        // 光耦下降沿 (比过零早 ZC_LEAD_NS)
+        Exti_Edge(1, 0, false);
+        break;
+    case EV_TACH:
+        if (host_plant.fan_rpm > 60) {
+            tach_next = host_now + (uint64_t)(60e9 / (host_plant.fan_rpm * 2));
+            Tach_Capture();
+        } else {
+            tach_next = HOST_NEVER;
+        }
+        break;
+    case EV_TX:
+        Tx_Done();
+        break;
+    case EV_RX:
+        if (stop) {
+            // STOP 里串口没时钟: 起始位的下降沿只能当 EXTI 唤醒, 字节本身丢了
+            rx_tail = (rx_tail + 1) % sizeof(rx_queue);
+            rx_next = (rx_head != rx_tail) ? host_now + byte_ns : HOST_NEVER;
+            Input_Set(0, 10, false);
+            Input_Set(0, 10, true);
+        } else {
+            Rx_Byte();
+        }
+        break;
+    case EV_IDLE:
+        idle_at = HOST_NEVER;
+        usart_sr |= USART_SR_IDLE;
+        break;
+    case EV_LPTIM:
+        lp_run = false;
+        lp_isr |= LPTIM_ISR_ARRM;
+        break;
+    case EV_IWDG:
+        stats.wdg_resets++;
+        iwdg_last = host_now;
+        if (wdg_hook) {
+            wdg_hook(Host_NowMs());
+        } else {
+            fprintf(stderr, "host: IWDG timeout at %.3f s\n", (double)host_now * 1e-9);
+            Host_Exit(3);
+        }
+        break;
+    default:
+        break;      // 定时器溢出在 Host_Sync 里处理
+    }
+}
+
+void Host_Advance(uint64_t until)
+{
+    uint32_t mask;
+
+    Host_Sync();    // 先收下固件刚写的寄存器 (它们是在当前时刻写的)
+    uint64_t t = Next_Event(&mask);
+
+    if (t > until) {
+        t = until;
+        mask = 0;
+    }
+    if (t < host_now) t = host_now;
+
+    Account(host_now, t);
+    host_now = t;
+    if (acc_dt >= 1e-3) Plant_Flush();
+    Host_Sync();
+    stats.events++;
+
+    for (int src = 0; mask; src++) {
+        if (!(mask & (1u << src))) continue;
+        mask &= ~(1u << src);
+        Event(src);
+    }
+    Host_Sync();
+}
+
+// RX 字节在 STOP 里也要按时到 (唤醒), 所以 rx_next 不平移
+static void Stop_Shift(uint64_t d)
+{
+    if (tx_end != HOST_NEVER) tx_end += d;
+    if (idle_at != HOST_NEVER) idle_at += d;
+    if (tach_next != HOST_NEVER) tach_next += d;
+}
+
+void Host_EnterStop(void)
+{
+    Host_Sync();
+    if (Wake_Pending()) return;
+
+    uint64_t t_in = host_now;
+    stop = true;
+    gun_cond = false;           // 固件睡前已经断了门极, 这半波之后不会再导通
+    Host_Sync();
+    while (!Wake_Pending()) Host_Advance(HOST_NEVER);
+    stop = false;
+    Stop_Shift(host_now - t_in);
+    if (!systick_suspended && systick_on) systick_next = host_now + HOST_NS_PER_MS;
+    Host_Sync();
+}
+
+bool Host_InStop(void)
+{
+    return stop;
+}
+
+void Host_Wfi(void)
+{
+    Host_Sync();
+    while (!Wake_Pending()) Host_Advance(HOST_NEVER);
+    Host_Service();
+}
+
+// ============================================================
+//  13. 对外接口
+// ============================================================
+void Host_Init(void)
+{
+    Map(FLASH_BASE, 0x10000, 0xFF);
+    Map(0x1FFF0000u, 0x1000, 0x00);
+    Map(PERIPH_BASE, 0x24000, 0x00);
+    Map(IOPORT_BASE, 0x2000, 0x00);
+    Map(0xE000E000u, 0x1000, 0x00);
+
+    // 复位值
+    GPIOA->MODER = 0xEBFFFFFFu;
+    GPIOB->MODER = 0xFFFFFFFFu;
+    TIM1->ARR = TIM3->ARR = TIM14->ARR = TIM16->ARR = TIM17->ARR = 0xFFFF;
+    tims[T3].r = TIM3;
+    tims[T14].r = TIM14;
+    tims[T16].r = TIM16;
+    tims[T17].r = TIM17;
+
+    // 开关都断开 (上拉为高), 风枪在架子上 (磁控吸合为低)
+    gpio_in[1] &= (uint16_t)~GUN_REED_PIN;
+    Host_GpioUpdate(GPIOA);
+    Host_GpioUpdate(GPIOB);
+
+    Plant_Reset();
+    Host_Sync();
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+}
+
+int Host_Fork(void)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) freopen("/dev/null", "w", stderr);
+    return (int)pid;
+}
+
+int Host_RunFirmware(void (*setup)(void), int *res_fd, void *out, size_t n)
+{
+    int fds[2];
+
+    if (pipe(fds) != 0) return -1;
+    pid_t pid = Host_Fork();
+    if (pid == 0) {
+        close(fds[0]);
+        *res_fd = fds[1];
+        Host_Init();
+        Host_SetQuiet(true);
+        setup();
+        app_main();
+        _exit(1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return -1;
+    }
+    ssize_t got = read(fds[0], out, n);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return (got == (ssize_t)n) ? 0 : -1;
+}
+
+uint64_t Host_NowNs(void)
+{
+    return host_now;
+}
+
+uint32_t Host_NowMs(void)
+{
+    return (uint32_t)(host_now / HOST_NS_PER_MS);
+}
+
+void Host_SetEnd(uint64_t ns)
+{
+    end_ns = ns;
+}
+
+void Host_Exit(int code)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double wall = (double)(now.tv_sec - wall_start.tv_sec) + (double)(now.tv_nsec - wall_start.tv_nsec) * 1e-9;
+    double sim = (double)host_now * 1e-9;
+
+    if (line_len) Text_Line();
+    fflush(stdout);
+    fprintf(stderr, "host: %.1f s simulated in %.2f s (%.0fx, %.1f sim-h per minute), %.1f%% in STOP, %u events, %u ISRs\n",
+            sim, wall, wall > 0 ? sim / wall : 0, wall > 0 ? sim / wall / 60 : 0,
+            sim > 0 ? 100.0 * (double)stats.stop_ns * 1e-9 / sim : 0, stats.events, stats.isr_calls);
+    Host_FlashSave();
+    exit(code);
+}
+
+void Host_SetTickHook(HostTickFn fn, uint32_t period_ms)
+{
+    hook = fn;
+    hook_period = (uint64_t)period_ms * HOST_NS_PER_MS;
+    hook_next = fn ? host_now + hook_period : HOST_NEVER;
+}
+
+void Host_SetTextHook(void (*fn)(uint32_t now_ms, const char *line))
+{
+    text_hook = fn;
+}
+
+void Host_SetFrameHook(void (*fn)(uint32_t now_ms, uint8_t type, const uint8_t *payload, uint8_t len))
+{
+    frame_hook = fn;
+}
+
+void Host_SetTxHook(void (*fn)(const uint8_t *data, size_t len))
+{
+    tx_hook = fn;
+}
+
+void Host_SetQuiet(bool q)
+{
+    quiet = q;
+}
+
+void Host_SetIronSwitch(bool on)
+{
+    Input_Set(0, 5, !on);
+}
+
+void Host_SetGunSwitch(bool on)
+{
+    Input_Set(1, 6, !on);
+}
+
+void Host_SetHandleUp(bool up)
+{
+    Input_Set(1, 4, up);
+}
+
+void Host_SetKey(uint8_t raw)
+{
+    Tm_SetKey(raw);
+}
+
+// 每格一个完整的正交周期 (4 个沿): 顺时针 A 先于 B
+void Host_EncoderTurn(int detents)
+{
+    int dir = detents > 0 ? 1 : -1;
+    int n = detents * dir;
+
+    for (int i = 0; i < n; i++) {
+        if (dir > 0) {
+            Input_Set(0, 8, false); Input_Set(1, 3, false);
+            Input_Set(0, 8, true);  Input_Set(1, 3, true);
+        } else {
+            Input_Set(1, 3, false); Input_Set(0, 8, false);
+            Input_Set(1, 3, true);  Input_Set(0, 8, true);
+        }
+        if ((TIM1->CR1 & TIM_CR1_CEN) && !stop) TIM1->CNT = (TIM1->CNT + (uint32_t)(4 * dir)) & 0xFFFF;
+    }
+}
+
+int Host_DisplayIron(void)
+{
+    return Tm_DisplayIron();
+}
+
+int Host_DisplayGun(void)
+{
+    return Tm_DisplayGun();
+}
+
+uint32_t Host_DisplayFrames(void)
+{
+    return Tm_Frames();
+}
+
+uint32_t Host_KeyReads(void)
+{
+    return Tm_KeyReads();
+}
+
+const HostStats_t *Host_GetStats(void)
+{
+    return &stats;
+}
+
+void Host_CountFlash(bool erase)
+{
+    if (erase) stats.flash_erases++;
+    else       stats.flash_programs++;
+}
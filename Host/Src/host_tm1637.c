@@ -0,0 +1,155 @@
+#include "host_priv.h"
+
+// ============================================================
+//  TM1637 芯片模型 (挂在 CLK / DIO 两根线上, 由 Host_PinWrite 驱动)
+// ============================================================
+// 协议同手册: CLK 高时 DIO 下降 = START, 上升 = STOP; 数据低位在前, CLK 上升沿采样;
+// 第 8 个时钟的下降沿芯片拉低 DIO 应答, 第 9 个时钟的下降沿放开。
+// 读键 (0x42): 应答结束的那个下降沿开始, 每个下降沿送出一位键码 (低位在前)。
+
+// 与 tm1637.c 的 SegmentMap 相同
+static const uint8_t seg_digits[10] = { 0x5F, 0x44, 0x9D, 0xD5, 0xC6, 0xD3, 0xDB, 0x45, 0xDF, 0xD7 };
+
+static int      line_clk = 1, line_dio = 1;     // 上一次看到的线电平
+static int      drive = 1;                      // 芯片对 DIO 的驱动
+static bool     in_txn = false;
+static uint8_t  shift = 0;
+static uint8_t  nbit = 0;                       // 本字节已采样的位数 (8 = 等应答)
+static bool     ack = false;                    // 正在应答 (第 9 个时钟)
+static uint8_t  nbyte = 0;                      // 本次传输里的第几个字节
+static uint8_t  cmd = 0;
+static uint8_t  addr = 0;
+static bool     reading = false;
+static uint8_t  rd_bit = 0;
+static bool     mcu_ack = false;                // 读键的第 9 个时钟 (不是芯片收到的字节)
+
+static uint8_t  ram[6];
+static uint8_t  ram_shadow[6];                  // 本帧正在写的显存
+static bool     display_on = false;
+static uint32_t frames = 0;
+static uint32_t key_reads = 0;
+static uint8_t  key = 0xFF;
+
+static void Byte_Done(uint8_t b)
+{
+    if (nbyte++ == 0) {
+        cmd = b;
+        if ((b & 0xC0) == 0xC0) addr = b & 0x07;
+        if ((b & 0xF0) == 0x80) display_on = (b & 0x08) != 0;
+        if (b == 0x42) {
+            reading = true;
+            rd_bit = 0;
+            key_reads++;
+        }
+        return;
+    }
+    if ((cmd & 0xC0) == 0xC0 && addr < 6) ram_shadow[addr++] = b;
+}
+
+void Tm_Bus(int clk, int dio)
+{
+    int line = dio & drive;
+
+    if (clk && line_clk) {
+        // CLK 保持高: DIO 变化是 START / STOP
+        if (line_dio && !line) {
+            in_txn = true;
+            nbyte = 0;
+            nbit = 0;
+            shift = 0;
+            ack = false;
+            mcu_ack = false;
+            reading = false;
+        } else if (!line_dio && line && in_txn) {
+            in_txn = false;
+            if ((cmd & 0xC0) == 0xC0 && nbyte > 1) {
+                for (int i = 0; i < 6; i++) ram[i] = ram_shadow[i];
+                frames++;
+            }
+        }
+    } else if (clk && !line_clk && in_txn) {
+        // 上升沿: 采样
+        if (!ack && !reading && nbit < 8) {
+            if (line) shift |= (uint8_t)(1u << nbit);
+            nbit++;
+        }
+    } else if (!clk && line_clk && in_txn) {
+        // 下降沿
+        if (reading) {
+            if (rd_bit < 8) {
+                drive = (key >> rd_bit) & 1;
+                rd_bit++;
+            } else {
+                // 8 位送完: 放开 DIO, 第 9 个时钟由 MCU 应答
+                drive = 1;
+                reading = false;
+                ack = true;
+                mcu_ack = true;
+            }
+        } else if (ack) {
+            uint8_t b = shift;
+            ack = false;
+            drive = 1;
+            nbit = 0;
+            shift = 0;
+            if (!mcu_ack) Byte_Done(b);
+            mcu_ack = false;
+            if (reading) {
+                drive = key & 1;
+                rd_bit = 1;
+            }
+        } else if (nbit == 8) {
+            ack = true;
+            drive = 0;
+        }
+    }
+
+    line_clk = clk;
+    line_dio = dio & drive;
+}
+
+int Tm_DioDrive(void)
+{
+    return drive;
+}
+
+void Tm_SetKey(uint8_t raw)
+{
+    key = raw;
+}
+
+// 三位数码管 -> 数值; -1 = 全灭, -2 = 认不出的段码
+static int Decode(uint8_t d100, uint8_t d10, uint8_t d1)
+{
+    const uint8_t d[3] = { d100, d10, d1 };
+    int v = 0;
+
+    if (!display_on || (d100 == 0 && d10 == 0 && d1 == 0)) return -1;
+    for (int i = 0; i < 3; i++) {
+        int k = 0;
+        while (k < 10 && seg_digits[k] != d[i]) k++;
+        if (k == 10) return -2;
+        v = v * 10 + k;
+    }
+    return v;
+}
+
+int Tm_DisplayIron(void)
+{
+    return Decode(ram[5], ram[3], ram[4]);
+}
+
+int Tm_DisplayGun(void)
+{
+    return Decode(ram[2], ram[1], ram[0]);
+}
+
+uint32_t Tm_Frames(void)
+{
+    return frames;
+}
+
+uint32_t Tm_KeyReads(void)
+{
+    return key_reads;
+}
@@ -0,0 +1,146 @@
+#include "host.h"
+#include "autotune.h"
+#include <math.h>
+#include <stdio.h>
+
+// ============================================================
+//  继电自整定 vs 一阶加纯滞后对象 (user-009)
+// ============================================================
+// 对象: G(s) = K e^(-Ls) / (tau s + 1), 输入 PWM 计数 (0~900), 输出 0.1°C (从室温算起),
+// 10ms 一步, 与烙铁控制任务相同。对每个对象:
+//   1. 跑 AutoTune_Run 直到 AT_DONE, 把测出的 Ku / Tu 和解析的临界点比较
+//      (继电法基于描述函数, 有几十 % 以内的偏差是正常的, 这里只卡住明显错误)
+//   2. 用 Tyreus–Luyben 参数接 PIDQ_Compute 从室温升到设定点, 必须稳定下来
+
+#define DT_MS           10
+#define AMBIENT         250     // 0.1°C
+#define SETPOINT        3000
+#define OUT_MAX         900
+#define HYST            20
+#define MAX_DELAY       1000    // 纯滞后最多 10s
+#define KU_TOL          0.35
+#define TU_TOL          0.20
+#define SETTLE_BAND     20      // 2°C
+#define RUN_MS          600000
+
+typedef struct {
+    double K;               // 0.1°C / 计数
+    double tau;             // s
+    double L;               // s
+} Fopdt_t;
+
+static const Fopdt_t plants[] = {
+    { 5.0, 20.0, 2.0 },     // 烙铁量级
+    { 5.0, 60.0, 5.0 },     // 慢一些的头
+};
+
+typedef struct {
+    const Fopdt_t *p;
+    double  y;                  // 一阶部分输出
+    int32_t buf[MAX_DELAY];     // 输入延迟线
+    int     head;
+    int     delay;
+} Plant_t;
+
+static void Plant_Init(Plant_t *s, const Fopdt_t *p)
+{
+    s->p = p;
+    s->y = 0;
+    s->head = 0;
+    s->delay = (int)lround(p->L * 1000 / DT_MS);
+    for (int i = 0; i < MAX_DELAY; i++) s->buf[i] = 0;
+}
+
+static int32_t Plant_Read(const Plant_t *s)
+{
+    return AMBIENT + (int32_t)lround(s->y);
+}
+
+static void Fopdt_Step(Plant_t *s, int32_t u)
+{
+    s->buf[s->head] = u;
+    int32_t ud = s->buf[(s->head - s->delay + MAX_DELAY) % MAX_DELAY];
+    s->head = (s->head + 1) % MAX_DELAY;
+    double a = exp(-DT_MS / 1000.0 / s->p->tau);
+    s->y = a * s->y + (1 - a) * s->p->K * ud;
+}
+
+// 临界点: 相位 -π 处 ωL + atan(ωτ) = π
+static void Ultimate(const Fopdt_t *p, double *ku, double *tu)
+{
+    double lo = 1e-6, hi = M_PI / p->L;
+    for (int i = 0; i < 100; i++) {
+        double w = (lo + hi) / 2;
+        if (w * p->L + atan(w * p->tau) < M_PI) lo = w;
+        else hi = w;
+    }
+    double w = (lo + hi) / 2;
+    *ku = sqrt(1 + w * p->tau * w * p->tau) / p->K;
+    *tu = 2 * M_PI / w;
+}
+
+static int Check(const Fopdt_t *p)
+{
+    static Plant_t s;
+    AutoTune_t at;
+    uint32_t now = 0;
+    int fail = 0;
+
+    Plant_Init(&s, p);
+    AutoTune_Start(&at, SETPOINT, 0, OUT_MAX, HYST, now);
+    while (at.state == AT_RUNNING) {
+        int32_t u = AutoTune_Run(&at, Plant_Read(&s), now);
+        Fopdt_Step(&s, u);
+        now += DT_MS;
+    }
+
+    double ku_ref, tu_ref;
+    Ultimate(p, &ku_ref, &tu_ref);
+    printf("autotune_fopdt: K=%.0f tau=%.0fs L=%.0fs: ", p->K, p->tau, p->L);
+    if (at.state != AT_DONE) {
+        printf("FAIL, tune did not finish\n");
+        return 1;
+    }
+    double ku = at.Ku / 65536.0, tu = at.Tu_ms / 1000.0;
+    printf("Ku %.3f (analytic %.3f, %+.0f%%), Tu %.2fs (analytic %.2fs, %+.0f%%), tuned in %.0fs\n",
+           ku, ku_ref, 100 * (ku / ku_ref - 1), tu, tu_ref, 100 * (tu / tu_ref - 1), now / 1000.0);
+    if (fabs(ku / ku_ref - 1) > KU_TOL || fabs(tu / tu_ref - 1) > TU_TOL) fail = 1;
+
+    // 整定结果闭环跑一次
+    q16_t kp, ki, kd;
+    PIDControllerQ16 pid;
+    AutoTune_GetGains(&at, AT_RULE_TL, &kp, &ki, &kd);
+    PIDQ_Init(&pid);
+    pid.limMin = 0;
+    pid.limMax = OUT_MAX;
+    pid.limMinInt = 0;
+    pid.limMaxInt = OUT_MAX;
+    pid.T = Q16(DT_MS / 1000.0);
+    PIDQ_SetTunings(&pid, kp, ki, kd);
+
+    Plant_Init(&s, p);
+    int32_t peak = 0;
+    uint32_t settle = 0;
+    for (now = 0; now < RUN_MS; now += DT_MS) {
+        int32_t y = Plant_Read(&s);
+        if (y > peak) peak = y;
+        if (y > SETPOINT + SETTLE_BAND || y < SETPOINT - SETTLE_BAND) settle = now;
+        Fopdt_Step(&s, PIDQ_Compute(&pid, SETPOINT, y));
+    }
+    printf("autotune_fopdt:   TL gains Kp %.3f Ki %.4f Kd %.3f: overshoot %.1f C, within 2 C after %.0fs\n",
+           kp / 65536.0, ki / 65536.0, kd / 65536.0, (peak - SETPOINT) / 10.0, settle / 1000.0);
+    if (settle >= RUN_MS - DT_MS) fail = 1;
+
+    if (fail) printf("autotune_fopdt:   FAIL\n");
+    return fail;
+}
+
+int main(void)
+{
+    int fail = 0;
+
+    for (unsigned i = 0; i < sizeof(plants) / sizeof(plants[0]); i++) {
+        fail |= Check(&plants[i]);
+    }
+    return fail;
+}
@@ -0,0 +1,154 @@
+#include "host.h"
+#include "encoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================
+//  编码器调温: 加速曲线 + 整机转旋钮 (user-024)
+// ============================================================
+// 1. Encoder_AccelStep 单独查表: 慢速每格 1°C, 快速每格 ENC_ACCEL_MAX_STEP, 中间单调, 正反对称
+// 2. 整机 (子进程): 烙铁开关打开, 用 Host_EncoderTurn 一格一格地转, 从固件打印的
+//    "Set: Iron=..." 读设定值, 每段结束后看设定值变了多少:
+//      慢转  +SLOW_N 格 (每格 SLOW_MS)    -> 正好 +SLOW_N °C
+//      慢反转 -SLOW_BACK 格               -> 正好 -SLOW_BACK °C
+//      快转  +FAST_N 格 (每格 FAST_MS)    -> 接近 +FAST_N x ENC_ACCEL_MAX_STEP
+//      紧接着快速反转 -FAST_N 格          -> 接近 -FAST_N x ENC_ACCEL_MAX_STEP
+//    快转时界面任务 (UI_MS 一次) 第一次取到的格数离上次转动可能很久 (或者刚好只取到一格),
+//    按慢速算, 所以最多有 FIRST_POLL 格只加 1°C。
+
+#define UI_MS       50      // 同 main.c.bkup 界面任务周期
+#define SLOW_N      10
+#define SLOW_BACK   5
+#define SLOW_MS     250     // 4 格/秒, 低于 ENC_ACCEL_SLOW_DPS
+#define FAST_N      10
+#define FAST_MS     10      // 100 格/秒, 高于 ENC_ACCEL_FAST_DPS
+#define FIRST_POLL  (UI_MS / FAST_MS)
+
+typedef struct {
+    const char *name;
+    uint32_t    start_ms;
+    int         dir;
+    int         n;
+    uint32_t    every_ms;
+    uint32_t    sample_ms;      // 这之前设定值必须已经稳定 (最后一格之后至少一个 UI_MS)
+} Phase_t;
+
+static const Phase_t phases[] = {
+    { "slow",         1000, +1, SLOW_N,    SLOW_MS, 4000 },
+    { "slow reverse", 5000, -1, SLOW_BACK, SLOW_MS, 7000 },
+    { "fast",         8000, +1, FAST_N,    FAST_MS, 8190 },
+    { "fast reverse", 8200, -1, FAST_N,    FAST_MS, 8500 },
+};
+#define N_PHASES    (int)(sizeof(phases) / sizeof(phases[0]))
+
+typedef struct {
+    int start;                  // 开始前的设定值
+    int delta[N_PHASES];
+    int sets;                   // "Set:" 行数
+} Result_t;
+
+static Result_t res;
+static int      res_fd;
+static int      iron_set = -1;
+
+static void Text(uint32_t now_ms, const char *line)
+{
+    int iron, gun;
+    (void)now_ms;
+    if (sscanf(line, "Set: Iron=%d, Gun=%d", &iron, &gun) == 2) {
+        iron_set = iron;
+        res.sets++;
+    } else if (sscanf(line, "System Ready! Iron Set: %d", &iron) == 1) {
+        iron_set = iron;
+    }
+}
+
+static void Tick(uint32_t now_ms)
+{
+    static int last = -1;
+
+    if (now_ms == 500) {
+        Host_SetIronSwitch(true);
+        res.start = last = iron_set;
+    }
+    for (int i = 0; i < N_PHASES; i++) {
+        const Phase_t *p = &phases[i];
+        if (now_ms >= p->start_ms && now_ms < p->start_ms + (uint32_t)p->n * p->every_ms &&
+            (now_ms - p->start_ms) % p->every_ms == 0) {
+            Host_EncoderTurn(p->dir);
+        }
+        if (now_ms == p->sample_ms) {
+            res.delta[i] = iron_set - last;
+            last = iron_set;
+        }
+    }
+    if (now_ms >= phases[N_PHASES - 1].sample_ms) {
+        (void)!write(res_fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetTextHook(Text);
+    Host_SetTickHook(Tick, 10);
+    Host_SetEnd((uint64_t)(phases[N_PHASES - 1].sample_ms + 1000) * HOST_NS_PER_MS);
+}
+
+// 加速曲线: 每格步进随转速单调不减, 两端是 1 和 ENC_ACCEL_MAX_STEP, 反向取负
+static int Check_Curve(void)
+{
+    int prev = 0, bad = 0;
+
+    for (uint32_t dps = 1; dps <= 2 * ENC_ACCEL_FAST_DPS; dps++) {
+        int16_t up = Encoder_AccelStep((int16_t)dps, 1000);
+        int16_t down = Encoder_AccelStep((int16_t)-dps, 1000);
+        int step = up / (int)dps;
+
+        if (up != -down || up % (int)dps != 0 || step < prev) bad++;
+        if (dps <= ENC_ACCEL_SLOW_DPS && step != 1) bad++;
+        if (dps >= ENC_ACCEL_FAST_DPS && step != ENC_ACCEL_MAX_STEP) bad++;
+        prev = step;
+    }
+    // 停了很久再拧一格总是 1°C; 不转就是 0
+    if (Encoder_AccelStep(1, 60000) != 1 || Encoder_AccelStep(-1, 60000) != -1) bad++;
+    if (Encoder_AccelStep(0, 10) != 0) bad++;
+
+    printf("encoder_accel: curve 1..%d detents/s: step %d..%d C per detent, %d violation(s)\n",
+           2 * ENC_ACCEL_FAST_DPS, Encoder_AccelStep(1, 1000), Encoder_AccelStep(1, 10), bad);
+    return bad;
+}
+
+int main(void)
+{
+    Result_t r;
+    int fail = 0;
+
+    if (Check_Curve() != 0) fail = 1;
+
+    if (Host_RunFirmware(Setup, &res_fd, &r, sizeof(r)) != 0) {
+        printf("encoder_accel: FAIL, firmware run did not finish\n");
+        return 1;
+    }
+    printf("encoder_accel: start %d C, %d setpoint change(s)\n", r.start, r.sets);
+    for (int i = 0; i < N_PHASES; i++) {
+        const Phase_t *p = &phases[i];
+        int want_min, want_max;
+
+        if (p->every_ms >= SLOW_MS) {
+            want_min = want_max = p->n;
+        } else {
+            want_max = p->n * ENC_ACCEL_MAX_STEP;
+            want_min = want_max - FIRST_POLL * (ENC_ACCEL_MAX_STEP - 1);
+        }
+        printf("encoder_accel: %-12s %+3d detents at %3lu/s: setpoint %+4d C (expect %+d..%+d)\n",
+               p->name, p->dir * p->n, 1000UL / p->every_ms, r.delta[i],
+               p->dir * want_min, p->dir * want_max);
+        if (abs(r.delta[i]) < want_min || abs(r.delta[i]) > want_max || r.delta[i] * p->dir < 0) {
+            printf("encoder_accel: FAIL\n");
+            fail = 1;
+        }
+    }
+    return fail;
+}
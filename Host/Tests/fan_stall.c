@@ -0,0 +1,108 @@
+#include "host.h"
+#include "fan.h"
+#include "gun_logic.h"
+#include "tach.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================
+//  风扇堵转: 风枪加热中卡死转子 (user-011)
+// ============================================================
+// 整机 (子进程): 风枪开关打开并拿起, 到温后在 JAM_AT_S 让风扇转子卡死 (host_plant.fan_jammed),
+// 转速按风扇的时间常数往下掉, 测速沿越来越稀, 直到等不到下一个沿。要求:
+//   1. 卡死后 STOP_MAX_MS 之内风枪进 ERROR, 并且可控硅最后一次导通也在这之前: 下一个测速窗口
+//      最晚 FAN_MEAS_INTERVAL_MS 才开, 窗口里转速还要掉到等不到沿, 再加一个半波导通收尾
+//   2. 之后一直停在 ERROR, 也没有再导通 (从固件打印 "Fan Stall!" 算起; 这行由界面任务打印, 比跳闸晚)
+//   3. 固件自己量的反应时间 (漏掉的那个沿 -> 加热关断) 不超过一个测速周期 (最低转速 TACH_MIN_RPM 时)
+
+#define JAM_AT_S        30
+#define HOLD_S          5       // 判堵转后继续观察
+#define STOP_MAX_MS     (FAN_MEAS_INTERVAL_MS + 500)
+#define TACH_PERIOD_US  (60000000UL / (TACH_MIN_RPM * TACH_PULSES_PER_REV))
+
+typedef struct {
+    bool     stalled;           // 打印了 "Fan Stall!"
+    uint32_t error_ms;          // 卡死 -> 风枪进 ERROR (没进 = 0)
+    uint32_t stop_ms;           // 卡死 -> 风枪最后一次导通 (没导通过 = 0)
+    uint32_t latency_us;        // Tach_GetStallLatencyUs
+    uint64_t gun_after_ns;      // 判堵转之后的导通时间
+    bool     heating;           // 卡死时风枪在 HEATING
+    bool     error;             // 结束时风枪在 ERROR
+    bool     left_error;        // 进 ERROR 之后又离开过
+} Result_t;
+
+static Result_t res;
+static int      res_fd;
+static uint64_t gun_last_ns = 0;
+static uint64_t gun_at_stall = 0;
+static uint32_t stall_at_ms = 0;
+
+static void Text(uint32_t now_ms, const char *line)
+{
+    if (res.stalled || now_ms < JAM_AT_S * 1000 || !strstr(line, "Fan Stall!")) return;
+    res.stalled = true;
+    res.latency_us = Tach_GetStallLatencyUs();
+    stall_at_ms = now_ms;
+    gun_at_stall = Host_GetStats()->gun_on_ns;
+}
+
+static void Tick(uint32_t now_ms)
+{
+    uint64_t gun_ns = Host_GetStats()->gun_on_ns;
+
+    if (now_ms == JAM_AT_S * 1000) {
+        res.heating = (Gun_FSM_GetState() == GUN_STATE_HEATING);
+        host_plant.fan_jammed = true;
+    }
+    if (now_ms > JAM_AT_S * 1000 && gun_ns != gun_last_ns) res.stop_ms = now_ms - JAM_AT_S * 1000;
+    if (now_ms > JAM_AT_S * 1000 && !res.error_ms && Gun_FSM_GetState() == GUN_STATE_ERROR) {
+        res.error_ms = now_ms - JAM_AT_S * 1000;
+    }
+    gun_last_ns = gun_ns;
+    if (res.error_ms && Gun_FSM_GetState() != GUN_STATE_ERROR) res.left_error = true;
+
+    bool done = res.stalled && now_ms >= stall_at_ms + HOLD_S * 1000;
+    if (done || now_ms >= (JAM_AT_S + HOLD_S) * 1000 + STOP_MAX_MS) {
+        if (res.stalled) res.gun_after_ns = gun_ns - gun_at_stall;
+        res.error = (Gun_FSM_GetState() == GUN_STATE_ERROR);
+        (void)!write(res_fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetTextHook(Text);
+    Host_SetGunSwitch(true);
+    Host_SetHandleUp(true);
+    Host_SetTickHook(Tick, 1);
+    Host_SetEnd((uint64_t)(JAM_AT_S + HOLD_S + 1) * HOST_NS_PER_S + (uint64_t)STOP_MAX_MS * HOST_NS_PER_MS);
+}
+
+int main(void)
+{
+    Result_t r;
+
+    if (Host_RunFirmware(Setup, &res_fd, &r, sizeof(r)) != 0) {
+        printf("fan_stall: FAIL, firmware run did not finish\n");
+        return 1;
+    }
+    if (!r.stalled) {
+        printf("fan_stall: no stall reported within %d s of jamming the fan\n", HOLD_S + STOP_MAX_MS / 1000);
+    } else {
+        printf("fan_stall: jammed while %s: ERROR after %lu ms, last gun conduction after %lu ms (bound %d ms)\n",
+               r.heating ? "HEATING" : "not heating", (unsigned long)r.error_ms, (unsigned long)r.stop_ms,
+               STOP_MAX_MS);
+        printf("fan_stall: heater off %lu us after the missed edge (bound %lu us), %llu us conduction after stall, %s\n",
+               (unsigned long)r.latency_us, TACH_PERIOD_US, (unsigned long long)(r.gun_after_ns / HOST_NS_PER_US),
+               r.error && !r.left_error ? "gun latched ERROR" : "gun NOT latched in ERROR");
+    }
+
+    if (!r.heating || !r.stalled || !r.error_ms || r.error_ms > STOP_MAX_MS || r.stop_ms > STOP_MAX_MS ||
+        r.latency_us > TACH_PERIOD_US || r.gun_after_ns != 0 || !r.error || r.left_error) {
+        printf("fan_stall: FAIL\n");
+        return 1;
+    }
+    return 0;
+}
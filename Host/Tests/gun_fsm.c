@@ -0,0 +1,178 @@
+#include "host.h"
+#include "gun_logic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================
+//  风枪状态机安全不变量: 可达状态 x 全部输入组合 (user-013)
+// ============================================================
+// 从 Gun_FSM_Init 出发做广度优先搜索。每个可达状态上把所有输入组合各走一步:
+//   开关 / 手柄 / 风扇堵转 / 监控故障 / 曲线跑完 (2^5) x 温度 3 档 x 风量 2 档 x 步长 3 档
+// 每一步的输出都检查:
+//   1. 加热时风扇必须开着, 且风量不低于 GUN_AIRFLOW_MIN
+//   2. 加热时开关必须开着, 风扇没堵, 没有监控故障, 状态是 HEATING
+//   3. 温度高于 50°C 时风扇只有堵转时才允许停
+// 状态机的内部变量是 static, 所以每个状态用 "从初始状态走到这里的输入序列" 表示,
+// 展开时重放一遍。去重的键: 状态、在本状态的时间 (两个阈值之间的合并)、
+// 手柄原始电平及其保持时间、消抖后的手柄、曲线跑完后等放下手柄的标志 (后三项按 gun_logic.c 的规则推算)。
+
+#define N_TEMPS     3
+#define N_FLOWS     2
+#define N_DTS       3
+#define N_INPUTS    (32 * N_TEMPS * N_FLOWS * N_DTS)
+#define MAX_NODES   65536
+
+static const uint16_t temps[N_TEMPS] = { 25, 50, 200 };     // °C: 凉 / 正好在阈值 / 烫
+static const uint8_t  flows[N_FLOWS] = { 0, 60 };           // 0 = 设定低于下限
+static const uint32_t dts[N_DTS]     = { 100, 5000, 600000 };
+
+typedef struct {
+    // 键
+    uint8_t  state;
+    uint32_t tis;           // 在本状态的时间 (合并后)
+    bool     raw;           // 手柄原始电平
+    uint16_t since;         // 原始电平保持时间, 封顶 300
+    bool     up;            // 消抖后
+    bool     wr;            // wait_release
+    // 重放用
+    int32_t  parent;
+    uint16_t input;
+    uint16_t depth;
+    // 推算用的真实时间
+    uint32_t now;
+    uint32_t change;
+    uint32_t entered;
+} Node_t;
+
+static Node_t nodes[MAX_NODES];
+static int    n_nodes = 0;
+static uint32_t violations = 0, steps = 0;
+
+static void Decode(uint16_t code, GunInputs_t *in, uint32_t *dt)
+{
+    memset(in, 0, sizeof(*in));
+    in->sw_is_on     = code & 1;
+    in->handle_is_up = (code >> 1) & 1;
+    in->fan_locked   = (code >> 2) & 1;
+    in->fault        = (code >> 3) & 1;
+    in->profile_done = (code >> 4) & 1;
+    code >>= 5;
+    in->current_temp = temps[code % N_TEMPS];
+    code /= N_TEMPS;
+    in->airflow = flows[code % N_FLOWS];
+    code /= N_FLOWS;
+    *dt = dts[code];
+}
+
+static uint32_t Tis_Key(uint32_t tis)
+{
+    if (tis < 5000) return tis;
+    if (tis < 600000) return 5000;
+    return 600000;
+}
+
+static bool Same_Key(const Node_t *a, const Node_t *b)
+{
+    return a->state == b->state && Tis_Key(a->tis) == Tis_Key(b->tis) && a->raw == b->raw
+        && a->since == b->since && a->up == b->up && a->wr == b->wr;
+}
+
+static void Report(const Node_t *n, const GunInputs_t *in, const GunOutputs_t *o, const char *what)
+{
+    violations++;
+    if (violations > 10) return;
+    printf("gun_fsm: VIOLATION %s: depth %u, state %d -> %d, sw %d handle %d lock %d fault %d done %d temp %u flow %u"
+           " -> fan %d (%u%%) heat %d\n",
+           what, n->depth + 1, n->state, o->state, in->sw_is_on, in->handle_is_up, in->fan_locked, in->fault,
+           in->profile_done, in->current_temp, in->airflow, o->fan_on, o->fan_percent, o->heat_enable);
+}
+
+static void Check(const Node_t *n, const GunInputs_t *in, const GunOutputs_t *o)
+{
+    steps++;
+    if (o->heat_enable && (!o->fan_on || o->fan_percent < GUN_AIRFLOW_MIN)) Report(n, in, o, "heat without airflow");
+    if (o->heat_enable && (!in->sw_is_on || in->fan_locked || in->fault || o->state != GUN_STATE_HEATING)) {
+        Report(n, in, o, "heat while off / locked / faulted");
+    }
+    if (!o->fan_on && in->current_temp > 50 && !in->fan_locked) Report(n, in, o, "fan off while hot");
+}
+
+// 重放到 n (不含 n 之后的输入), 返回 n 的时刻
+static void Replay(int idx)
+{
+    static uint16_t path[MAX_NODES];
+    int len = 0;
+
+    while (nodes[idx].parent >= 0) {
+        path[len++] = nodes[idx].input;
+        idx = nodes[idx].parent;
+    }
+    Gun_FSM_Init();
+    uint32_t now = 0;
+    while (len > 0) {
+        GunInputs_t in;
+        uint32_t dt;
+        Decode(path[--len], &in, &dt);
+        now += dt;
+        in.now_ms = now;
+        Gun_FSM_Run(&in);
+    }
+}
+
+int main(void)
+{
+    Node_t *root = &nodes[n_nodes++];
+    memset(root, 0, sizeof(*root));
+    root->state = GUN_STATE_OFF;
+    root->parent = -1;
+
+    for (int i = 0; i < n_nodes; i++) {
+        for (uint16_t code = 0; code < N_INPUTS; code++) {
+            Node_t n = nodes[i];
+            GunInputs_t in;
+            uint32_t dt;
+
+            Replay(i);
+            Decode(code, &in, &dt);
+            n.now += dt;
+            in.now_ms = n.now;
+            GunOutputs_t o = Gun_FSM_Run(&in);
+            Check(&nodes[i], &in, &o);
+
+            // 推算新键 (与 Gun_FSM_Run 的消抖 / wait_release 规则相同)
+            if (in.handle_is_up != n.raw) {
+                n.raw = in.handle_is_up;
+                n.change = n.now;
+            } else if (n.now - n.change >= 300) {
+                n.up = n.raw;
+            }
+            n.since = (n.now - n.change >= 300) ? 300 : (uint16_t)(n.now - n.change);
+            if (!n.up || !in.sw_is_on) n.wr = false;
+            if (n.state == GUN_STATE_HEATING && o.state == GUN_STATE_COOLING && in.sw_is_on && n.up && in.profile_done) {
+                n.wr = true;
+            }
+            if (o.state != n.state) n.entered = n.now;
+            n.state = o.state;
+            n.tis = n.now - n.entered;
+
+            bool seen = false;
+            for (int k = 0; k < n_nodes && !seen; k++) seen = Same_Key(&nodes[k], &n);
+            if (seen) continue;
+            if (n_nodes >= MAX_NODES) {
+                printf("gun_fsm: FAIL, more than %d states\n", MAX_NODES);
+                return 1;
+            }
+            n.parent = i;
+            n.input = code;
+            n.depth = nodes[i].depth + 1;
+            nodes[n_nodes++] = n;
+        }
+    }
+
+    int max_depth = 0;
+    for (int i = 0; i < n_nodes; i++) if (nodes[i].depth > max_depth) max_depth = nodes[i].depth;
+    printf("gun_fsm: %d reachable states (max depth %d) x %d input combinations = %u steps checked, %u violations\n",
+           n_nodes, max_depth, N_INPUTS, steps, violations);
+    return violations ? 1 : 0;
+}
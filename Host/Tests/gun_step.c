@@ -0,0 +1,94 @@
+#include "host.h"
+#include "board_config.h"
+#include "thermocouple.h"
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// ============================================================
+//  风枪升温到 350°C: 超调和稳定时间, 开关控制 vs PID (user-008)
+// ============================================================
+// 同一个热模型, 风枪开关打开并拿起, 设定 350°C:
+//   PID:       整机 (子进程), 出厂参数
+//   bang-bang: 测试自己的 10ms 回路, 出风口读数低于设定就整个节拍导通, 等同原来 heat_enable
+//              直接开关加热丝; 风扇转速取整机那次稳态时的转速
+// 按热模型里出风口测温点的温度统计超调, 以及最后一次超出 ±SETTLE_BAND 的时间。
+// PID 的超调和稳定时间都必须比 bang-bang 好。
+
+#define SETPOINT_C      350.0
+#define SETTLE_BAND     2.0
+#define RUN_MS          180000
+#define DT_MS           10
+
+typedef struct {
+    double   peak;          // 最高温度
+    double   settle_s;      // 最后一次超出 ±SETTLE_BAND 之后的时刻 (s)
+    double   final;         // 结束时温度
+    double   fan;           // 结束时风扇转速 / 满转速
+} StepResult_t;
+
+static StepResult_t res;
+static int          result_fd;
+
+static void Record(StepResult_t *r, uint32_t now_ms, double t)
+{
+    if (t > r->peak) r->peak = t;
+    if (fabs(t - SETPOINT_C) > SETTLE_BAND) r->settle_s = now_ms / 1000.0;
+    r->final = t;
+}
+
+static void Sample(uint32_t now_ms)
+{
+    Record(&res, now_ms, host_plant.gun_sensor);
+
+    if (now_ms >= RUN_MS) {
+        res.fan = host_plant.fan_rpm / host_plant.fan_rpm_max;
+        (void)!write(result_fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static StepResult_t Run_BangBang(double fan)
+{
+    StepResult_t r = { 0 };
+
+    Plant_Reset();
+    for (uint32_t ms = 0; ms < RUN_MS; ms += DT_MS) {
+        uint32_t sum = 0;
+        for (int i = 0; i < ADC_OVERSAMPLE; i++) sum += Plant_GunCode();
+        bool on = TC_AdcToTenths((uint16_t)(sum / ADC_OVERSAMPLE)) < SETPOINT_C * 10;
+        Plant_Step(DT_MS / 1000.0, 0, on ? host_plant.gun_w * DT_MS / 1000.0 : 0, fan);
+        Record(&r, ms + DT_MS, host_plant.gun_sensor);
+    }
+    r.fan = fan;
+    return r;
+}
+
+static void Setup(void)
+{
+    Host_SetGunSwitch(true);
+    Host_SetHandleUp(true);
+    Host_SetTickHook(Sample, 100);
+    Host_SetEnd((uint64_t)(RUN_MS + 1000) * HOST_NS_PER_MS);
+}
+
+int main(void)
+{
+    StepResult_t bb, pid;
+
+    if (Host_RunFirmware(Setup, &result_fd, &pid, sizeof(pid)) != 0) {
+        printf("gun_step: FAIL, simulation did not finish\n");
+        return 1;
+    }
+    bb = Run_BangBang(pid.fan);
+    printf("gun_step: bang-bang: overshoot %.1f C, settled within %.0f C after %.1f s, final %.1f C\n",
+           bb.peak - SETPOINT_C, SETTLE_BAND, bb.settle_s, bb.final);
+    printf("gun_step: PID:       overshoot %.1f C, settled within %.0f C after %.1f s, final %.1f C\n",
+           pid.peak - SETPOINT_C, SETTLE_BAND, pid.settle_s, pid.final);
+
+    if (pid.peak >= bb.peak || pid.settle_s >= bb.settle_s) {
+        printf("gun_step: FAIL\n");
+        return 1;
+    }
+    return 0;
+}
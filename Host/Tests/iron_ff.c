@@ -0,0 +1,188 @@
+#include "host.h"
+#include "board_config.h"
+#include "iron_pid.h"
+#include "load_detect.h"
+#include "remote.h"
+#include "settings.h"
+#include "thermocouple.h"
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// ============================================================
+//  烙铁升温: 前馈预载前后的上升时间 / 超调 / 稳定时间 (user-014)
+// ============================================================
+// 同一个热模型 (host_plant.c 的烙铁) 从室温升到 300°C 和 400°C:
+//   before   - 只有 PIDQ_Compute, 积分从 0 开始 (加前馈之前的做法)
+//   after    - 升温到 IRON_FF_BAND 之前满功率、积分钉在前馈值上, 进带时交给 PID 并进入负载增强
+//              (Kp x3 / Ki x10, LoadDetect 判定稳住后退出), 同 main.c.bkup 烙铁分支的规则
+//   firmware - 整机跑一遍 (子进程), 确认固件里实际的结果和 after 一致
+// 前两种是测试自己的 10ms 控制回路, 参数同出厂值; 温度统计用模型里的发热芯 (测温点) 温度。
+// after 和 firmware 的上升时间不能比 before 慢, 稳定时间必须比 before 短。
+
+#define DT_S            0.01
+#define RUN_S           150.0
+#define SETTLE_BAND     2.0
+#define RISE_TOL_S      DT_S    // 整机按自己的 10ms 节拍采样, 上升时间允许差一拍
+#define IRON_FF_BAND    50      // 0.1°C, 同 main.c.bkup
+#define LOAD_KP_BOOST   3
+#define LOAD_KI_BOOST   10
+
+typedef struct {
+    double rise_s;          // 从室温升到 90% 的时间
+    double overshoot;       // °C
+    double settle_s;        // 最后一次超出 ±SETTLE_BAND 的时刻
+} Step_t;
+
+typedef struct {
+    double sp;
+    double start;
+    Step_t r;
+} Meter_t;
+
+static void Meter_Init(Meter_t *m, double sp)
+{
+    m->sp = sp;
+    m->start = host_plant.iron_heater;
+    m->r.rise_s = -1;
+    m->r.overshoot = 0;
+    m->r.settle_s = 0;
+}
+
+static void Meter_Sample(Meter_t *m, double t_s, double temp)
+{
+    if (m->r.rise_s < 0 && temp >= m->start + 0.9 * (m->sp - m->start)) m->r.rise_s = t_s;
+    if (temp - m->sp > m->r.overshoot) m->r.overshoot = temp - m->sp;
+    if (fabs(temp - m->sp) > SETTLE_BAND) m->r.settle_s = t_s;
+}
+
+static int32_t Measure(void)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < ADC_OVERSAMPLE; i++) sum += Plant_IronCode();
+    return TC_AdcToTenths((uint16_t)(sum / ADC_OVERSAMPLE));
+}
+
+static void Set_Gains(PIDControllerQ16 *pid, bool boost)
+{
+    PIDQ_SetTunings(pid, Q16(1.2) * (boost ? LOAD_KP_BOOST : 1), Q16(0.3) * (boost ? LOAD_KI_BOOST : 1), Q16(0.06));
+}
+
+static Step_t Run_Loop(uint16_t sp_c, bool feedforward)
+{
+    PIDControllerQ16 pid;
+    LoadDetect_t ld;
+    Meter_t m;
+    bool heatup = feedforward, boost = false;
+    int32_t sp = sp_c * 10;
+    int32_t ff = (int32_t)(((int64_t)Q16(0.07) * (sp - TC_AMBIENT_TENTHS)) >> 16);  // 出厂 iron_ff
+
+    Plant_Reset();
+    PIDQ_Init(&pid);
+    pid.limMin = 0;
+    pid.limMax = IRON_PWM_MAX;
+    pid.limMinInt = 0;
+    pid.limMaxInt = IRON_PWM_MAX;
+    pid.T = Q16(DT_S);
+    Set_Gains(&pid, false);
+    LoadDetect_Init(&ld);
+    Meter_Init(&m, sp_c);
+
+    for (double t = 0; t < RUN_S; t += DT_S) {
+        int32_t y = Measure();
+        int32_t err = sp - y;
+        if (heatup && err <= IRON_FF_BAND) {
+            heatup = false;
+            LoadDetect_Start(&ld);
+        }
+        bool b = feedforward && LoadDetect_Update(&ld, y, err, (uint16_t)(DT_S * 1000));
+        if (b != boost) {
+            boost = b;
+            Set_Gains(&pid, b);
+        }
+        int32_t pwm = PIDQ_Compute(&pid, sp, y);
+        if (heatup) {
+            PIDQ_Preload(&pid, ff);
+            pwm = IRON_PWM_MAX;
+        }
+        Plant_Step(DT_S, host_plant.iron_w * pwm / IRON_PWM_PERIOD * DT_S, 0, 0);
+        Meter_Sample(&m, t + DT_S, host_plant.iron_heater);
+    }
+    return m.r;
+}
+
+// ------------------------------------------------------------
+//  整机
+// ------------------------------------------------------------
+// 开机后先用远程命令设好温度, 再打开烙铁开关, 从开关打开算时间
+#define FW_ON_MS        500
+
+static Meter_t  fw_meter;
+static uint16_t fw_sp;
+static int      fw_fd;
+
+static void Fw_Sample(uint32_t now_ms)
+{
+    if (now_ms == 100) {
+        uint8_t p[5] = { REMOTE_F_IRON_TARGET, (uint8_t)fw_sp, (uint8_t)(fw_sp >> 8), 0, 0 };
+        Host_SendCommand(REMOTE_CMD_SET, p, sizeof(p));
+    }
+    if (now_ms == FW_ON_MS) {
+        Host_SetIronSwitch(true);
+        Meter_Init(&fw_meter, fw_sp);
+    }
+    if (now_ms <= FW_ON_MS) return;
+
+    Meter_Sample(&fw_meter, (now_ms - FW_ON_MS) / 1000.0, host_plant.iron_heater);
+    if (now_ms >= FW_ON_MS + RUN_S * 1000) {
+        (void)!write(fw_fd, &fw_meter.r, sizeof(fw_meter.r));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetTickHook(Fw_Sample, 10);
+    Host_SetEnd((uint64_t)(RUN_S + 2) * HOST_NS_PER_S);
+}
+
+static int Run_Firmware(uint16_t sp_c, Step_t *out)
+{
+    fw_sp = sp_c;
+    return Host_RunFirmware(Setup, &fw_fd, out, sizeof(*out));
+}
+
+static void Print(uint16_t sp_c, const char *name, const Step_t *r)
+{
+    printf("iron_ff: %u C %-8s rise (90%%) %5.1f s, overshoot %5.1f C, within %.0f C after %5.1f s\n",
+           sp_c, name, r->rise_s, r->overshoot, SETTLE_BAND, r->settle_s);
+}
+
+int main(void)
+{
+    static const uint16_t sps[] = { 300, 400 };
+    int fail = 0;
+
+    for (unsigned i = 0; i < sizeof(sps) / sizeof(sps[0]); i++) {
+        Step_t before = Run_Loop(sps[i], false);
+        Step_t after = Run_Loop(sps[i], true);
+        Step_t fw;
+        Print(sps[i], "before", &before);
+        Print(sps[i], "after", &after);
+        if (Run_Firmware(sps[i], &fw) != 0) {
+            printf("iron_ff: FAIL, firmware run did not finish\n");
+            fail = 1;
+            continue;
+        }
+        Print(sps[i], "firmware", &fw);
+
+        // 前馈必须减小超调, 上升时间不能变慢, 稳定时间必须变短; 固件和测试回路的超调相差不到 1°C
+        if (after.overshoot >= before.overshoot || after.rise_s > before.rise_s + RISE_TOL_S ||
+            after.settle_s >= before.settle_s || fw.rise_s > before.rise_s + RISE_TOL_S ||
+            fw.settle_s >= before.settle_s || fabs(fw.overshoot - after.overshoot) > 1.0) {
+            printf("iron_ff: FAIL\n");
+            fail = 1;
+        }
+    }
+    return fail;
+}
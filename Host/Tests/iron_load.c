@@ -0,0 +1,188 @@
+#include "host.h"
+#include "board_config.h"
+#include "iron_pid.h"
+#include "load_detect.h"
+#include "thermocouple.h"
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// ============================================================
+//  烙铁碰焊件: 掉温和恢复, 负载增强前后 (user-015)
+// ============================================================
+// 烙铁稳定在 300°C 后, 在 LOAD_AT_S 给烙铁头加一个额外散热 (LOAD_S 秒), 功率按 300°C 时折算:
+//   before   - 前馈升温 + PID, 没有负载检测 (加增强之前的 main.c.bkup)
+//   after    - LoadDetect 判定负载时 Kp x3 / Ki x10 且不钉积分, 回到 ±1°C 内稳住 3s 才切回 (main.c.bkup 现在的规则)
+//   firmware - 整机跑一遍 (子进程)
+// 统计都以加负载那一刻的温度为基准 (整机的测温链和测试回路有零点几度的静差):
+// 最大掉温, 以及负载期间最后一次超出 ±2°C 的时刻 (相对加负载), 到撤掉负载还没回来算 "没恢复"。
+// 另外不加负载跑同样长时间, 升温交接之后增强一次都不能触发 (ADC 噪声不能误判)。
+
+#define DT_S            0.01
+#define LOAD_AT_S       80.0
+#define LOAD_S          10.0
+#define RUN_S           (LOAD_AT_S + LOAD_S)
+#define SETPOINT        3000    // 0.1°C
+#define BAND            2.0
+#define RECOVER_MAX_S   6.0     // 整机必须在这之前回到 ±BAND 内
+#define IRON_FF_BAND    50      // 同 main.c.bkup
+#define LOAD_KP_BOOST   3
+#define LOAD_KI_BOOST   10
+
+typedef struct {
+    double base;            // 加负载时的温度
+    double dip;             // °C
+    double recover_s;       // 加负载后多久回到 ±BAND 内 (没回来 = -1)
+    int    boosts;          // LOAD_AT_S 之后进入增强的次数 (升温交接那次不算)
+} Load_t;
+
+static void Load_Sample(Load_t *r, double t_s, double temp, bool *out_of_band)
+{
+    if (t_s < LOAD_AT_S) {
+        r->base = temp;
+        return;
+    }
+    if (r->base - temp > r->dip) r->dip = r->base - temp;
+    if (fabs(temp - r->base) > BAND) {
+        *out_of_band = true;
+        r->recover_s = t_s - LOAD_AT_S;
+    } else {
+        *out_of_band = false;
+    }
+}
+
+static int32_t Measure(void)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < ADC_OVERSAMPLE; i++) sum += Plant_IronCode();
+    return TC_AdcToTenths((uint16_t)(sum / ADC_OVERSAMPLE));
+}
+
+static double Load_G(double watts)
+{
+    return watts / (SETPOINT / 10.0 - host_plant.ambient);
+}
+
+static Load_t Run_Loop(double load_w, bool boost_on)
+{
+    PIDControllerQ16 pid;
+    LoadDetect_t ld;
+    Load_t r = { 0, 0, 0, 0 };
+    bool boost = false, out = false, heatup = true;
+    int32_t ff = (int32_t)(((int64_t)Q16(0.07) * (SETPOINT - TC_AMBIENT_TENTHS)) >> 16);
+
+    Plant_Reset();
+    PIDQ_Init(&pid);
+    pid.limMin = 0;
+    pid.limMax = IRON_PWM_MAX;
+    pid.limMinInt = 0;
+    pid.limMaxInt = IRON_PWM_MAX;
+    pid.T = Q16(DT_S);
+    PIDQ_SetTunings(&pid, Q16(1.2), Q16(0.3), Q16(0.06));
+    LoadDetect_Init(&ld);
+
+    for (double t = 0; t < RUN_S; t += DT_S) {
+        host_plant.iron_g_load = (t >= LOAD_AT_S) ? Load_G(load_w) : 0;
+
+        int32_t y = Measure();
+        int32_t err = SETPOINT - y;
+        if (heatup && err <= IRON_FF_BAND) {
+            heatup = false;
+            if (boost_on) LoadDetect_Start(&ld);
+        }
+        bool b = boost_on && LoadDetect_Update(&ld, y, err, (uint16_t)(DT_S * 1000));
+        if (b != boost) {
+            boost = b;
+            if (b && t >= LOAD_AT_S) r.boosts++;
+            PIDQ_SetTunings(&pid, Q16(1.2) * (b ? LOAD_KP_BOOST : 1), Q16(0.3) * (b ? LOAD_KI_BOOST : 1), Q16(0.06));
+        }
+        int32_t pwm = PIDQ_Compute(&pid, SETPOINT, y);
+        if (heatup) {
+            PIDQ_Preload(&pid, ff);
+            pwm = IRON_PWM_MAX;
+        }
+        Plant_Step(DT_S, host_plant.iron_w * pwm / IRON_PWM_PERIOD * DT_S, 0, 0);
+        Load_Sample(&r, t + DT_S, host_plant.iron_heater, &out);
+    }
+    if (out) r.recover_s = -1;
+    return r;
+}
+
+// ------------------------------------------------------------
+//  整机
+// ------------------------------------------------------------
+static Load_t fw_res;
+static bool   fw_out;
+static double fw_load_w;
+static int    fw_fd;
+
+static void Fw_Sample(uint32_t now_ms)
+{
+    double t = now_ms / 1000.0;
+
+    host_plant.iron_g_load = (t >= LOAD_AT_S) ? Load_G(fw_load_w) : 0;
+    Load_Sample(&fw_res, t, host_plant.iron_heater, &fw_out);
+    if (t >= RUN_S) {
+        if (fw_out) fw_res.recover_s = -1;
+        (void)!write(fw_fd, &fw_res, sizeof(fw_res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetIronSwitch(true);
+    Host_SetTickHook(Fw_Sample, 10);
+    Host_SetEnd((uint64_t)(RUN_S + 1) * HOST_NS_PER_S);
+}
+
+static int Run_Firmware(double load_w, Load_t *out)
+{
+    fw_load_w = load_w;
+    return Host_RunFirmware(Setup, &fw_fd, out, sizeof(*out));
+}
+
+static void Print(double load_w, const char *name, const Load_t *r, bool boosts)
+{
+    printf("iron_load: %2.0f W %-8s base %.2f dip %5.1f C, ", load_w, name, r->base, r->dip);
+    if (r->recover_s < 0)       printf("not back within %.0f C after %.0f s", BAND, LOAD_S);
+    else if (r->recover_s == 0) printf("stayed within %.0f C", BAND);
+    else                        printf("back within %.0f C after %4.1f s", BAND, r->recover_s);
+    if (boosts) printf(", %d boost(s)", r->boosts);
+    printf("\n");
+}
+
+int main(void)
+{
+    static const double loads[] = { 15.0, 8.0 };
+    int fail = 0;
+
+    for (unsigned i = 0; i < sizeof(loads) / sizeof(loads[0]); i++) {
+        Load_t before = Run_Loop(loads[i], false);
+        Load_t after = Run_Loop(loads[i], true);
+        Load_t fw;
+        Print(loads[i], "before", &before, false);
+        Print(loads[i], "after", &after, true);
+        if (Run_Firmware(loads[i], &fw) != 0) {
+            printf("iron_load: FAIL, firmware run did not finish\n");
+            fail = 1;
+            continue;
+        }
+        Print(loads[i], "firmware", &fw, false);
+
+        // 增强必须减小掉温, 整机要在 RECOVER_MAX_S 内回到 ±BAND 并一直待在里面 (测试回路同样要恢复)
+        if (after.dip >= before.dip || fw.dip >= before.dip || after.recover_s < 0 ||
+            fw.recover_s < 0 || fw.recover_s > RECOVER_MAX_S) {
+            printf("iron_load: FAIL\n");
+            fail = 1;
+        }
+    }
+
+    Load_t idle = Run_Loop(0, true);
+    printf("iron_load: no load, %.0f s with ADC noise: %d boost(s)\n", RUN_S, idle.boosts);
+    if (idle.boosts) {
+        printf("iron_load: FAIL, boost triggered without load\n");
+        fail = 1;
+    }
+    return fail;
+}
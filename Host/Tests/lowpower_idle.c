@@ -0,0 +1,121 @@
+#include "host.h"
+#include "lowpower.h"
+#include "power_mgr.h"
+#include "remote.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================
+//  待机 -> 自动关 -> STOP -> 转旋钮唤醒 (user-025)
+// ============================================================
+// 整机 (子进程): 待机 STANDBY_MIN 分钟、自动关再 OFF_MIN 分钟 (远程命令设置), 烙铁开关打开后一直不动:
+//   1. STANDBY_MIN 分钟后打印 "Iron standby", 再过 OFF_MIN 分钟打印 "Iron OFF" (各允许 EDGE_MS 误差)
+//   2. 再过 PM_SLEEP_DELAY_MS 进 STOP, 到唤醒之前 STOP 累计时间 (stop_ns) 要大于 0,
+//      自动关之后烙铁不再有 PWM 输出
+//   3. WAKE_AT_S 转一格编码器 (EXTI 唤醒), 醒来后烙铁重新加热;
+//      LowPowerStats_t.heat_latency_us (醒来 -> 第一次加热输出) 不超过 HEAT_LATENCY_MAX_US
+//      (唤醒的动作下一个控制节拍才取走, 最多两个节拍)
+
+#define STANDBY_MIN         1
+#define OFF_MIN             3       // 够烙铁降到待机温度 (到点交接的增强不能把自己叫醒)
+#define SWITCH_ON_MS        500
+#define EDGE_MS             1000
+#define WAKE_AT_S           300
+#define AFTER_WAKE_MS       2000
+#define HEAT_LATENCY_MAX_US 20000
+
+typedef struct {
+    uint32_t standby_ms;        // 开关打开 -> "Iron standby" (没有 = 0)
+    uint32_t off_ms;            // 开关打开 -> "Iron OFF"
+    uint64_t stop_ns;           // 唤醒前的 STOP 累计
+    uint64_t iron_off_ns;       // 自动关之后到唤醒前烙铁的 PWM 时间
+    uint32_t sleeps;            // LowPowerStats_t.count
+    uint32_t heat_latency_us;
+    bool     woke;              // 唤醒之后打印了 "Wake:"
+    bool     heated;            // 醒来后烙铁有 PWM 输出
+} Result_t;
+
+static Result_t res;
+static int      res_fd;
+static uint64_t iron_at_off = 0;
+static uint64_t iron_at_wake = 0;
+
+static void Set_Field(uint8_t id, int32_t v)
+{
+    uint8_t p[5] = { id, (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    Host_SendCommand(REMOTE_CMD_SET, p, sizeof(p));
+}
+
+static void Text(uint32_t now_ms, const char *line)
+{
+    if (now_ms < SWITCH_ON_MS) return;
+    if (!res.standby_ms && strstr(line, "Iron standby")) res.standby_ms = now_ms - SWITCH_ON_MS;
+    if (!res.off_ms && strstr(line, "Iron OFF")) {
+        res.off_ms = now_ms - SWITCH_ON_MS;
+        iron_at_off = Host_GetStats()->iron_on_ns;
+    }
+    if (now_ms >= WAKE_AT_S * 1000 && strstr(line, "Wake:")) res.woke = true;
+}
+
+static void Tick(uint32_t now_ms)
+{
+    if (now_ms == 100) {
+        Set_Field(REMOTE_F_STANDBY_MIN, STANDBY_MIN);
+        Set_Field(REMOTE_F_OFF_MIN, OFF_MIN);
+    }
+    if (now_ms == SWITCH_ON_MS) Host_SetIronSwitch(true);
+    if (now_ms == WAKE_AT_S * 1000) {
+        const HostStats_t *s = Host_GetStats();
+        res.stop_ns = s->stop_ns;
+        iron_at_wake = s->iron_on_ns;
+        if (res.off_ms) res.iron_off_ns = iron_at_wake - iron_at_off;
+        Host_EncoderTurn(1);
+    }
+    if (now_ms >= WAKE_AT_S * 1000 + AFTER_WAKE_MS) {
+        const LowPowerStats_t *lp = LowPower_GetStats();
+        res.sleeps = lp->count;
+        res.heat_latency_us = lp->heat_latency_us;
+        res.heated = Host_GetStats()->iron_on_ns > iron_at_wake;
+        (void)!write(res_fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetTextHook(Text);
+    Host_SetTickHook(Tick, 10);
+    Host_SetEnd((uint64_t)(WAKE_AT_S + 10) * HOST_NS_PER_S);
+}
+
+static bool Near(uint32_t ms, uint32_t want)
+{
+    return ms >= want && ms <= want + EDGE_MS;
+}
+
+int main(void)
+{
+    Result_t r;
+
+    if (Host_RunFirmware(Setup, &res_fd, &r, sizeof(r)) != 0) {
+        printf("lowpower_idle: FAIL, firmware run did not finish\n");
+        return 1;
+    }
+    printf("lowpower_idle: standby after %.1f s, off after %.1f s (expect %d s, %d s)\n",
+           r.standby_ms / 1000.0, r.off_ms / 1000.0, STANDBY_MIN * 60, (STANDBY_MIN + OFF_MIN) * 60);
+    printf("lowpower_idle: %lu sleep(s), %.1f s in STOP before wake, iron PWM after auto-off %llu us\n",
+           (unsigned long)r.sleeps, r.stop_ns / (double)HOST_NS_PER_S,
+           (unsigned long long)(r.iron_off_ns / HOST_NS_PER_US));
+    printf("lowpower_idle: encoder wake %s, iron %s, wake -> heat %lu us (bound %d us)\n",
+           r.woke ? "ok" : "missed", r.heated ? "heating" : "not heating",
+           (unsigned long)r.heat_latency_us, HEAT_LATENCY_MAX_US);
+
+    if (!Near(r.standby_ms, STANDBY_MIN * 60000) || !Near(r.off_ms, (STANDBY_MIN + OFF_MIN) * 60000) ||
+        r.stop_ns == 0 || r.iron_off_ns != 0 || !r.woke || !r.heated || r.heat_latency_us == 0 ||
+        r.heat_latency_us > HEAT_LATENCY_MAX_US) {
+        printf("lowpower_idle: FAIL\n");
+        return 1;
+    }
+    return 0;
+}
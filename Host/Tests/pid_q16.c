@@ -0,0 +1,98 @@
+#include "host.h"
+#include "board_config.h"
+#include "iron_pid.h"
+#include "settings.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ============================================================
+//  PIDQ_Compute 与 PID_Compute 的等价性 (user-001)
+// ============================================================
+// 先让整机跑一段烙铁闭环 (升温 / 碰焊件 / 改设定), 每 10ms 记下设定值和发热芯温度 (0.1°C),
+// 再把这条记录分别喂给 double 版和 Q16 版 (参数同固件出厂值), 比较每一步的输出。
+// Q16 版输出取整, 所以允许 1 个 PWM 计数的偏差。
+// 两版在 M0+ 上的耗时在板子上量 (main.c.bkup 的 PID_BENCH), 主机上的时间没有参考意义, 这里不比。
+
+int app_main(void);
+
+#define TRACE_MS        150000
+#define TRACE_LEN       (TRACE_MS / 10)
+#define MAX_DEV         1.0
+
+static int32_t trace_sp[TRACE_LEN];
+static int32_t trace_pv[TRACE_LEN];
+static int     trace_n = 0;
+
+static void Setup(PIDController *d, PIDControllerQ16 *q)
+{
+    PID_Init(d);
+    d->Kp = 1.2;
+    d->Ki = 0.3;
+    d->Kd = 0.06;
+    d->limMin = 0;
+    d->limMax = IRON_PWM_MAX;
+    d->limMinInt = 0;
+    d->limMaxInt = IRON_PWM_MAX;
+    d->T = 0.01;
+
+    PIDQ_Init(q);
+    q->limMin = 0;
+    q->limMax = IRON_PWM_MAX;
+    q->limMinInt = 0;
+    q->limMaxInt = IRON_PWM_MAX;
+    q->T = Q16(0.01);
+    PIDQ_SetTunings(q, Q16(1.2), Q16(0.3), Q16(0.06));
+}
+
+static int Compare(void)
+{
+    PIDController    d;
+    PIDControllerQ16 q;
+    double max_dev = 0;
+    int    at = 0;
+
+    Setup(&d, &q);
+    for (int i = 0; i < trace_n; i++) {
+        double  od = PID_Compute(&d, trace_sp[i], trace_pv[i]);
+        int32_t oq = PIDQ_Compute(&q, trace_sp[i], trace_pv[i]);
+        double  dev = fabs(od - oq);
+        if (dev > max_dev) {
+            max_dev = dev;
+            at = i;
+        }
+    }
+    printf("pid_q16: %d samples, max |double - Q16| = %.3f PWM counts at t = %.2f s (sp %d, pv %d)\n",
+           trace_n, max_dev, at * 0.01, trace_sp[at], trace_pv[at]);
+
+    if (max_dev > MAX_DEV) {
+        printf("pid_q16: FAIL (limit %.1f)\n", MAX_DEV);
+        return 1;
+    }
+    return 0;
+}
+
+static void Record(uint32_t now_ms)
+{
+    if (now_ms == 60000) host_plant.iron_g_load = 0.05;     // 碰上大焊盘
+    if (now_ms == 80000) host_plant.iron_g_load = 0;
+    if (now_ms == 100000) Host_EncoderTurn(-10);            // 设定值往下调
+
+    if (trace_n < TRACE_LEN) {
+        trace_sp[trace_n] = sys_settings.iron_target * 10;
+        trace_pv[trace_n] = (int32_t)lround(host_plant.iron_heater * 10);
+        trace_n++;
+    }
+    if (now_ms >= TRACE_MS) Host_Exit(Compare());
+}
+
+int main(void)
+{
+    Host_Init();
+    Host_SetQuiet(true);
+    Host_SetIronSwitch(true);
+    Host_SetTickHook(Record, 10);
+    Host_SetEnd((uint64_t)(TRACE_MS + 1000) * HOST_NS_PER_MS);
+    app_main();
+    return 1;
+}
@@ -0,0 +1,166 @@
+#include "host.h"
+#include "board_config.h"
+#include "power_arb.h"
+#include "remote.h"
+#include <stdio.h>
+#include <unistd.h>
+
+// ============================================================
+//  功率仲裁: 峰值不超限, 升温时间, 欠账有界 (user-023)
+// ============================================================
+// 整机 (子进程): 烙铁 40W + 风枪 700W, 供电上限 LIMIT_W (两路同时开就超), 两个开关同时打开,
+// 每种优先级跑一遍, 另外跑一遍不限制的做对比。统计:
+//   overlap  - 两路同时导通的累计时间, 限制时必须为 0 (不限制那次应该大于 0, 证明统计有效)
+//   升温时间 - 发热芯 / 出风口测温点第一次到设定 -TTT_BAND 的时刻 (从开关打开算)
+// 优先的一路升温时间最多比不限制慢 FAVORED_SLACK_S。两路不能同时满功率, 让的一路至少要等
+// 两路依次单独升温的时间 (风枪到温后稳态还要占 1/3 左右的周波), 最多是它的 YIELD_FACTOR 倍。
+// 仲裁器本身 (测试回路): 三种优先级下随机请求和风枪长时间满载交替, 每个时隙检查
+// iron_carry 在 [0, iron_max] 内, 不能越积越多。
+
+#define LIMIT_W         720
+#define IRON_W          40      // 同出厂设置和热模型
+#define GUN_W           700
+#define IRON_SHARE      30
+#define SWITCH_ON_MS    500
+#define RUN_MS          120000
+#define TTT_BAND        2.0
+#define FAVORED_SLACK_S 1.0
+#define YIELD_FACTOR    1.6
+#define CARRY_SLOTS     200000
+
+typedef struct {
+    double   iron_s;        // 升温时间 (没到 = -1)
+    double   gun_s;
+    uint64_t overlap_ns;
+} Run_t;
+
+static const char *prio_name[] = { "iron", "gun", "fair" };
+
+static Run_t res;
+static int   res_fd;
+static int   run_limit;
+static int   run_prio;
+
+static void Set_Field(uint8_t id, int32_t v)
+{
+    uint8_t p[5] = { id, (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    Host_SendCommand(REMOTE_CMD_SET, p, sizeof(p));
+}
+
+static void Tick(uint32_t now_ms)
+{
+    if (now_ms == 100) {
+        Set_Field(REMOTE_F_POWER_LIMIT, run_limit);
+        Set_Field(REMOTE_F_IRON_WATTS, IRON_W);
+        Set_Field(REMOTE_F_GUN_WATTS, GUN_W);
+        Set_Field(REMOTE_F_POWER_PRIORITY, run_prio);
+        Set_Field(REMOTE_F_IRON_SHARE, IRON_SHARE);
+    }
+    if (now_ms == SWITCH_ON_MS) {
+        Host_SetIronSwitch(true);
+        Host_SetGunSwitch(true);
+        Host_SetHandleUp(true);
+    }
+    if (now_ms < SWITCH_ON_MS) return;
+
+    double t = (now_ms - SWITCH_ON_MS) / 1000.0;
+    if (res.iron_s < 0 && host_plant.iron_heater >= 300 - TTT_BAND) res.iron_s = t;
+    if (res.gun_s < 0 && host_plant.gun_sensor >= 350 - TTT_BAND) res.gun_s = t;
+    if ((res.iron_s >= 0 && res.gun_s >= 0) || now_ms >= RUN_MS) {
+        res.overlap_ns = Host_GetStats()->overlap_ns;
+        (void)!write(res_fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    res.iron_s = res.gun_s = -1;
+    Host_SetTickHook(Tick, 10);
+    Host_SetEnd((uint64_t)(RUN_MS + 1000) * HOST_NS_PER_MS);
+}
+
+static int Run_Firmware(int limit_w, int prio, Run_t *out)
+{
+    run_limit = limit_w;
+    run_prio = prio;
+    return Host_RunFirmware(Setup, &res_fd, out, sizeof(*out));
+}
+
+// 仲裁器单独跑 CARRY_SLOTS 个时隙: 风枪按分到的占空比做 sigma-delta (同 GunHeater 不同步时的节拍),
+// 每 1000 个时隙换一次随机请求, 每 5000 个时隙里有 1000 个风枪满载, 返回 carry 的最大/最小值
+static void Run_Carry(int prio, int32_t *cmin, int32_t *cmax)
+{
+    PwrConfig_t cfg = { LIMIT_W, IRON_W, GUN_W, (uint8_t)prio, IRON_SHARE };
+    PwrArbiter_t a;
+    uint32_t seed = 12345, acc = 0;
+    uint16_t iron_req = 0, gun_req = 0;
+
+    Pwr_Init(&a, IRON_PWM_MAX);
+    *cmin = *cmax = 0;
+    for (uint32_t i = 0; i < CARRY_SLOTS; i++) {
+        if (i % 1000 == 0) {
+            seed = seed * 1103515245u + 12345u;
+            iron_req = (uint16_t)((seed >> 8) % (IRON_PWM_MAX + 1));
+            seed = seed * 1103515245u + 12345u;
+            gun_req = (uint16_t)((seed >> 8) % 1001);
+            if (i % 5000 == 0) gun_req = 1000;
+        }
+        uint16_t g = Pwr_GunGrant(&a, &cfg, iron_req, gun_req);
+        acc += g;
+        bool on = (acc >= 1000);
+        if (on) acc -= 1000;
+        (void)Pwr_IronSlot(&a, &cfg, on);
+        if (a.iron_carry < *cmin) *cmin = a.iron_carry;
+        if (a.iron_carry > *cmax) *cmax = a.iron_carry;
+    }
+}
+
+int main(void)
+{
+    Run_t base, r;
+    int fail = 0;
+
+    if (Run_Firmware(0, PWR_PRIO_IRON, &base) != 0) {
+        printf("power_arb: FAIL, firmware run did not finish\n");
+        return 1;
+    }
+    printf("power_arb: no limit:       iron %5.1f s, gun %5.1f s, overlap %6.1f ms\n",
+           base.iron_s, base.gun_s, base.overlap_ns / (double)HOST_NS_PER_MS);
+    if (base.iron_s < 0 || base.gun_s < 0 || base.overlap_ns == 0) {
+        printf("power_arb: FAIL, baseline\n");
+        fail = 1;
+    }
+
+    for (int prio = 0; prio < PWR_PRIO_COUNT; prio++) {
+        if (Run_Firmware(LIMIT_W, prio, &r) != 0) {
+            printf("power_arb: FAIL, firmware run did not finish\n");
+            fail = 1;
+            continue;
+        }
+        printf("power_arb: %d W, %-4s first: iron %5.1f s, gun %5.1f s, overlap %6.1f ms\n",
+               LIMIT_W, prio_name[prio], r.iron_s, r.gun_s, r.overlap_ns / (double)HOST_NS_PER_MS);
+
+        // 优先的一路几乎不慢, 让的一路慢也有限; FAIR 两路都按让的算
+        double seq_s = (base.iron_s + base.gun_s) * YIELD_FACTOR;
+        double iron_max_s = seq_s, gun_max_s = seq_s;
+        if (prio == PWR_PRIO_IRON) iron_max_s = base.iron_s + FAVORED_SLACK_S;
+        if (prio == PWR_PRIO_GUN)  gun_max_s  = base.gun_s + FAVORED_SLACK_S;
+        if (r.overlap_ns != 0 || r.iron_s < 0 || r.gun_s < 0 || r.iron_s > iron_max_s || r.gun_s > gun_max_s) {
+            printf("power_arb: FAIL\n");
+            fail = 1;
+        }
+    }
+
+    for (int prio = 0; prio < PWR_PRIO_COUNT; prio++) {
+        int32_t cmin, cmax;
+        Run_Carry(prio, &cmin, &cmax);
+        printf("power_arb: %-4s first, %d slots: iron_carry %ld..%ld (bound 0..%d)\n",
+               prio_name[prio], CARRY_SLOTS, (long)cmin, (long)cmax, IRON_PWM_MAX);
+        if (cmin < 0 || cmax > IRON_PWM_MAX) {
+            printf("power_arb: FAIL, iron_carry out of bound\n");
+            fail = 1;
+        }
+    }
+    return fail;
+}
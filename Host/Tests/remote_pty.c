@@ -0,0 +1,394 @@
+#define _GNU_SOURCE
+#include "host.h"
+#include "remote.h"
+#include "telemetry.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// ============================================================
+//  远程命令协议: 经伪终端的回环 (user-017)
+// ============================================================
+// 整机在本进程里按实时节拍跑, 串口接到一对 pty 的主端:
+//   固件发出的原始字节 (Host_SetTxHook) 写进主端, 主端读到的字节交给 Host_UartRx。
+// 子进程当上位机: 打开从端 (raw), 和 Misc/remote.py 一样先发 0x00 唤醒、隔 2ms 再发帧,
+// 自己做 COBS + CRC16 (不借用固件的代码), 检查:
+//   1. PING 的版本号 (开机过程中没应答就重发)
+//   2. 每个字段 GET, 再原值 SET 回去, 应答的值一致
+//   3. SET 写入 / 越界不写 / 未知字段 / 未知命令 / 负载长度不对 各自的状态码
+//   4. CRC 错的帧没有应答, 之后的帧照常; 一帧逐字节隔 1ms 发 (跨多次 IDLE) 照样收全
+//   5. STREAM 改采样帧周期, 1 秒内收到的采样帧数对得上; 周期 0 时不再有采样帧
+//   6. SAVE
+// 往返时间用墙上时间量 (仿真被拉到实时, 两者一致)。
+
+int app_main(void);
+
+#define TIMEOUT_MS      300
+#define BOOT_TRIES      50
+#define STREAM_MS       50
+#define RUN_LIMIT_S     60      // 子进程卡住时到点判失败
+
+// ------------------------------------------------------------
+//  上位机 (子进程)
+// ------------------------------------------------------------
+static int    cli_fd;
+static int    cli_fail = 0;
+static double rtt_max = 0, rtt_sum = 0;
+static int    rtt_n = 0;
+static int    samples = 0;
+
+static double Wall_Ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void Sleep_Ms(double ms)
+{
+    struct timespec ts = { (time_t)(ms / 1000), (long)((ms - (time_t)(ms / 1000) * 1000) * 1e6) };
+    nanosleep(&ts, NULL);
+}
+
+static uint16_t Crc16(const uint8_t *d, size_t n)
+{
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc ^= (uint16_t)(*d++) << 8;
+        for (int i = 0; i < 8; i++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+// cmd + payload + CRC -> 0x00 COBS 0x00
+static size_t Encode(uint8_t cmd, const uint8_t *payload, size_t len, bool bad_crc, uint8_t *out)
+{
+    uint8_t raw[64];
+    size_t n = 0, o = 0;
+
+    raw[n++] = cmd;
+    memcpy(&raw[n], payload, len);
+    n += len;
+    uint16_t crc = Crc16(raw, n) ^ (bad_crc ? 0x5A5A : 0);
+    raw[n++] = (uint8_t)crc;
+    raw[n++] = (uint8_t)(crc >> 8);
+
+    out[o++] = 0;
+    size_t code_at = o++;
+    uint8_t code = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (raw[i] == 0) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        } else {
+            out[o++] = raw[i];
+            if (++code == 0xFF) {
+                out[code_at] = code;
+                code_at = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_at] = code;
+    out[o++] = 0;
+    return o;
+}
+
+static bool Decode(const uint8_t *in, size_t n, uint8_t *type, uint8_t *payload, size_t *len)
+{
+    uint8_t raw[300];
+    size_t m = 0, i = 0;
+
+    while (i < n) {
+        uint8_t code = in[i++];
+        if (code == 0) return false;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= n) return false;
+            raw[m++] = in[i++];
+        }
+        if (code < 0xFF && i < n) raw[m++] = 0;
+    }
+    if (m < 3 || Crc16(raw, m - 2) != (uint16_t)(raw[m - 2] | (raw[m - 1] << 8))) return false;
+    *type = raw[0];
+    *len = m - 3;
+    memcpy(payload, &raw[1], *len);
+    return true;
+}
+
+// 读帧直到 want 类型的应答或超时; 途中的采样帧计数, 文本帧忽略。返回负载长度, 超时 -1
+static int Recv(uint8_t want, uint8_t *payload, int timeout_ms)
+{
+    static uint8_t acc[512];
+    static size_t  acc_len = 0;
+    double end = Wall_Ms() + timeout_ms;
+
+    for (;;) {
+        int left = (int)(end - Wall_Ms());
+        if (left <= 0) return -1;
+        struct pollfd p = { cli_fd, POLLIN, 0 };
+        if (poll(&p, 1, left) <= 0) continue;
+        uint8_t buf[256];
+        ssize_t n = read(cli_fd, buf, sizeof(buf));
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] != 0) {
+                if (acc_len < sizeof(acc)) acc[acc_len++] = buf[i];
+                continue;
+            }
+            uint8_t type;
+            size_t len;
+            bool ok = acc_len && Decode(acc, acc_len, &type, payload, &len);
+            acc_len = 0;
+            if (!ok) continue;
+            if (type == TELEM_TYPE_SAMPLE) samples++;
+            if (type == want) {
+                // 同一次 read 里剩下的字节留给下一次 (应答后面紧跟的采样帧)
+                for (ssize_t k = i + 1; k < n; k++) {
+                    if (acc_len < sizeof(acc)) acc[acc_len++] = buf[k];
+                }
+                return (int)len;
+            }
+        }
+    }
+}
+
+static void Send_Raw(const uint8_t *f, size_t n, bool slow)
+{
+    // 唤醒字节, 同 remote.py
+    (void)!write(cli_fd, f, 1);
+    Sleep_Ms(2);
+    if (!slow) {
+        (void)!write(cli_fd, f, n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        (void)!write(cli_fd, &f[i], 1);
+        Sleep_Ms(1);
+    }
+}
+
+// 发命令等应答, 返回状态码 (超时 -1)
+static int Request(uint8_t cmd, const uint8_t *payload, size_t len, uint8_t *rsp, int *rsp_len, bool slow)
+{
+    uint8_t f[80];
+    uint8_t buf[300];
+    size_t n = Encode(cmd, payload, len, false, f);
+    double t0 = Wall_Ms();
+
+    Send_Raw(f, n, slow);
+    int m = Recv(cmd | REMOTE_RSP, buf, TIMEOUT_MS);
+    if (m < 1) return -1;
+    double rtt = Wall_Ms() - t0;
+    if (!slow) {
+        if (rtt > rtt_max) rtt_max = rtt;
+        rtt_sum += rtt;
+        rtt_n++;
+    }
+    if (rsp) memcpy(rsp, &buf[1], m - 1);
+    if (rsp_len) *rsp_len = m - 1;
+    return buf[0];
+}
+
+static void Expect(bool ok, const char *what)
+{
+    if (ok) return;
+    printf("remote_pty: FAIL, %s\n", what);
+    cli_fail = 1;
+}
+
+static int32_t Le32(const uint8_t *p)
+{
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static int Set(uint8_t id, int32_t v, int32_t *got, bool slow)
+{
+    uint8_t p[5] = { id, (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    uint8_t rsp[16];
+    int n = 0;
+    int st = Request(REMOTE_CMD_SET, p, sizeof(p), rsp, &n, slow);
+    if (got && st == REMOTE_OK && n >= 5) *got = Le32(&rsp[1]);
+    return st;
+}
+
+static int Get(uint8_t id, int32_t *got)
+{
+    uint8_t rsp[16];
+    int n = 0;
+    int st = Request(REMOTE_CMD_GET, &id, 1, rsp, &n, false);
+    if (got && st == REMOTE_OK && n >= 5) *got = Le32(&rsp[1]);
+    return st;
+}
+
+static int Stream(uint16_t period_ms)
+{
+    uint8_t p[2] = { (uint8_t)period_ms, (uint8_t)(period_ms >> 8) };
+    return Request(REMOTE_CMD_STREAM, p, sizeof(p), NULL, NULL, false);
+}
+
+// 收 ms 毫秒内的所有帧, 返回其中的采样帧数
+static int Count_Samples(int ms)
+{
+    uint8_t buf[300];
+    int before = samples;
+    Recv(0xFF, buf, ms);
+    return samples - before;
+}
+
+static int Client(const char *slave)
+{
+    cli_fd = open(slave, O_RDWR | O_NOCTTY);
+    if (cli_fd < 0) return 2;
+
+    uint8_t rsp[16];
+    int n = 0, st = -1, tries;
+    for (tries = 1; tries <= BOOT_TRIES && st != REMOTE_OK; tries++) {
+        st = Request(REMOTE_CMD_PING, NULL, 0, rsp, &n, false);
+    }
+    printf("remote_pty: PING answered after %d tries, version %d\n", tries - 1, (st == REMOTE_OK && n >= 1) ? rsp[0] : -1);
+    if (st != REMOTE_OK || n < 1 || rsp[0] != REMOTE_PROTO_VERSION) return 1;
+    rtt_max = rtt_sum = 0;
+    rtt_n = 0;
+
+    // 先停掉默认的 10ms 采样帧, 后面单独测
+    Expect(Stream(0) == REMOTE_OK, "STREAM 0");
+
+    // 每个字段: GET, 原值 SET 回去
+    int fields_ok = 0;
+    for (uint8_t id = 0; id < REMOTE_F_COUNT; id++) {
+        int32_t v = 0, w = 0x7FFFFFFF;
+        if (Get(id, &v) == REMOTE_OK && Set(id, v, &w, false) == REMOTE_OK && w == v) fields_ok++;
+        else printf("remote_pty: field %u: GET/SET round trip failed\n", id);
+    }
+    printf("remote_pty: %d of %d fields GET + SET round trip\n", fields_ok, REMOTE_F_COUNT);
+    Expect(fields_ok == REMOTE_F_COUNT, "field round trip");
+
+    // 写入 / 越界 / 错误
+    int32_t t0 = 0, v = 0;
+    Expect(Get(REMOTE_F_IRON_TARGET, &t0) == REMOTE_OK, "GET iron target");
+    Expect(Set(REMOTE_F_IRON_TARGET, t0 + 20, &v, false) == REMOTE_OK && v == t0 + 20, "SET iron target");
+    Expect(Get(REMOTE_F_IRON_TARGET, &v) == REMOTE_OK && v == t0 + 20, "GET after SET");
+    Expect(Set(REMOTE_F_IRON_TARGET, 9999, NULL, false) == REMOTE_ERR_RANGE, "out of range SET");
+    Expect(Get(REMOTE_F_IRON_TARGET, &v) == REMOTE_OK && v == t0 + 20, "value kept after rejected SET");
+    Expect(Get(REMOTE_F_COUNT, NULL) == REMOTE_ERR_FIELD, "unknown field");
+    Expect(Request(0x3F, NULL, 0, NULL, NULL, false) == REMOTE_ERR_CMD, "unknown command");
+    Expect(Request(REMOTE_CMD_GET, NULL, 0, NULL, NULL, false) == REMOTE_ERR_LEN, "GET without payload");
+
+    // CRC 错: 没有应答, 下一帧照常
+    uint8_t f[80], buf[300];
+    uint8_t id = REMOTE_F_IRON_TARGET;
+    size_t fn = Encode(REMOTE_CMD_GET, &id, 1, true, f);
+    Send_Raw(f, fn, false);
+    Expect(Recv(REMOTE_CMD_GET | REMOTE_RSP, buf, TIMEOUT_MS) < 0, "answer to a frame with bad CRC");
+    Expect(Request(REMOTE_CMD_PING, NULL, 0, NULL, NULL, false) == REMOTE_OK, "PING after bad CRC");
+
+    // 逐字节发 (PID 参数在线改)
+    int32_t kp = 0;
+    Expect(Get(REMOTE_F_GUN_KP, &kp) == REMOTE_OK, "GET gun Kp");
+    Expect(Set(REMOTE_F_GUN_KP, kp + 0x8000, &v, true) == REMOTE_OK && v == kp + 0x8000, "byte-by-byte SET");
+    Expect(Get(REMOTE_F_GUN_KP, &v) == REMOTE_OK && v == kp + 0x8000, "GET after byte-by-byte SET");
+
+    // 采样帧周期
+    Expect(Stream(STREAM_MS) == REMOTE_OK, "STREAM");
+    Count_Samples(200);
+    int got = Count_Samples(1000);
+    Expect(Stream(0) == REMOTE_OK, "STREAM 0");
+    Count_Samples(100);
+    int after = Count_Samples(500);
+    printf("remote_pty: STREAM %d ms: %d sample frames in 1 s; after STREAM 0: %d in 0.5 s\n", STREAM_MS, got, after);
+    Expect(got >= 1000 / STREAM_MS - 2 && got <= 1000 / STREAM_MS + 2, "sample frame rate");
+    Expect(after == 0, "sample frames after STREAM 0");
+
+    Expect(Request(REMOTE_CMD_SAVE, NULL, 0, NULL, NULL, false) == REMOTE_OK, "SAVE");
+
+    printf("remote_pty: %d requests, round trip mean %.1f ms, max %.1f ms\n", rtt_n, rtt_sum / rtt_n, rtt_max);
+    close(cli_fd);
+    return cli_fail;
+}
+
+// ------------------------------------------------------------
+//  整机 (本进程)
+// ------------------------------------------------------------
+static int    pty_fd;
+static pid_t  cli_pid;
+static double wall_start;
+static uint32_t flash_programs;
+
+static void Tx_To_Pty(const uint8_t *data, size_t len)
+{
+    // 从端没在读时写满就丢, COBS 在下一个 0x00 重新同步
+    (void)!write(pty_fd, data, len);
+}
+
+static void Tick(uint32_t now_ms)
+{
+    uint8_t buf[256];
+    ssize_t n;
+
+    while ((n = read(pty_fd, buf, sizeof(buf))) > 0) Host_UartRx(buf, (size_t)n);
+
+    // 仿真比实时快就等
+    double ahead = now_ms - (Wall_Ms() - wall_start);
+    if (ahead > 0) Sleep_Ms(ahead);
+
+    int status;
+    if (waitpid(cli_pid, &status, WNOHANG) == cli_pid) {
+        int rc = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+        flash_programs = Host_GetStats()->flash_programs;
+        printf("remote_pty: simulated %.1f s, %u flash programs after SAVE\n", now_ms / 1000.0, flash_programs);
+        if (rc) printf("remote_pty: FAIL\n");
+        Host_Exit(rc);
+    }
+    if (now_ms >= RUN_LIMIT_S * 1000) {
+        kill(cli_pid, SIGKILL);
+        waitpid(cli_pid, &status, 0);
+        printf("remote_pty: FAIL, client did not finish within %d s\n", RUN_LIMIT_S);
+        Host_Exit(1);
+    }
+}
+
+int main(void)
+{
+    pty_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_fd < 0 || grantpt(pty_fd) != 0 || unlockpt(pty_fd) != 0) {
+        printf("remote_pty: FAIL, no pseudo-terminal\n");
+        return 1;
+    }
+    const char *slave = ptsname(pty_fd);
+
+    // 从端设成 raw (不转换换行, 不回显), 先打开一次设好再交给子进程
+    int s = open(slave, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (s < 0 || tcgetattr(s, &tio) != 0) {
+        printf("remote_pty: FAIL, cannot open %s\n", slave);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(s, TCSANOW, &tio);
+
+    fflush(stdout);
+    cli_pid = fork();
+    if (cli_pid == 0) {
+        close(pty_fd);
+        int rc = Client(slave);
+        fflush(stdout);
+        _exit(rc);
+    }
+    close(s);
+    fcntl(pty_fd, F_SETFL, fcntl(pty_fd, F_GETFL) | O_NONBLOCK);
+
+    Host_Init();
+    Host_SetQuiet(true);
+    Host_SetTxHook(Tx_To_Pty);
+    Host_SetTickHook(Tick, 1);
+    wall_start = Wall_Ms();
+    app_main();
+    return 1;
+}
@@ -0,0 +1,136 @@
+#include "host.h"
+#include "settings.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ============================================================
+//  设置日志: 一年的擦写次数 + 每次保存中途掉电 (user-006)
+// ============================================================
+// 模拟一年 365 天, 每天改 SAVES_PER_DAY 次设定温度, 每次都调 Settings_Save,
+// 用 Flash 钩子按页统计擦除次数, 和原来 "每次保存擦一次同一页" 比较。
+// 每次保存之前先 fork 一个子进程做同一次保存, 在第 cut 个字 (擦除和编程按顺序连起来数) 掉电,
+// 子进程写回镜像后退出; 父进程读入掉电后的镜像重新 Settings_Load,
+// 结果必须是保存前或保存后的值, 不能丢回出厂设置, 然后恢复自己的镜像继续。
+
+#define DAYS            365
+#define SAVES_PER_DAY   12
+#define PAGE_WORDS      (SETTINGS_PAGE_SIZE / 4)
+#define RING_BYTES      (SETTINGS_RING_PAGES * SETTINGS_PAGE_SIZE)
+
+static uint32_t erases[SETTINGS_RING_PAGES];
+static uint32_t programs;
+static uint32_t cut_at;         // 子进程: 第几个字掉电
+static uint32_t cut_done;       // 子进程: 已完成的字数
+
+static uint32_t Count_Hook(bool erase, uint32_t addr, uint32_t words)
+{
+    uint32_t page = (addr - FLASH_USER_START_ADDR) / SETTINGS_PAGE_SIZE;
+
+    if (erase && page < SETTINGS_RING_PAGES) erases[page]++;
+    if (!erase) programs++;
+    return words;
+}
+
+static uint32_t Cut_Hook(bool erase, uint32_t addr, uint32_t words)
+{
+    (void)erase;
+    (void)addr;
+    if (cut_done + words > cut_at) return cut_at - cut_done;
+    cut_done += words;
+    return words;
+}
+
+static uint32_t rng = 2024;
+
+static uint32_t Rand(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return rng >> 16;
+}
+
+int main(void)
+{
+    static uint8_t ring[RING_BYTES];
+    char path[64];
+    uint32_t saves = 0, cuts = 0, kept_old = 0, got_new = 0, bad = 0;
+
+    Host_Init();
+    Host_SetQuiet(true);
+    snprintf(path, sizeof(path), "/tmp/settings_journal.%d.bin", (int)getpid());
+    unlink(path);
+    Host_FlashLoad(path);       // 子进程掉电时把镜像写到这里
+    Host_SetFlashHook(Count_Hook);
+    Settings_Load();
+
+    for (uint32_t i = 0; i < DAYS * SAVES_PER_DAY; i++) {
+        uint16_t old = sys_settings.iron_target;
+        uint16_t now = old;
+        while (now == old) now = (uint16_t)(200 + Rand() % 251);
+
+        // 掉电的那个子进程: 擦除 (如果要擦) 一页 + 编程一页, 掉电点在其中轮流
+        pid_t pid = Host_Fork();
+        if (pid == 0) {
+            cut_at = (i * 7) % (2 * PAGE_WORDS);
+            cut_done = 0;
+            Host_SetFlashHook(Cut_Hook);
+            sys_settings.iron_target = now;
+            Settings_Save();
+            _exit(0);           // 掉电点在没做的擦除里: 保存正常完成
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 5) {
+            cuts++;
+            memcpy(ring, (const void *)FLASH_USER_START_ADDR, RING_BYTES);
+            Host_FlashLoad(path);
+            Settings_Load();
+            if (sys_settings.iron_target == old) {
+                kept_old++;
+            } else if (sys_settings.iron_target == now) {
+                got_new++;
+            } else {
+                bad++;
+                printf("settings_journal: save %u cut at word %u: loaded %u, expected %u or %u\n",
+                       i, (i * 7) % (2 * PAGE_WORDS), sys_settings.iron_target, old, now);
+            }
+            memcpy((void *)FLASH_USER_START_ADDR, ring, RING_BYTES);
+            Settings_Load();
+        } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("settings_journal: child for save %u died (status 0x%x)\n", i, status);
+            bad++;
+        }
+
+        sys_settings.iron_target = now;
+        Settings_Save();
+        saves++;
+    }
+    unlink(path);
+
+    // 最后再读一次, 必须是最后保存的值
+    uint16_t last = sys_settings.iron_target;
+    Settings_Load();
+    if (sys_settings.iron_target != last) {
+        printf("settings_journal: reload gave %u, last saved %u\n", sys_settings.iron_target, last);
+        bad++;
+    }
+
+    uint32_t max_erase = 0, total_erase = 0;
+    for (int p = 0; p < SETTINGS_RING_PAGES; p++) {
+        total_erase += erases[p];
+        if (erases[p] > max_erase) max_erase = erases[p];
+    }
+    printf("settings_journal: %u saves in %d days, %u page programs, %u erases (max %u on one page); "
+           "erase-per-save would be %u on one page\n",
+           saves, DAYS, programs, total_erase, max_erase, saves);
+    printf("settings_journal: %u power cuts: %u kept the old record, %u already had the new one, %u bad\n",
+           cuts, kept_old, got_new, bad);
+    // 磨损均衡: 每页最多多擦一次
+    if (max_erase > saves / SETTINGS_RING_PAGES + 1) {
+        printf("settings_journal: FAIL, erases not spread over the ring\n");
+        bad++;
+    }
+    return bad ? 1 : 0;
+}
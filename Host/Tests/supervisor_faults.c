@@ -0,0 +1,143 @@
+#include "host.h"
+#include "gun_logic.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================
+//  安全监控: 整机运行中注入故障 (user-019)
+// ============================================================
+// 烙铁和风枪同时开着, 都稳在设定温度后 (INJECT_AT_S) 注入一类故障, 每类一个子进程:
+//   iron_tc_open     - 热电偶断线, 读数顶满量程            -> RAIL (或硬件超温切断)
+//   iron_tc_short    - 热电偶短路, 读数停在室温, PID 全功率 -> RUNAWAY
+//   iron_heater_open - 发热芯断路, 全功率温度只降不升       -> RUNAWAY
+//   adc_frozen       - DMA 停了, 和值不再变化              -> STUCK
+//   gun_tc_open      - 风枪热电偶断线                       -> RAIL (或硬件超温切断)
+// 每类都要求:
+//   1. 注入后 bound_ms 内出现跳闸 (固件打印 "... TRIP!"), 门限按 main.c.bkup 的 sup_*_lim 加两个监控周期
+//   2. 跳闸 OFF_MS 之后两路加热的导通时间都不再增加, 一直到 HOLD_S 结束
+//   3. 故障锁存: 结束时风枪在 ERROR
+//   4. 全程没有看门狗复位
+
+#define INJECT_AT_S     40
+#define HOLD_S          5       // 跳闸后继续观察
+#define OFF_MS          20      // 跳闸后加热必须停下 (一个控制周期 + 半个市电周期)
+#define SUP_PERIOD_MS   100     // 同 main.c.bkup SUPERVISOR_PERIOD_MS
+#define SLACK_MS        (2 * SUP_PERIOD_MS)
+
+typedef struct {
+    const char *name;
+    bool       *flag;
+    uint32_t    bound_ms;
+} Fault_t;
+
+typedef struct {
+    bool     tripped;
+    bool     error;             // 风枪在 ERROR
+    uint32_t latency_ms;        // 注入 -> 跳闸
+    uint64_t heat_after_ns;     // 跳闸 OFF_MS 之后两路合计又导通了多久
+    uint32_t wdg_resets;
+    char     line[96];          // 跳闸那一行
+} Result_t;
+
+static Result_t res;
+static const Fault_t *cur;
+static int      fd;
+static uint32_t trip_ms = 0;
+static uint64_t heat_mark = 0;
+static bool     marked = false;
+
+static uint64_t Heat_Ns(void)
+{
+    const HostStats_t *s = Host_GetStats();
+    return s->iron_on_ns + s->gun_on_ns;
+}
+
+static void On_Text(uint32_t now_ms, const char *line)
+{
+    if (res.tripped || now_ms < INJECT_AT_S * 1000 || !strstr(line, "TRIP!")) return;
+    res.tripped = true;
+    res.latency_ms = now_ms - INJECT_AT_S * 1000;
+    trip_ms = now_ms;
+    snprintf(res.line, sizeof(res.line), "%s", line);
+}
+
+static void On_Watchdog(uint32_t now_ms)
+{
+    (void)now_ms;       // 只计数 (Host_GetStats), 不退出
+}
+
+static void On_Tick(uint32_t now_ms)
+{
+    if (now_ms == INJECT_AT_S * 1000) *cur->flag = true;
+
+    if (res.tripped && !marked && now_ms >= trip_ms + OFF_MS) {
+        heat_mark = Heat_Ns();
+        marked = true;
+    }
+    bool done = marked && now_ms >= trip_ms + HOLD_S * 1000;
+    bool late = now_ms >= INJECT_AT_S * 1000 + cur->bound_ms + HOLD_S * 1000;
+    if (done || late) {
+        if (marked) res.heat_after_ns = Heat_Ns() - heat_mark;
+        res.error = (Gun_FSM_GetState() == GUN_STATE_ERROR);
+        res.wdg_resets = Host_GetStats()->wdg_resets;
+        (void)!write(fd, &res, sizeof(res));
+        Host_Exit(0);
+    }
+}
+
+static void Setup(void)
+{
+    Host_SetTextHook(On_Text);
+    Host_SetWatchdogHook(On_Watchdog);
+    Host_SetIronSwitch(true);
+    Host_SetGunSwitch(true);
+    Host_SetHandleUp(true);
+    Host_SetTickHook(On_Tick, 10);
+    Host_SetEnd((uint64_t)(INJECT_AT_S + HOLD_S + 1) * HOST_NS_PER_S + (uint64_t)cur->bound_ms * HOST_NS_PER_MS);
+}
+
+static int Run(const Fault_t *f, Result_t *out)
+{
+    cur = f;
+    return Host_RunFirmware(Setup, &fd, out, sizeof(*out));
+}
+
+int main(void)
+{
+    // 门限: RAIL 去抖 300ms, STUCK 5s, RUNAWAY 窗口 15s (烙铁); 发热芯断路先要等温度掉下来 PID 才到满载 (约 1.5s)
+    const Fault_t faults[] = {
+        { "iron_tc_open",     &host_plant.iron_tc_open,     300 + SLACK_MS },
+        { "iron_tc_short",    &host_plant.iron_tc_short,    15000 + SLACK_MS },
+        { "iron_heater_open", &host_plant.iron_heater_open, 15000 + 3000 },
+        { "adc_frozen",       &host_plant.adc_frozen,       5000 + SLACK_MS },
+        { "gun_tc_open",      &host_plant.gun_tc_open,      300 + SLACK_MS },
+    };
+    int fail = 0;
+
+    for (unsigned i = 0; i < sizeof(faults) / sizeof(faults[0]); i++) {
+        const Fault_t *f = &faults[i];
+        Result_t r;
+
+        if (Run(f, &r) != 0) {
+            printf("supervisor_faults: %-16s FAIL, firmware run did not finish\n", f->name);
+            fail = 1;
+            continue;
+        }
+        if (!r.tripped) {
+            printf("supervisor_faults: %-16s no trip within %lu ms", f->name, (unsigned long)f->bound_ms);
+        } else {
+            printf("supervisor_faults: %-16s trip after %5lu ms (bound %5lu), heat after trip %llu us, %s",
+                   f->name, (unsigned long)r.latency_ms, (unsigned long)f->bound_ms,
+                   (unsigned long long)(r.heat_after_ns / HOST_NS_PER_US), r.error ? "gun ERROR" : "gun not ERROR");
+        }
+        printf(", %lu watchdog reset(s)\n", (unsigned long)r.wdg_resets);
+        if (r.tripped) printf("supervisor_faults:   \"%s\"\n", r.line);
+
+        if (!r.tripped || r.latency_ms > f->bound_ms || r.heat_after_ns != 0 || !r.error || r.wdg_resets != 0) {
+            printf("supervisor_faults: FAIL\n");
+            fail = 1;
+        }
+    }
+    return fail;
+}
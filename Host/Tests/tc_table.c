@@ -0,0 +1,56 @@
+#include "host.h"
+#include "thermocouple.h"
+#include <math.h>
+#include <stdio.h>
+
+// ============================================================
+//  热电偶分度表 vs NIST 参考多项式 (user-007)
+// ============================================================
+// 对每个 ADC 码, 按 thermocouple.h 的放大电路 (TC_AMP_GAIN, TC_VREF_MV, 冷端 TC_CJ_UV)
+// 算出热电势, 再用 Plant_TcMicrovolts (NIST ITS-90 多项式) 二分反解出温度,
+// 和 TC_AdcToTenths 的查表结果比较。覆盖 600°C 以下的全部 ADC 码 (码 0 = 冷端温度, 约 25°C)。
+
+#define MAX_ERR_C       0.5     // 折线误差 + 截断, 不含 ADC 本身的量化
+
+// 热电势 (uV, 冷端 0°C) -> 温度, 多项式在 0~1372°C 单调
+static double Reference_C(double uv)
+{
+    double lo = 0, hi = 1372;
+    for (int i = 0; i < 60; i++) {
+        double mid = (lo + hi) / 2;
+        if (Plant_TcMicrovolts(mid) < uv) lo = mid;
+        else hi = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+int main(void)
+{
+    double max_err = 0, sum_err = 0;
+    int    worst = 0, n = 0;
+
+    for (int code = 0; code < 4096; code++) {
+        double uv = code * (TC_VREF_MV * 1000.0) / (TC_AMP_GAIN * 4096.0) + TC_CJ_UV;
+        double ref = Reference_C(uv);
+        if (ref > 600) break;
+
+        double got = TC_AdcToTenths((uint16_t)code) / 10.0;
+        double err = fabs(got - ref);
+        sum_err += err;
+        n++;
+        if (err > max_err) {
+            max_err = err;
+            worst = code;
+        }
+    }
+
+    double uv = worst * (TC_VREF_MV * 1000.0) / (TC_AMP_GAIN * 4096.0) + TC_CJ_UV;
+    printf("tc_table: %d ADC codes (%.1f..600 C), max error %.3f C at code %d (%.2f C), mean %.3f C\n",
+           n, Reference_C(TC_CJ_UV), max_err, worst, Reference_C(uv), sum_err / n);
+
+    if (max_err > MAX_ERR_C) {
+        printf("tc_table: FAIL (limit %.1f C)\n", MAX_ERR_C);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+##### Host simulation #####
+#
+# 'make host-sim'  : 固件原样编译成 Linux 程序 (主循环 + 全部 User 模块), 配 mock HAL 和热模型
+# 'make host-test' : 编译并运行 Host/Tests 下的每个测试 (每个 .c 一个程序, 返回 0 = 通过)
+#
+# 外设寄存器映射在芯片原地址, 需要 64 位 Linux, 非 PIE 链接 (固件把静态缓冲区地址转成 uint32_t)
+
+HOST_CC		?= gcc
+HOST_BDIR	= $(BDIR)/host
+
+HOST_INCLUDES	:= Host/Inc \
+		Libraries/CMSIS/Core/Include \
+		Libraries/CMSIS/Device/PY32F0xx/Include \
+		User \
+		Libraries/PY32F0xx_HAL_Driver/Inc \
+		Libraries/PY32F0xx_HAL_BSP/Inc
+
+# 头文件里的 ~xxUL 在 64 位下是 64 位常量, 赋给 32 位寄存器会报 -Woverflow (截断正是想要的)
+HOST_CFLAGS	?= -std=gnu17 -O2 -g -Wall -fno-pie \
+		-DPY32F030x8 -DUSE_HAL_DRIVER \
+		-Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -Wno-overflow
+HOST_INCFLAGS	:= $(addprefix -I $(TOP)/, $(HOST_INCLUDES))
+# 固件源文件额外: 引脚写入交给仿真, printf 走固件自己的 _write
+HOST_FWFLAGS	:= -include $(TOP)/Host/Inc/host_board.h -Dprintf=Host_FwPrintf -U_FORTIFY_SOURCE
+HOST_LDFLAGS	?= -no-pie -lm
+
+# User/main.c 是数码管测试程序, 整机主循环在 main.c.bkup (main 改名为 app_main)
+HOST_FW_SRC	:= $(filter-out $(TOP)/User/main.c, $(wildcard $(TOP)/User/*.c))
+HOST_FW_OBJS	:= $(HOST_FW_SRC:$(TOP)/%.c=$(HOST_BDIR)/%.o) $(HOST_BDIR)/User/main_app.o
+HOST_SIM_OBJS	:= $(patsubst $(TOP)/%.c,$(HOST_BDIR)/%.o, \
+		$(filter-out $(TOP)/Host/Src/host_main.c, $(wildcard $(TOP)/Host/Src/*.c)))
+HOST_TESTS	:= $(patsubst $(TOP)/Host/Tests/%.c,$(HOST_BDIR)/Tests/%, $(wildcard $(TOP)/Host/Tests/*.c))
+
+.PHONY: host-sim host-test
+# 测试的 .o 不当中间文件删掉
+.SECONDARY: $(HOST_TESTS:$(HOST_BDIR)/Tests/%=$(HOST_BDIR)/Host/Tests/%.o)
+
+host-sim: $(HOST_BDIR)/host-sim
+
+host-test: $(HOST_TESTS)
+	@set -e; for t in $(HOST_TESTS); do \
+		printf "  TEST\t$$t\n"; \
+		$$t; \
+	done
+
+-include $(HOST_FW_OBJS:.o=.d) $(HOST_SIM_OBJS:.o=.d)
+
+$(HOST_BDIR)/User/%.o: User/%.c
+	@printf "  HOSTCC\t$<\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(HOST_CC) $(HOST_CFLAGS) $(HOST_FWFLAGS) $(HOST_INCFLAGS) -o $@ -c $< -MMD -MP
+
+$(HOST_BDIR)/User/main_app.o: User/main.c.bkup
+	@printf "  HOSTCC\t$<\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(HOST_CC) $(HOST_CFLAGS) $(HOST_FWFLAGS) -Dmain=app_main $(HOST_INCFLAGS) -o $@ -c -x c $< -MMD -MP
+
+$(HOST_BDIR)/Host/%.o: Host/%.c
+	@printf "  HOSTCC\t$<\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(HOST_CC) $(HOST_CFLAGS) $(HOST_INCFLAGS) -I $(TOP)/Host/Src -o $@ -c $< -MMD -MP
+
+$(HOST_BDIR)/host-sim: $(HOST_FW_OBJS) $(HOST_SIM_OBJS) $(HOST_BDIR)/Host/Src/host_main.o
+	@printf "  HOSTLD\t$@\n"
+	$(Q)$(HOST_CC) -o $@ $^ $(HOST_LDFLAGS)
+
+$(HOST_BDIR)/Tests/%: $(HOST_BDIR)/Host/Tests/%.o $(HOST_FW_OBJS) $(HOST_SIM_OBJS)
+	@printf "  HOSTLD\t$@\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(HOST_CC) -o $@ $^ $(HOST_LDFLAGS)
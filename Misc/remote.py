@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+Send commands to the station over the debug UART (User/remote.h).
+
+    python3 remote.py /dev/ttyUSB0 ping
+    python3 remote.py /dev/ttyUSB0 get iron_kp
+    python3 remote.py /dev/ttyUSB0 set gun_airflow 80
+    python3 remote.py /dev/ttyUSB0 set standby_min 5   # iron standby after 5 idle minutes, 0 = never
+    python3 remote.py /dev/ttyUSB0 save
+    python3 remote.py /dev/ttyUSB0 stream 100     # sample frame every 100 ms, 0 = off
+    python3 remote.py /dev/ttyUSB0 dump           # get every field
+    python3 remote.py /dev/ttyUSB0 segment 2 240 30 20   # gun profile segment: temp C, ramp s, hold s
+    python3 remote.py /dev/ttyUSB0 profile run    # gun must be heating; "profile stop" to cancel
+    python3 remote.py /dev/ttyUSB0 counters       # hardware/comparator overtemp trips, dropped telemetry frames
+
+Requests and responses use the telemetry framing (see telemetry_decode.py).
+Sample/text frames arriving while waiting for a response are skipped.
+"""
+import struct
+import sys
+import time
+
+import serial
+
+from telemetry_decode import BAUDRATE, cobs_decode, crc16
+
+CMD_PING, CMD_GET, CMD_SET, CMD_SAVE, CMD_STREAM, CMD_PROFILE, CMD_SEGMENT, CMD_COUNTERS = range(0x20, 0x28)
+RSP = 0x80
+WAKE_DELAY = 0.002  # s, STOP wakeup + HSI startup is well under this
+STATUS = ['ok', 'unknown command', 'bad length', 'unknown field', 'out of range', 'not allowed now']
+
+# Must match RemoteField_t
+FIELDS = ['iron_target', 'gun_target',
+          'iron_cal_gain', 'iron_cal_offset', 'gun_cal_gain', 'gun_cal_offset',
+          'iron_kp', 'iron_ki', 'iron_kd', 'gun_kp', 'gun_ki', 'gun_kd',
+          'gun_airflow', 'iron_ff', 'profile_segs', 'gun_fire_mode',
+          'power_limit', 'iron_watts', 'gun_watts', 'power_priority', 'iron_share',
+          'standby_min', 'off_min', 'standby_temp']
+Q16_FIELDS = {'iron_kp', 'iron_ki', 'iron_kd', 'gun_kp', 'gun_ki', 'gun_kd', 'iron_ff'}
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+    out[code_pos] = code
+    return bytes(out)
+
+
+def request(port, cmd, payload=b'', timeout=0.5):
+    raw = bytes([cmd]) + payload
+    # The station may be in STOP mode: the first byte only wakes it up and is lost.
+    # The leading delimiter then flushes whatever garbage that byte left behind.
+    port.write(b'\x00')
+    time.sleep(WAKE_DELAY)
+    port.write(b'\x00' + cobs_encode(raw + struct.pack('<H', crc16(raw))) + b'\x00')
+
+    buf = bytearray()
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        buf += port.read(port.in_waiting or 1)
+        while b'\x00' in buf:
+            enc, _, buf = buf.partition(b'\x00')
+            frame = cobs_decode(enc) if enc else None
+            if not frame or len(frame) < 4 or crc16(frame[:-2]) != struct.unpack('<H', frame[-2:])[0]:
+                continue
+            if frame[0] == cmd | RSP:
+                status, data = frame[1], frame[2:-2]
+                if status != 0:
+                    raise RuntimeError(STATUS[status] if status < len(STATUS) else 'status %d' % status)
+                return data
+    raise TimeoutError('no response to command 0x%02X' % cmd)
+
+
+def field_value(name, data):
+    value = struct.unpack('<i', data[1:5])[0]
+    return '%s = %d' % (name, value) + (' (%.4f)' % (value / 65536.0) if name in Q16_FIELDS else '')
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+
+    port = serial.Serial(sys.argv[1], BAUDRATE, timeout=0.05)
+    op, args = sys.argv[2], sys.argv[3:]
+
+    if op == 'ping':
+        print('protocol version %d' % request(port, CMD_PING)[0])
+    elif op == 'get':
+        print(field_value(args[0], request(port, CMD_GET, bytes([FIELDS.index(args[0])]))))
+    elif op == 'set':
+        name = args[0]
+        # Q16 fields accept a decimal value ("0.35")
+        value = round(float(args[1]) * 65536) if name in Q16_FIELDS and '.' in args[1] else int(args[1])
+        print(field_value(name, request(port, CMD_SET, struct.pack('<Bi', FIELDS.index(name), value))))
+    elif op == 'save':
+        request(port, CMD_SAVE, timeout=1.0)    # flash erase + program
+        print('saved')
+    elif op == 'stream':
+        print('stream period %d ms' % struct.unpack('<H', request(port, CMD_STREAM, struct.pack('<H', int(args[0]))))[0])
+    elif op == 'profile':
+        request(port, CMD_PROFILE, bytes([1 if args[0] == 'run' else 0]))
+        print('profile %s' % ('started' if args[0] == 'run' else 'stopped'))
+    elif op == 'segment':
+        payload = bytes([int(args[0])])
+        if len(args) == 4:
+            payload += struct.pack('<HHH', *(int(a) for a in args[1:4]))
+        idx, temp, ramp, hold = struct.unpack('<BHHH', request(port, CMD_SEGMENT, payload))
+        print('segment %d: %d C, ramp %d s, hold %d s' % (idx, temp, ramp, hold))
+    elif op == 'counters':
+        trips, dropped, comp = struct.unpack('<III', request(port, CMD_COUNTERS))
+        print('hw overtemp trips %d, comparator trips %d, telemetry frames dropped %d'
+              % (trips, comp, dropped))
+    elif op == 'dump':
+        for i, name in enumerate(FIELDS):
+            print(field_value(name, request(port, CMD_GET, bytes([i]))))
+    else:
+        print(__doc__)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Decode the binary telemetry stream (User/telemetry.h) from the debug UART.
+
+Frame: COBS( type[1] + payload[n] + CRC16-CCITT-FALSE[2, LE] ) + 0x00
+
+    python3 telemetry_decode.py /dev/ttyUSB0 samples.csv
+    python3 telemetry_decode.py capture.bin samples.csv   # raw capture file
+
+Text frames (printf) go to stdout, sample frames go to the CSV.
+"""
+import csv
+import struct
+import sys
+
+BAUDRATE = 460800
+
+TYPE_SAMPLE = 0x01
+TYPE_TEXT = 0x02
+
+# Must match TelemSample_t
+SAMPLE_FMT = '<IhhhhHHBBHHH'
+SAMPLE_FIELDS = ['t_us', 'iron_sp', 'iron_temp', 'gun_sp', 'gun_temp',
+                 'iron_pwm', 'gun_duty', 'gun_state', 'fan_percent', 'fan_rpm',
+                 'loop_latency_us', 'loop_exec_us']
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def open_source(path):
+    if path.startswith('/dev/') or path.upper().startswith('COM'):
+        import serial
+        return serial.Serial(path, BAUDRATE, timeout=1)
+    return open(path, 'rb')
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    src = open_source(sys.argv[1])
+    bad = 0
+    with open(sys.argv[2], 'w', newline='') as f:
+        w = csv.writer(f)
+        w.writerow(SAMPLE_FIELDS)
+        buf = bytearray()
+        text = ''
+        while True:
+            chunk = src.read(256)
+            if not chunk:
+                if not hasattr(src, 'in_waiting'):
+                    break
+                continue
+            buf += chunk
+            while b'\x00' in buf:
+                raw, _, buf = buf.partition(b'\x00')
+                frame = cobs_decode(raw) if raw else None
+                if frame is None or len(frame) < 3 or \
+                        crc16(frame[:-2]) != struct.unpack('<H', frame[-2:])[0]:
+                    bad += 1
+                    continue
+                ftype, payload = frame[0], frame[1:-2]
+                if ftype == TYPE_SAMPLE and len(payload) == struct.calcsize(SAMPLE_FMT):
+                    w.writerow(struct.unpack(SAMPLE_FMT, payload))
+                elif ftype == TYPE_TEXT:
+                    # printf output may be split across frames; reassemble by line
+                    text += payload.decode('utf-8', 'replace')
+                    while '\n' in text:
+                        line, text = text.split('\n', 1)
+                        print(line.rstrip('\r'))
+    print('bad frames: %d' % bad, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
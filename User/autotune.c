@@ -0,0 +1,155 @@
+#include "autotune.h"
+
+// 整数开方 (逐位法), 用于 sqrt(a² - ε²)
+static uint32_t isqrt32(uint32_t x)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+static q16_t Clamp_Gain(int64_t v, q16_t max)
+{
+    if (v < 0)   return 0;
+    if (v > max) return max;
+    return (q16_t)v;
+}
+
+void AutoTune_Start(AutoTune_t *at, int32_t setpoint, int32_t out_low, int32_t out_high, int32_t hyst, uint32_t now_ms)
+{
+    at->setpoint  = setpoint;
+    at->hyst      = hyst;
+    at->out_high  = out_high;
+    at->out_low   = out_low;
+
+    at->state      = AT_RUNNING;
+    at->relay_high = true;      // 一开始肯定低于设定点, 先加热
+    at->start_ms   = now_ms;
+    at->last_rise_ms = now_ms;
+    at->peak_max   = INT32_MIN;
+    at->peak_min   = INT32_MAX;
+    at->cycles     = 0;
+    at->sum_period_ms = 0;
+    at->sum_amp    = 0;
+    at->sum_out    = 0;
+    at->n_out      = 0;
+    at->mean_out   = 0;
+    at->Ku         = 0;
+    at->Tu_ms      = 0;
+}
+
+void AutoTune_Abort(AutoTune_t *at)
+{
+    at->state = AT_FAILED;
+}
+
+// 收尾: 由累计的周期/振幅算 Ku, Tu
+static void AutoTune_Finish(AutoTune_t *at)
+{
+    int32_t a = at->sum_amp / AT_MEASURE_CYCLES;
+    int32_t d = (at->out_high - at->out_low) / 2;
+
+    // 振幅必须大于回差, 否则公式无意义 (说明根本没振起来)
+    if (a <= at->hyst || d <= 0) {
+        at->state = AT_FAILED;
+        return;
+    }
+
+    uint32_t a_eff = isqrt32((uint32_t)(a * a - at->hyst * at->hyst));
+    if (a_eff == 0) a_eff = 1;
+
+    // Ku = 4d / (π a_eff), π 取 3.1416 (×10000 整数化)
+    at->Ku    = Clamp_Gain(((int64_t)4 * d * Q16_ONE * 10000) / (31416LL * a_eff), AT_GAIN_MAX);
+    at->Tu_ms = at->sum_period_ms / AT_MEASURE_CYCLES;
+    at->mean_out = at->n_out ? (int32_t)(at->sum_out / at->n_out) : 0;
+    at->state = (at->Tu_ms > 0) ? AT_DONE : AT_FAILED;
+}
+
+int32_t AutoTune_Run(AutoTune_t *at, int32_t measurement, uint32_t now_ms)
+{
+    if (at->state != AT_RUNNING) return at->out_low;
+
+    // 安全: 超时或温度冲得太高都直接放弃
+    if ((now_ms - at->start_ms) > AT_TIMEOUT_MS ||
+        measurement > at->setpoint + AT_OVERSHOOT_MAX) {
+        at->state = AT_FAILED;
+        return at->out_low;
+    }
+
+    if (measurement > at->peak_max) at->peak_max = measurement;
+    if (measurement < at->peak_min) at->peak_min = measurement;
+
+    if (at->relay_high) {
+        if (measurement > at->setpoint + at->hyst) {
+            at->relay_high = false;
+        }
+    } else if (measurement < at->setpoint - at->hyst) {
+        // 低 -> 高: 一个完整周期结束
+        at->relay_high = true;
+
+        if (at->cycles >= AT_SKIP_CYCLES) {
+            at->sum_period_ms += now_ms - at->last_rise_ms;
+            at->sum_amp       += (at->peak_max - at->peak_min) / 2;
+        }
+        at->cycles++;
+        at->last_rise_ms = now_ms;
+        at->peak_max = measurement;
+        at->peak_min = measurement;
+
+        if (at->cycles >= AT_SKIP_CYCLES + AT_MEASURE_CYCLES) {
+            AutoTune_Finish(at);
+            return at->out_low;
+        }
+    }
+
+    int32_t out = at->relay_high ? at->out_high : at->out_low;
+
+    // 丢弃周期之后开始统计平均输出 (从一个上升沿到最后一个上升沿, 正好是整周期)
+    if (at->cycles >= AT_SKIP_CYCLES) {
+        at->sum_out += (uint32_t)out;
+        at->n_out++;
+    }
+    return out;
+}
+
+// Ziegler–Nichols:  Kp = 0.6Ku,    Ti = Tu/2,   Td = Tu/8
+// Tyreus–Luyben:    Kp = Ku/2.2,   Ti = 2.2Tu,  Td = Tu/6.3
+// Ki = Kp/Ti, Kd = Kp*Td (Tu 以 ms 为单位参与整数运算)
+bool AutoTune_GetGains(const AutoTune_t *at, AT_Rule_t rule, q16_t *Kp, q16_t *Ki, q16_t *Kd)
+{
+    if (at->state != AT_DONE) return false;
+
+    int64_t ku = at->Ku;
+    int64_t tu = at->Tu_ms;
+
+    if (rule == AT_RULE_ZN) {
+        *Kp = Clamp_Gain(ku * 6 / 10, AT_GAIN_MAX);
+        *Ki = Clamp_Gain(ku * 1200 / tu, AT_GAIN_MAX);
+        *Kd = Clamp_Gain(ku * tu * 75 / 1000000, AT_KD_MAX);
+    } else {
+        *Kp = Clamp_Gain(ku * 10 / 22, AT_GAIN_MAX);
+        *Ki = Clamp_Gain(ku * 100000 / (484 * tu), AT_GAIN_MAX);
+        *Kd = Clamp_Gain(ku * tu / 13860, AT_KD_MAX);
+    }
+    return true;
+}
+
+bool AutoTune_GetFeedforward(const AutoTune_t *at, int32_t ambient, q16_t *ff)
+{
+    int32_t rise = at->setpoint - ambient;
+
+    if (at->state != AT_DONE || rise <= 0) return false;
+    *ff = Clamp_Gain(((int64_t)at->mean_out * Q16_ONE) / rise, AT_GAIN_MAX);
+    return true;
+}
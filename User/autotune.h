@@ -0,0 +1,74 @@
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iron_pid.h"
+
+// ============================================================
+//  继电反馈自整定 (Åström–Hägglund)
+// ============================================================
+// 用一个带回差的继电器代替 PID: 温度低于 (设定 - 回差) 输出高, 高于 (设定 + 回差) 输出低,
+// 系统会在设定点附近等幅振荡。测出振幅 a 和周期 Tu 后:
+//   Ku = 4d / (π * sqrt(a² - ε²))     d = 继电输出半幅, ε = 回差
+// 再按 Ziegler–Nichols 或 Tyreus–Luyben 公式折算成 PID 参数 (全部定点运算)。
+// 单位与 PIDQ_Compute 一致: 测量值 0.1°C, 输出为 PWM / 占空比计数。
+
+#define AT_SKIP_CYCLES      1       // 前几个周期是升温过渡, 丢弃
+#define AT_MEASURE_CYCLES   4       // 取平均的振荡周期数
+#define AT_TIMEOUT_MS       600000  // 10 分钟还没测完就放弃
+#define AT_OVERSHOOT_MAX    400     // 超过设定点 40°C 立即中止 (0.1°C)
+
+// 整定参数上限 (PIDQ_SetTunings 的 kdA 是 Q16, Kd 太大会溢出)
+#define AT_GAIN_MAX         Q16(1000.0)
+#define AT_KD_MAX           Q16(400.0)
+
+typedef enum {
+    AT_RULE_ZN = 0,         // Ziegler–Nichols 经典 PID: 响应快, 过冲较大
+    AT_RULE_TL              // Tyreus–Luyben: 更保守, 适合热惯量大的对象
+} AT_Rule_t;
+
+typedef enum {
+    AT_IDLE = 0,
+    AT_RUNNING,
+    AT_DONE,
+    AT_FAILED
+} AT_State_t;
+
+typedef struct {
+    // 配置
+    int32_t  setpoint;      // 0.1°C
+    int32_t  hyst;          // 回差 ε (0.1°C)
+    int32_t  out_high;      // 继电输出高
+    int32_t  out_low;       // 继电输出低
+
+    // 运行时
+    AT_State_t state;
+    bool     relay_high;
+    uint32_t start_ms;
+    uint32_t last_rise_ms;  // 上一次 低->高 切换时刻
+    int32_t  peak_max;      // 本周期最高温度
+    int32_t  peak_min;      // 本周期最低温度
+    uint8_t  cycles;        // 已完成的周期数 (含丢弃的)
+    uint32_t sum_period_ms;
+    int32_t  sum_amp;       // 振幅累加 (峰峰值/2, 0.1°C)
+    uint32_t sum_out;       // 测量周期内的输出累加 (每次调用一个样本)
+    uint32_t n_out;
+
+    // 结果
+    q16_t    Ku;            // 临界增益 (Q16, 输出计数 / 0.1°C)
+    uint32_t Tu_ms;         // 临界周期
+    int32_t  mean_out;      // 整周期平均输出 = 维持设定温度所需的占空比 (用于前馈)
+} AutoTune_t;
+
+void    AutoTune_Start(AutoTune_t *at, int32_t setpoint, int32_t out_low, int32_t out_high, int32_t hyst, uint32_t now_ms);
+int32_t AutoTune_Run(AutoTune_t *at, int32_t measurement, uint32_t now_ms);   // 返回本周期输出
+void    AutoTune_Abort(AutoTune_t *at);
+
+// 由 Ku/Tu 计算 PID 参数 (Q16, 秒), 只有 state == AT_DONE 时有效
+bool    AutoTune_GetGains(const AutoTune_t *at, AT_Rule_t rule, q16_t *Kp, q16_t *Ki, q16_t *Kd);
+
+// 前馈系数 = 平均输出 / (设定温度 - 室温), Q16 (输出计数 / 0.1°C)
+bool    AutoTune_GetFeedforward(const AutoTune_t *at, int32_t ambient, q16_t *ff);
+
+#endif
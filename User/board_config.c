@@ -1,9 +1,17 @@
 #include "board_config.h"
+#include "gun_heater.h"
 #include "py32f0xx_bsp_printf.h"
 
 // 全局句柄
-TIM_HandleTypeDef htim3; // 用于烙铁 PWM
+TIM_HandleTypeDef htim3; // 用于烙铁 PWM + 触发 ADC
 ADC_HandleTypeDef hadc;  // 用于测温
+DMA_HandleTypeDef hdma_adc; // ADC -> 内存 (循环模式)
+
+// DMA 循环缓冲区: [铁, 枪, 铁, 枪, ...] (扫描顺序按通道号从小到大)
+static volatile uint16_t adc_dma_buf[ADC_OVERSAMPLE * 2];
+
+static volatile bool     hw_tripped = false;    // 硬件超温切断锁存
+static volatile uint32_t hw_trip_count = 0;
 
 // ============================================================
 //  1. 系统时钟配置 (System Clock Configuration)
@@ -57,10 +65,10 @@ static void GPIO_Init_All(void)
   // 风枪加热 (PB7): 拉高 (假设光耦低电平触发，高电平为关)
   HAL_GPIO_WritePin(GUN_HEATER_PORT, GUN_HEATER_PIN, GPIO_PIN_SET); 
   
-  // 风扇 (PA9): 拉低 (关)
+  // 风扇 PWM (PB0): 拉低 (关)，稍后由 TIM3 接管
   HAL_GPIO_WritePin(GUN_FAN_PORT, GUN_FAN_PIN, GPIO_PIN_RESET);
 
-  // 屏幕 (PA10, PA11): 拉高 (空闲)
+  // 屏幕 (PA4, PA11): 拉高 (空闲)
   HAL_GPIO_WritePin(TM1637_CLK_PORT, TM1637_CLK_PIN, GPIO_PIN_SET);
   HAL_GPIO_WritePin(TM1637_DIO_PORT, TM1637_DIO_PIN, GPIO_PIN_SET);
 
@@ -74,11 +82,7 @@ static void GPIO_Init_All(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
   HAL_GPIO_Init(GUN_HEATER_PORT, &GPIO_InitStruct);
 
-  // 风扇 (PA9)
-  GPIO_InitStruct.Pin = GUN_FAN_PIN;
-  HAL_GPIO_Init(GUN_FAN_PORT, &GPIO_InitStruct);
-
-  // 屏幕 CLK/DIO (PA10, PA11)
+  // 屏幕 CLK/DIO (PA4, PA11)
   GPIO_InitStruct.Pin = TM1637_CLK_PIN | TM1637_DIO_PIN;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
@@ -91,19 +95,20 @@ static void GPIO_Init_All(void)
   GPIO_InitStruct.Pull = GPIO_PULLUP; // 必须上拉
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
-  // PA4 (烙铁开关)
+  // PA5 (烙铁开关)
   GPIO_InitStruct.Pin = IRON_SW_PIN;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 }
 
 // ============================================================
-//  3. PWM 初始化 (TIM3 控制 PB5 烙铁)
+//  3. PWM 初始化 (TIM3 控制 PB5 烙铁 + PB0 风扇)
 //  目标: 1kHz 频率
+//  CH4 不接引脚，只用来在关断段产生 TRGO 触发 ADC
 // ============================================================
 static void PWM_TIM3_Init(void)
 {
   //TIM_ClockConfigTypeDef sClockSourceConfig = {0};
-  //TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
   TIM_OC_InitTypeDef sConfigOC = {0};
   GPIO_InitTypeDef GPIO_InitStruct = {0};
 
@@ -118,6 +123,11 @@ static void PWM_TIM3_Init(void)
   GPIO_InitStruct.Alternate = GPIO_AF1_TIM3; // 查手册 PB5 复用功能是 AF1
   HAL_GPIO_Init(IRON_HEATER_PORT, &GPIO_InitStruct);
 
+  // PB0 -> TIM3_CH3 (风扇)
+  GPIO_InitStruct.Pin = GUN_FAN_PIN;
+  GPIO_InitStruct.Alternate = GPIO_AF1_TIM3;
+  HAL_GPIO_Init(GUN_FAN_PORT, &GPIO_InitStruct);
+
   // 3. 配置定时器基础参数
   // 主频 24MHz。
   // 我们想要 1kHz PWM -> 周期 1ms -> 1000us
@@ -126,7 +136,7 @@ static void PWM_TIM3_Init(void)
   htim3.Instance = TIM3;
   htim3.Init.Prescaler = 24 - 1;
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 1000 - 1;
+  htim3.Init.Period = IRON_PWM_PERIOD - 1;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
@@ -150,20 +160,48 @@ static void PWM_TIM3_Init(void)
     while(1);
   }
 
-  // 6. 启动 PWM 输出
+  // 通道 3: 风扇 PWM (同样 PWM1，高电平开 MOS 管)
+  if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_3) != HAL_OK)
+  {
+    while(1);
+  }
+
+  // 6. 配置通道 4 作为 ADC 触发源
+  // PWM2 模式: CNT < CCR4 时 OC4REF 为低，计到 ADC_TRIG_POINT 时出现上升沿 -> TRGO
+  sConfigOC.OCMode = TIM_OCMODE_PWM2;
+  sConfigOC.Pulse = ADC_TRIG_POINT;
+  if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_4) != HAL_OK)
+  {
+    while(1);
+  }
+
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC4REF;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
+  {
+    while(1);
+  }
+
+  // 7. 启动 PWM 输出 (CH4 的 PB1 没有配成复用功能，不会输出到引脚)
   HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_2);
+  HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_3);
+  HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_4);
+  // CH1 保持冻结模式不接引脚, 风枪移相触发拿它的比较中断定门极时刻 (gun_heater.c)
 }
 
 // ============================================================
 //  4. ADC 初始化 (用于 PA2, PA3 测温)
+//  TIM3 TRGO 触发一次扫描 (CH2 + CH3)，DMA 循环写入 adc_dma_buf
 // ============================================================
 static void ADC_Init(void)
 {
-  //ADC_ChannelConfTypeDef sConfig = {0};
+  ADC_ChannelConfTypeDef sConfig = {0};
   GPIO_InitTypeDef GPIO_InitStruct = {0};
 
-  // 1. 开启 ADC 时钟
+  // 1. 开启 ADC / DMA 时钟
   __HAL_RCC_ADC_CLK_ENABLE();
+  __HAL_RCC_DMA_CLK_ENABLE();
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
 
   // 2. 配置 PA2, PA3 为模拟输入模式 (关键!)
   GPIO_InitStruct.Pin = GPIO_PIN_2 | GPIO_PIN_3;
@@ -171,19 +209,35 @@ static void ADC_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-  // 3. 配置 ADC 参数
+  // 3. 配置 DMA 通道 1 (外设 -> 内存, 循环模式)
+  hdma_adc.Instance = DMA1_Channel1;
+  hdma_adc.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  hdma_adc.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_adc.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_adc.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  hdma_adc.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+  hdma_adc.Init.Mode = DMA_CIRCULAR;
+  hdma_adc.Init.Priority = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&hdma_adc) != HAL_OK)
+  {
+    while(1);
+  }
+  HAL_DMA_ChannelMap(&hdma_adc, DMA_CHANNEL_MAP_ADC);
+  __HAL_LINKDMA(&hadc, DMA_Handle, hdma_adc);
+
+  // 4. 配置 ADC 参数
   hadc.Instance = ADC1;
-  hadc.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4; // 时钟分频
+  hadc.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4; // 时钟分频 (6MHz)
   hadc.Init.Resolution = ADC_RESOLUTION_12B;           // 12位精度 (0-4095)
   hadc.Init.DataAlign = ADC_DATAALIGN_RIGHT;
-  hadc.Init.ScanConvMode = ADC_SCAN_DIRECTION_FORWARD; // 扫描模式
-  hadc.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
-  hadc.Init.LowPowerAutoWait = ENABLE;                 // 低功耗等待
-  hadc.Init.ContinuousConvMode = DISABLE;              // 单次转换 (我们需要手动触发)
+  hadc.Init.ScanConvMode = ADC_SCAN_DIRECTION_FORWARD; // 扫描模式 (CH2 -> CH3)
+  hadc.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+  hadc.Init.LowPowerAutoWait = DISABLE;                // DMA 读取，不需要等待
+  hadc.Init.ContinuousConvMode = DISABLE;              // 每个触发只扫一轮
   hadc.Init.DiscontinuousConvMode = DISABLE;
-  hadc.Init.ExternalTrigConv = ADC_SOFTWARE_START;     // 软件触发
-  hadc.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-  hadc.Init.DMAContinuousRequests = DISABLE;
+  hadc.Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T3_TRGO; // TIM3 关断段触发
+  hadc.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+  hadc.Init.DMAContinuousRequests = ENABLE;            // DMA 循环请求
   hadc.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
   
   if (HAL_ADC_Init(&hadc) != HAL_OK)
@@ -191,53 +245,169 @@ static void ADC_Init(void)
     while(1);
   }
 
-  // 校准 ADC (PY32 必须做的)
+  // 校准 ADC (PY32 必须做的, 要在使能之前)
   HAL_ADCEx_Calibration_Start(&hadc);
+
+  // 5. 两个通道都加入扫描序列
+  // 41.5 周期采样: (41.5 + 12.5) / 6MHz = 9us 每通道，关断窗口内可以完成
+  sConfig.Rank = ADC_RANK_CHANNEL_NUMBER;
+  sConfig.SamplingTime = ADC_SAMPLETIME_41CYCLES_5;
+  sConfig.Channel = ADC_CH_IRON_TEMP;
+  if (HAL_ADC_ConfigChannel(&hadc, &sConfig) != HAL_OK)
+  {
+    while(1);
+  }
+  sConfig.Channel = ADC_CH_GUN_TEMP;
+  if (HAL_ADC_ConfigChannel(&hadc, &sConfig) != HAL_OK)
+  {
+    while(1);
+  }
+
+  // 6. 模拟看门狗: 监视所有通道, 超过 ADC_AWD_MAX_CODE 进中断 (硬件超温切断)
+  ADC_AnalogWDGConfTypeDef awd = {0};
+  awd.WatchdogMode = ADC_ANALOGWATCHDOG_ALL_REG;
+  awd.ITMode = ENABLE;
+  awd.HighThreshold = ADC_AWD_MAX_CODE;
+  awd.LowThreshold = 0;
+  if (HAL_ADC_AnalogWDGConfig(&hadc, &awd) != HAL_OK)
+  {
+    while(1);
+  }
+  HAL_NVIC_SetPriority(ADC_COMP_IRQn, 0, 0);  // 与测速堵转同级, 最高
+  HAL_NVIC_EnableIRQ(ADC_COMP_IRQn);
+
+  // 7. 启动: 之后每次 TIM3 触发都自动扫描 + DMA 搬运，不需要 CPU 参与
+  if (HAL_ADC_Start_DMA(&hadc, (uint32_t *)adc_dma_buf, ADC_OVERSAMPLE * 2) != HAL_OK)
+  {
+    while(1);
+  }
+  // Start_DMA 会打开溢出中断; 溢出时新数据覆盖旧数据 (ADC_OVR_DATA_OVERWRITTEN), 不需要处理,
+  // 关掉以免和看门狗共用的中断被它占住
+  __HAL_ADC_DISABLE_IT(&hadc, ADC_IT_OVR);
 }
 
 // ============================================================
 //  辅助函数: 读取指定通道的 ADC 值
 //  channel 参数: ADC_CHANNEL_2 或 ADC_CHANNEL_3
+//  返回 DMA 缓冲区里最近 ADC_OVERSAMPLE 次采样的平均值，不阻塞
 // ============================================================
 uint16_t Board_ADC_Read(uint32_t channel)
 {
-    ADC_ChannelConfTypeDef sConfig = {0};
+    return (uint16_t)(Board_ADC_ReadSum(channel) / ADC_OVERSAMPLE);
+}
 
-    // 配置要读取的通道
-    sConfig.Channel = channel;
-    sConfig.Rank = ADC_RANK_CHANNEL_NUMBER;
-    sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5; // 采样时间越长越稳
-    
-    if (HAL_ADC_ConfigChannel(&hadc, &sConfig) != HAL_OK)
-    {
-        return 0;
+// 最近 ADC_OVERSAMPLE 次采样之和 (不除, 多 3 位分辨率)
+// 监控用它判断 "读数卡死": 正常的采样噪声会让和值不断跳动, DMA 停了才会一直不变
+uint16_t Board_ADC_ReadSum(uint32_t channel)
+{
+    uint32_t sum = 0;
+    uint8_t idx = (channel == ADC_CH_IRON_TEMP) ? 0 : 1;
+
+    for (uint8_t i = 0; i < ADC_OVERSAMPLE; i++) {
+        sum += adc_dma_buf[i * 2 + idx];
     }
 
-    // 开始转换
-    HAL_ADC_Start(&hadc);
-    
-    // 等待转换完成
-    HAL_ADC_PollForConversion(&hadc, 10); // 等待 10ms
-    
-    // 获取结果
-    uint16_t val = HAL_ADC_GetValue(&hadc);
-    
-    // 停止 (省电)
-    HAL_ADC_Stop(&hadc);
-    
-    return val;
+    return (uint16_t)sum;
 }
 
 // ============================================================
 //  辅助函数: 设置烙铁 PWM 占空比
 //  duty: 0 ~ 1000 (对应 0% ~ 100%)
+//  超过 IRON_PWM_MAX 的部分会被截掉，保证 ADC 采样窗口里加热管是关的
 // ============================================================
 void Board_Iron_SetPWM(uint16_t duty)
 {
-    if(duty > 1000) duty = 1000;
+    if (hw_tripped) duty = 0;   // 硬件切断期间输出已强制关断, 这里也不留非零值
+    if(duty > IRON_PWM_MAX) duty = IRON_PWM_MAX;
     __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, duty);
 }
 
+// 风扇占空比 0 ~ FAN_PWM_MAX
+// 关断沿不能落在 ADC 采样窗口里 (电机电流突变会串进热电偶信号):
+// 超过 IRON_PWM_MAX 就直接常开 (CCR > ARR, 整个周期都没有边沿)
+void Board_Fan_SetPWM(uint16_t duty)
+{
+    if (duty > IRON_PWM_MAX) duty = FAN_PWM_MAX;
+    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_3, duty);
+}
+
+// ============================================================
+//  硬件超温切断 (ADC 模拟看门狗中断)
+// ============================================================
+// 烙铁: CCR2 有预装载, 写 0 要等到下个周期才生效, 所以直接把 OC2 强制为无效电平 (立即生效)
+// 风枪: GunHeater_Trip 释放加热脚并锁存, 之后 GunHeater_Tick 不会再打开
+void Board_ADC_AWD_IRQHandler(void)
+{
+    if (!(ADC1->ISR & ADC_ISR_AWD)) return;
+
+    Board_Heaters_Cut();
+
+    // 只记一次: 关掉中断, 温度一直超限也不会每次转换都进来
+    ADC1->IER &= ~ADC_IER_AWDIE;
+    ADC1->ISR = ADC_ISR_AWD;
+    hw_tripped = true;
+    hw_trip_count++;
+}
+
+// 烙铁 PWM 的强制关断有两个来源, 任何一个在就保持关断
+static volatile bool iron_cut  = false;     // Board_Heaters_Cut 锁存
+static volatile bool iron_lock = false;     // 风枪导通互锁
+
+// 只动寄存器, 不用 HAL 句柄 (HardFault 里句柄状态不可信)
+void Board_Heaters_Cut(void)
+{
+    iron_cut = true;
+    MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC2M, TIM_OCMODE_FORCED_INACTIVE << 8);
+    GunHeater_Trip();
+}
+
+// 判断和写寄存器之间关中断: 否则 Cut (优先级 0) 插进来会被这里的 PWM1 盖掉
+// 调用者可能已经关了中断 (GunHeater_Off), 所以恢复原来的 PRIMASK 而不是直接开
+static void Iron_ApplyMode(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (iron_cut || iron_lock) MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC2M, TIM_OCMODE_FORCED_INACTIVE << 8);
+    else                       MODIFY_REG(TIM3->CCMR1, TIM_CCMR1_OC2M, TIM_OCMODE_PWM1 << 8);
+    __set_PRIMASK(primask);
+}
+
+void Board_Iron_Release(void)
+{
+    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, 0);
+    iron_cut = false;
+    Iron_ApplyMode();
+}
+
+void Board_Iron_Lockout(bool lock)
+{
+    if (lock == iron_lock) return;
+    iron_lock = lock;
+    Iron_ApplyMode();
+}
+
+bool Board_HwTrip_IsActive(void)
+{
+    return hw_tripped;
+}
+
+uint32_t Board_HwTrip_GetCount(void)
+{
+    return hw_trip_count;
+}
+
+void Board_HwTrip_Clear(void)
+{
+    if (!hw_tripped) return;
+
+    hw_tripped = false;
+    Board_Iron_Release();
+
+    // 还在超温的话下一次转换又会切断
+    ADC1->ISR = ADC_ISR_AWD;
+    ADC1->IER |= ADC_IER_AWDIE;
+}
+
 // ============================================================
 //  总初始化函数 (在 main 中调用这个即可)
 // ============================================================
@@ -245,9 +415,9 @@ void Board_Init(void)
 {
     SystemClock_Config(); // 1. 先搞定 24MHz 时钟
     GPIO_Init_All();      // 2. 搞定所有 IO
-    PWM_TIM3_Init();      // 3. 启动烙铁 PWM
-    ADC_Init();           // 4. 启动眼睛 (ADC)
-    
-    BSP_USART_Config();   // 5. 串口 (用于 printf 调试)
+    BSP_USART_Config();   // 3. 串口 (用于 printf 调试)
+                          //    注意: BSP 会把 PA3 配成 USART1_RX，所以必须在 ADC_Init 之前调用
+    ADC_Init();           // 4. 启动眼睛 (ADC + DMA, 等待 TIM3 触发)
+    PWM_TIM3_Init();      // 5. 启动烙铁 PWM (同时开始触发 ADC)
     printf("Board Init Success!\r\n");
 }
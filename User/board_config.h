@@ -2,6 +2,7 @@
 #define __BOARD_CONFIG_H
 
 #include "py32f0xx_hal.h"
+#include <stdbool.h>
 
 // ==========================================
 //  1. 核心 ADC (PA2, PA3)
@@ -9,6 +10,29 @@
 #define ADC_CH_IRON_TEMP        ADC_CHANNEL_2   // PA2 (Pin 5)
 #define ADC_CH_GUN_TEMP         ADC_CHANNEL_3   // PA3 (Pin 6)
 
+// ADC 由 TIM3 触发，DMA 循环搬运，主循环只读缓冲区 (零 CPU 开销)
+// 触发点放在烙铁 PWM 的关断段，避开加热管开关噪声:
+//   0 ........ IRON_PWM_MAX ...... ADC_TRIG_POINT ...... 1000
+//   |<-- 最大导通 -->|<-- 消隐/稳定 -->|<-- 采样 2 通道约 18us -->|
+#define IRON_PWM_PERIOD         1000            // TIM3 周期 (1us 一跳)
+#define ADC_TRIG_POINT          960             // TIM3_CH4 比较点 -> TRGO 触发 ADC
+#define IRON_PWM_MAX            900             // 烙铁最大占空比 (保证留出关断采样窗口)
+#define ADC_OVERSAMPLE          8               // 每通道保留最近 8 次采样做平均 (8ms)
+
+// 硬件超温切断: ADC 模拟看门狗监视两个通道, 任一次转换超过门限就进中断,
+// 在中断里直接关烙铁 PWM 输出、释放风枪加热脚, 不经过主循环。
+// 门限是原始 ADC 码 (未经校准): 3307 约 560°C, 高于软件监控的上限 (520/550°C)，
+// 正常情况下软件先动作, 这里是最后一道保险。
+#define ADC_AWD_MAX_CODE        3307
+
+// 比较器超温切断 (COMP1, 见 comp_trip.c): 不依赖 ADC/DMA, 直接比较运放输出和分压基准
+//   COMP1_INP -> PB2 (飞线接烙铁运放输出, 即 PA2 同一网络; PB2 原来是开关量风扇, 已空出)
+//   COMP1_INM -> PB1 (VCC 上 10k / 47k 分压到地, 约 0.82 VCC, 比 ADC_AWD_MAX_CODE 的 0.81 VCC 略高)
+// 分压和 ADC 都以 VCC 为基准, 电源波动时门限跟着走
+#define COMP_TRIP_SENSE_PIN     GPIO_PIN_2
+#define COMP_TRIP_REF_PIN       GPIO_PIN_1
+#define COMP_TRIP_PORT          GPIOB
+
 // ==========================================
 //  2. 独立开关输入 (内部上拉, 低电平有效)
 // ==========================================
@@ -22,11 +46,37 @@
 #define GUN_SW_PORT             GPIOB
 #define READ_GUN_SW()           HAL_GPIO_ReadPin(GUN_SW_PORT, GUN_SW_PIN)
 
-// 烙铁开关 (飞线接原 R16) -> PA8
-#define IRON_SW_PIN             GPIO_PIN_8
+// 烙铁开关 (飞线接原 R16) -> PA5
+// 原来在 PA8, PA8 让给编码器 (TIM1_CH1) 后要飞线到 PA5
+#define IRON_SW_PIN             GPIO_PIN_5
 #define IRON_SW_PORT            GPIOA
 #define READ_IRON_SW()          HAL_GPIO_ReadPin(IRON_SW_PORT, IRON_SW_PIN)
 
+// 风扇测速 (飞线接风扇 FG 线) -> PA7 (TIM17_CH1, AF5)，见 tach.c
+#define GUN_TACH_PIN            GPIO_PIN_7
+#define GUN_TACH_PORT           GPIOA
+#define GUN_TACH_AF             GPIO_AF5_TIM17
+
+// 调温旋转编码器 (A/B 两相, 触点对地) -> TIM1 编码器模式，见 encoder.c
+//   A -> PA8 (TIM1_CH1, AF2), B -> PB3 (TIM1_CH2, AF1)
+// 只有 TIM1/TIM3 有编码器模式, TIM3 是烙铁 PWM, 所以过零同步的门极定时挪到了 TIM3_CH1
+#define ENC_A_PIN               GPIO_PIN_8
+#define ENC_A_PORT              GPIOA
+#define ENC_A_AF                GPIO_AF2_TIM1
+#define ENC_B_PIN               GPIO_PIN_3
+#define ENC_B_PORT              GPIOB
+#define ENC_B_AF                GPIO_AF1_TIM1
+
+// 市电过零检测 (光耦集电极, 每半波一个低脉冲) -> PA1 (EXTI1)，见 zero_cross.c
+#define GUN_ZC_PIN              GPIO_PIN_1
+#define GUN_ZC_PORT             GPIOA
+
+// 远程命令接收 -> PA10 (USART1_RX, AF1)，见 remote.c
+// BSP 默认的 RX 脚 PA3 是风枪热电偶 ADC，不能用
+#define CMD_RX_PIN              GPIO_PIN_10
+#define CMD_RX_PORT             GPIOA
+#define CMD_RX_AF               GPIO_AF1_USART1
+
 // ==========================================
 //  3. 输出控制
 // ==========================================
@@ -38,16 +88,24 @@
 #define GUN_HEATER_PIN          GPIO_PIN_7
 #define GUN_HEATER_PORT         GPIOB
 
-// 风扇 -> PA9
-#define GUN_FAN_PIN             GPIO_PIN_2
+// 风扇 PWM -> PB0 (TIM3_CH3, AF1)，与烙铁共用 TIM3 的 1kHz 周期
+// 注意: 原来开关量风扇接在 PB2，改调速后要飞线到 PB0
+#define GUN_FAN_PIN             GPIO_PIN_0
 #define GUN_FAN_PORT            GPIOB
-#define GUN_FAN_ON()            HAL_GPIO_WritePin(GUN_FAN_PORT, GUN_FAN_PIN, GPIO_PIN_SET)
-#define GUN_FAN_OFF()           HAL_GPIO_WritePin(GUN_FAN_PORT, GUN_FAN_PIN, GPIO_PIN_RESET)
+#define FAN_PWM_MAX             IRON_PWM_PERIOD // 风扇占空比满量程 (1000 = 常开)
+
+// 引脚直接置位/清零 (一次 BSRR/BRR 写, 中断里也能用)
+// 主机仿真 (Host/) 在编译命令里预先定义这两个宏, 把每次写引脚交给总线解码和功率积分
+#ifndef BOARD_PIN_HIGH
+#define BOARD_PIN_HIGH(port, pin)   ((port)->BSRR = (pin))
+#define BOARD_PIN_LOW(port, pin)    ((port)->BRR  = (pin))
+#endif
 
 // ==========================================
-//  4. 显示屏 (PA10, PA11)
+//  4. 显示屏 (PA4, PA11)
 // ==========================================
-#define TM1637_CLK_PIN          GPIO_PIN_10
+// CLK 原来在 PA10，PA10 让给 USART1_RX (远程命令) 后要飞线到 PA4
+#define TM1637_CLK_PIN          GPIO_PIN_4
 #define TM1637_CLK_PORT         GPIOA
 #define TM1637_DIO_PIN          GPIO_PIN_11
 #define TM1637_DIO_PORT         GPIOA
@@ -57,31 +115,38 @@
 // ==========================================
 void Board_Init(void);
 uint16_t Board_ADC_Read(uint32_t channel);
+uint16_t Board_ADC_ReadSum(uint32_t channel);
 void Board_Iron_SetPWM(uint16_t duty);
+void Board_Fan_SetPWM(uint16_t duty);
+
+// 硬件超温切断 (见 ADC_AWD_MAX_CODE)
+void     Board_ADC_AWD_IRQHandler(void);  // 在 ADC_COMP_IRQHandler 里调用
+bool     Board_HwTrip_IsActive(void);     // 已切断, 等待解除
+uint32_t Board_HwTrip_GetCount(void);     // 上电以来切断次数
+void     Board_HwTrip_Clear(void);        // 恢复烙铁 PWM、重新打开看门狗中断 (风枪跳闸由 GunHeater_ClearTrip 解除)
+
+// 两路加热立即断电 (可在任何中断/异常里调用, 包括 HardFault)
+void     Board_Heaters_Cut(void);
+void     Board_Iron_Release(void);        // 撤销 Cut 对烙铁 PWM 的强制关断 (占空比从 0 开始)
+// 风枪导通互锁 (gun_heater.c 在中断里调用): lock 期间烙铁 PWM 强制关断, 解锁不会撤销 Cut
+void     Board_Iron_Lockout(bool lock);
 
 // ==========================================
 //  TM1637 底层方向控制 (读按键必须)
 // ==========================================
-// 设置 DIO 为输入 (浮空输入)
-#define TM1637_DIO_IN()   { \
-    GPIO_InitTypeDef GPIO_InitStruct = {0}; \
-    GPIO_InitStruct.Pin = TM1637_DIO_PIN; \
-    GPIO_InitStruct.Mode = GPIO_MODE_INPUT; \
-    GPIO_InitStruct.Pull = GPIO_PULLUP; \
-    HAL_GPIO_Init(TM1637_DIO_PORT, &GPIO_InitStruct); \
-}
+// 直接改 MODER 寄存器 (一次读改写)，不再每次调用 HAL_GPIO_Init
+// 上拉在 TM1637_Init 里配置一次，输入/输出模式下都保持
+#define TM1637_DIO_PIN_POS      11      // PA11
+#define TM1637_DIO_MODER_MASK   (GPIO_MODER_MODE0 << (TM1637_DIO_PIN_POS * 2))
+
+// 设置 DIO 为输入 (上拉输入)
+#define TM1637_DIO_IN()   (TM1637_DIO_PORT->MODER &= ~TM1637_DIO_MODER_MASK)
 
 // 设置 DIO 为输出 (推挽输出)
-#define TM1637_DIO_OUT()  { \
-    GPIO_InitTypeDef GPIO_InitStruct = {0}; \
-    GPIO_InitStruct.Pin = TM1637_DIO_PIN; \
-    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP; \
-    GPIO_InitStruct.Pull = GPIO_NOPULL; \
-    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH; \
-    HAL_GPIO_Init(TM1637_DIO_PORT, &GPIO_InitStruct); \
-}
+#define TM1637_DIO_OUT()  (TM1637_DIO_PORT->MODER = (TM1637_DIO_PORT->MODER & ~TM1637_DIO_MODER_MASK) \
+                                                    | (GPIO_MODER_MODE0_0 << (TM1637_DIO_PIN_POS * 2)))
 
 // 读取 DIO 电平
-#define TM1637_DIO_READ() HAL_GPIO_ReadPin(TM1637_DIO_PORT, TM1637_DIO_PIN)
+#define TM1637_DIO_READ() ((TM1637_DIO_PORT->IDR & TM1637_DIO_PIN) != 0)
 
 #endif
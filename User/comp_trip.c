@@ -0,0 +1,105 @@
+#include "comp_trip.h"
+#include "board_config.h"
+
+#define COMP_TRIP_MAGIC     0x54524950UL    // "TRIP"
+
+static volatile bool tripped = false;
+
+// 不初始化 (.noinit), 热复位后保留; 上电时内容随机, 用魔数 + 反码判断是否有效
+static struct {
+    uint32_t magic;
+    uint32_t count;
+    uint32_t check;
+} trip_log __attribute__((section(".noinit")));
+
+static void Trip_Latch(void)
+{
+    Board_Heaters_Cut();
+    if (!tripped) {
+        tripped = true;
+        trip_log.count++;
+        trip_log.check = ~trip_log.count;
+    }
+}
+
+void CompTrip_Arm(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    if (trip_log.magic != COMP_TRIP_MAGIC || trip_log.check != ~trip_log.count) {
+        trip_log.magic = COMP_TRIP_MAGIC;
+        trip_log.count = 0;
+        trip_log.check = ~0U;
+    }
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_COMP1_CLK_ENABLE();
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    // PB2 (运放输出) / PB1 (分压基准) 模拟输入
+    GPIO_InitStruct.Pin = COMP_TRIP_SENSE_PIN | COMP_TRIP_REF_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(COMP_TRIP_PORT, &GPIO_InitStruct);
+
+    // 没开 HAL_COMP 模块 (它要 LL 的 EXTI 头文件, HAL 工程的包含路径里没有), 直接写寄存器
+    // 正端 IO2 = PB2, 负端 IO1 = PB1, 高速模式, 开迟滞, 输出不反相
+    COMP1->CSR = COMP_CSR_INPSEL_0
+               | (COMP_CSR_INMSEL_2 | COMP_CSR_INMSEL_1)
+               | COMP_CSR_HYST;
+    COMP1->FR = COMP_FR_FLTEN
+              | (((SystemCoreClock / 1000000) * COMP_TRIP_FILTER_US) << COMP_FR_FLTCNT_Pos);  // PCLK 周期数
+    COMP1->CSR |= COMP_CSR_EN;
+    HAL_Delay(1);   // 比较器启动 (手册 80us)
+
+    // 配好就锁上: 复位前 CSR 只读, 跑飞的代码也关不掉它
+    COMP1->CSR |= COMP_CSR_LOCK;
+
+    // COMP1 输出 -> EXTI17 上升沿中断
+    EXTI->RTSR |= EXTI_RTSR_RT17;
+    EXTI->PR = EXTI_PR_PR17;
+    EXTI->IMR |= EXTI_IMR_IM17;
+
+    // 和 ADC 模拟看门狗共用中断 (ADC_Init 里已经按优先级 0 打开)
+    HAL_NVIC_SetPriority(ADC_COMP_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC_COMP_IRQn);
+
+    // 上升沿只在跨过门限时才有, 开机时已经是高电平不会触发, 这里补一次
+    if (CompTrip_IsOver()) Trip_Latch();
+}
+
+void CompTrip_IRQHandler(void)
+{
+    if (!(EXTI->PR & EXTI_PR_PR17)) return;
+
+    EXTI->PR = EXTI_PR_PR17;
+    Trip_Latch();
+}
+
+bool CompTrip_IsTripped(void)
+{
+    return tripped;
+}
+
+bool CompTrip_IsOver(void)
+{
+    return (COMP1->CSR & COMP_CSR_COMP_OUT) != 0;
+}
+
+bool CompTrip_Rearm(void)
+{
+    if (!tripped) return true;
+    if (CompTrip_IsOver()) return false;
+
+    // 检查之后又超温的话, 上升沿会挂起中断, 开中断后马上又切断
+    __disable_irq();
+    tripped = false;
+    Board_Iron_Release();
+    __enable_irq();
+    return true;
+}
+
+uint32_t CompTrip_GetCount(void)
+{
+    return trip_log.count;
+}
@@ -0,0 +1,32 @@
+#ifndef __COMP_TRIP_H
+#define __COMP_TRIP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  比较器超温切断 (COMP1, 引脚见 board_config.h)
+// ============================================================
+// 运放输出 (PB2) 高于分压基准 (PB1) -> COMP1 输出变高 -> EXTI17 上升沿
+// -> ADC_COMP_IRQHandler (优先级 0) 里 Board_Heaters_Cut 断两路加热并锁存。
+// 和 ADC 模拟看门狗是两条独立的路: ADC/DMA 停了、主循环卡死, 这条照样动作。
+//
+// 烙铁加热时热电偶信号上叠着开关干扰, 比较器又是连续比较的 (不像 ADC 只在关断段采样),
+// 所以开数字滤波: 输出要连续高 COMP_TRIP_FILTER_US 才算数, 比一个 PWM 周期还长。
+// 最大占空比下每周期仍有 100us 关断段, 只是开通期间的尖峰不会穿过滤波; 真超温时
+// 关断段也是高, 滤波时间一到就切断。
+//
+// 锁存后只有 CompTrip_Rearm 能解除, 而且比较器输出还是高的话解除不了。
+// 切断次数放在不初始化的 RAM 里, 看门狗 / 软件复位后还在 (上电清零), 开机打印。
+
+#define COMP_TRIP_FILTER_US     1200
+
+void     CompTrip_Arm(void);        // 初始化 COMP1 并开始监视 (开机时已超温会立即切断)
+bool     CompTrip_IsTripped(void);  // 已切断, 等待解除
+bool     CompTrip_IsOver(void);     // 比较器当前输出 (运放输出高于基准)
+bool     CompTrip_Rearm(void);      // 解除锁存并恢复烙铁 PWM; 仍超温返回 false (保持切断)
+uint32_t CompTrip_GetCount(void);   // 上电以来切断次数 (跨热复位)
+
+void     CompTrip_IRQHandler(void); // 在 ADC_COMP_IRQHandler 里调用
+
+#endif
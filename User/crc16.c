@@ -0,0 +1,13 @@
+#include "crc16.h"
+
+// 逐位计算，不占查表的 512 字节 Flash；这里的数据量都很小
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,16 @@
+#ifndef __CRC16_H
+#define __CRC16_H
+
+#include <stdint.h>
+
+// CRC-16/CCITT-FALSE (多项式 0x1021, 初值 0xFFFF)
+#define CRC16_INIT  0xFFFF
+
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t len);
+
+static inline uint16_t CRC16(const uint8_t *data, uint32_t len)
+{
+    return CRC16_Update(CRC16_INIT, data, len);
+}
+
+#endif
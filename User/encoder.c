@@ -0,0 +1,98 @@
+#include "encoder.h"
+#include "board_config.h"
+
+static TIM_HandleTypeDef htim1;
+
+static uint16_t last_cnt = 0;       // 上次读到的计数
+static int16_t  residue = 0;        // 还不够一格的计数
+static uint32_t last_move_ms = 0;   // 上次有转动的时刻
+
+void Encoder_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    TIM_Encoder_InitTypeDef sConfig = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_TIM1_CLK_ENABLE();
+
+    // 编码器是机械触点对地, 开内部上拉
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Pin = ENC_A_PIN;
+    GPIO_InitStruct.Alternate = ENC_A_AF;
+    HAL_GPIO_Init(ENC_A_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = ENC_B_PIN;
+    GPIO_InitStruct.Alternate = ENC_B_AF;
+    HAL_GPIO_Init(ENC_B_PORT, &GPIO_InitStruct);
+
+    htim1.Instance = TIM1;
+    htim1.Init.Prescaler = 0;
+    htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim1.Init.Period = 0xFFFF;                         // 16 位回绕, 读差值时按有符号处理
+    htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV4;  // 滤波采样慢一点: fDTS = 6MHz
+    htim1.Init.RepetitionCounter = 0;
+    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    // TI1 + TI2 双边沿计数 (4 倍频); 最大数字滤波 fDTS/32 x 8 ≈ 43us, 滤掉干扰尖刺
+    // 触点抖动不用管: 正交计数抖一下是 +1 -1, 凑整格的时候自然抵消
+    sConfig.EncoderMode = TIM_ENCODERMODE_TI12;
+    sConfig.IC1Polarity = TIM_ICPOLARITY_RISING;
+    sConfig.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+    sConfig.IC1Prescaler = TIM_ICPSC_DIV1;
+    sConfig.IC1Filter = 0x0F;
+    sConfig.IC2Polarity = TIM_ICPOLARITY_RISING;
+    sConfig.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+    sConfig.IC2Prescaler = TIM_ICPSC_DIV1;
+    sConfig.IC2Filter = 0x0F;
+    if (HAL_TIM_Encoder_Init(&htim1, &sConfig) != HAL_OK)
+    {
+        while(1);
+    }
+    HAL_TIM_Encoder_Start(&htim1, TIM_CHANNEL_ALL);
+
+    last_cnt = (uint16_t)TIM1->CNT;
+    residue = 0;
+    last_move_ms = 0;
+}
+
+int16_t Encoder_AccelStep(int16_t detents, uint32_t dt_ms)
+{
+    if (detents == 0) return 0;
+    if (dt_ms == 0) dt_ms = 1;
+    if (dt_ms > ENC_ACCEL_IDLE_MS) dt_ms = ENC_ACCEL_IDLE_MS;
+
+    uint32_t n = (detents < 0) ? (uint32_t)(-detents) : (uint32_t)detents;
+    uint32_t dps = n * 1000 / dt_ms;
+    uint32_t step;
+
+    if (dps <= ENC_ACCEL_SLOW_DPS) {
+        step = 1;
+    } else if (dps >= ENC_ACCEL_FAST_DPS) {
+        step = ENC_ACCEL_MAX_STEP;
+    } else {
+        step = 1 + (ENC_ACCEL_MAX_STEP - 1) * (dps - ENC_ACCEL_SLOW_DPS)
+                   / (ENC_ACCEL_FAST_DPS - ENC_ACCEL_SLOW_DPS);
+    }
+
+    int32_t delta = (int32_t)(n * step);
+    if (delta > INT16_MAX) delta = INT16_MAX;
+    return (int16_t)((detents < 0) ? -delta : delta);
+}
+
+int16_t Encoder_Poll(uint32_t now_ms)
+{
+    uint16_t cnt = (uint16_t)TIM1->CNT;
+    int16_t  diff = (int16_t)(cnt - last_cnt);     // 两次之间转不到半圈 65536 计数, 回绕按有符号算就对
+    last_cnt = cnt;
+
+    residue += diff;
+    int16_t detents = residue / ENC_COUNTS_PER_DETENT;     // 向 0 取整, 反向时余数也是反向的
+    if (detents == 0) return 0;
+    residue -= detents * ENC_COUNTS_PER_DETENT;
+
+    int16_t delta = Encoder_AccelStep(detents, now_ms - last_move_ms);
+    last_move_ms = now_ms;
+    return delta;
+}
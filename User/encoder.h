@@ -0,0 +1,30 @@
+#ifndef __ENCODER_H
+#define __ENCODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  旋转编码器调温 (TIM1 编码器模式, A -> PA8 / B -> PB3)
+// ============================================================
+// TIM1 的 TI1/TI2 直接做正交解码, 计数器跟着旋钮加减, 转动时 CPU 什么都不用做。
+// 界面任务每次调 Encoder_Poll 读一次计数差, 凑满一格 (ENC_COUNTS_PER_DETENT) 才算数,
+// 再按转速放大步进: 慢慢拧每格 1°C, 快速拧每格最多 ENC_ACCEL_MAX_STEP °C。
+// 转速 = 本次的格数 / 离上一次有转动过了多久, 停一下再拧第一格总是 1°C。
+
+#define ENC_COUNTS_PER_DETENT   4       // EC11 类: 一格一个完整正交周期 = 4 个计数 (TI1+TI2 双边沿)
+#define ENC_ACCEL_SLOW_DPS      8       // 低于这个转速 (格/秒) 每格 1°C
+#define ENC_ACCEL_FAST_DPS      40      // 到这个转速 (约 2 圈/秒) 每格 ENC_ACCEL_MAX_STEP, 中间线性
+#define ENC_ACCEL_MAX_STEP      10      // 每格最大步进 (°C)
+#define ENC_ACCEL_IDLE_MS       1000    // 停这么久以上, 间隔按这个算 (转速近似 0)
+
+void    Encoder_Init(void);
+
+// 界面任务里调用: 返回这段时间累计的设定值变化 (°C, 已加速), 没转返回 0
+int16_t Encoder_Poll(uint32_t now_ms);
+
+// 加速曲线: dt_ms 内转了 detents 格 (带符号) -> 设定值变化 (°C)
+// 不碰硬件, 可以在 PC 上单独测试
+int16_t Encoder_AccelStep(int16_t detents, uint32_t dt_ms);
+
+#endif
@@ -0,0 +1,78 @@
+#include "fan.h"
+#include "board_config.h"
+#include "iron_pid.h"
+#include "tach.h"
+
+static PIDControllerQ16 fanPID;     // RPM 误差 -> 占空比修正量
+static uint8_t  fan_percent = 0;
+static uint32_t kick_until  = 0;    // 起转结束时刻 (HAL_GetTick)
+static uint32_t meas_last   = 0;    // 上一个测速窗口的时刻 (HAL_GetTick)
+
+void Fan_Init(void)
+{
+    PIDQ_Init(&fanPID);
+    fanPID.limMin = -300;           // 闭环只在前馈基础上 ±30% 修正
+    fanPID.limMax = 300;
+    fanPID.limMinInt = -300;
+    fanPID.limMaxInt = 300;
+    fanPID.T = Q16(0.01);           // 与控制任务周期一致 (10ms)
+    // 误差单位 RPM: 1000 RPM 误差 -> 立即修正 50, 每秒再累加 100
+    PIDQ_SetTunings(&fanPID, Q16(0.05), Q16(0.1), 0);
+
+    fan_percent = 0;
+    Board_Fan_SetPWM(0);
+}
+
+void Fan_SetPercent(uint8_t percent)
+{
+    if (percent > 100) percent = 100;
+
+    // 从停转到转: 开始起转计时
+    if (fan_percent == 0 && percent > 0) {
+        kick_until = HAL_GetTick() + FAN_KICK_MS;
+        PIDQ_Init(&fanPID);
+    }
+    fan_percent = percent;
+}
+
+uint8_t Fan_GetPercent(void)
+{
+    return fan_percent;
+}
+
+void Fan_Run(void)
+{
+    if (fan_percent == 0) {
+        Board_Fan_SetPWM(0);
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+
+    // 起转和测速窗口都要全速 (起转的第一个窗口由 Tach_Enable 打开, 测到转速才结束)
+    if ((int32_t)(now - kick_until) < 0 || Tach_IsMeasuring()) {
+        Board_Fan_SetPWM(FAN_PWM_MAX);
+        return;
+    }
+
+    // 前馈: 占空比大致与转速成正比
+    int32_t duty = (int32_t)fan_percent * FAN_PWM_MAX / 100;
+
+    // 用最近一个窗口的转速修正; 堵转时 RPM = 0 也照样算 (误差最大, 修正往上推)
+    // 还没有测到过 (起转窗口还没结束) 就只用前馈
+    if (Tach_HasRPM()) {
+        int32_t target_rpm = (int32_t)fan_percent * FAN_RPM_MAX / 100;
+        duty += PIDQ_Compute(&fanPID, target_rpm, Tach_GetRPM());
+    }
+
+    if (duty < FAN_DUTY_MIN) duty = FAN_DUTY_MIN;
+    if (duty > FAN_PWM_MAX)  duty = FAN_PWM_MAX;
+
+    // 到点开下一个窗口, 本周期就开始全速
+    if (duty >= FAN_PWM_MAX || now - meas_last >= FAN_MEAS_INTERVAL_MS) {
+        meas_last = now;
+        Tach_Measure();
+        if (Tach_IsMeasuring()) duty = FAN_PWM_MAX;
+    }
+    Board_Fan_SetPWM((uint16_t)duty);
+}
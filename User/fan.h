@@ -0,0 +1,30 @@
+#ifndef __FAN_H
+#define __FAN_H
+
+#include <stdint.h>
+
+// ============================================================
+//  风扇调速 (TIM3_CH3 PWM) + 转速闭环
+// ============================================================
+// 目标风量用百分比表示 (0 = 停)。有测速信号时按 RPM 闭环 (前馈 + PI 修正)，
+// 没有测速 (风扇只有两根线) 时退化为开环占空比。
+// 从停转启动时先全速 "踢" 一下，防止低占空比下起不来。
+//
+// PWM 关断相里测速线是假的 (见 tach.h), 所以转速只在测量窗口里量: 低于 100% 时每
+// FAN_MEAS_INTERVAL_MS 打开一个窗口, 窗口期间强制全速, 测到一个周期 (或判堵转) 就回到 PWM。
+// 窗口只有一两个测速周期长 (最慢 TACH_MIN_RPM 时约 100ms), 风扇惯性大, 转速几乎来不及变,
+// 量到的就是窗口前的转速; 代价是平均占空比略高一点, 由闭环修正掉。
+// 100% 时窗口一个接一个, 相当于连续测量。堵转检测只在窗口里做, 所以最长要
+// FAN_MEAS_INTERVAL_MS + 一个超时 才能发现 (全速时还是一个脉冲周期以内)。
+
+#define FAN_RPM_MAX         6000    // 100% 风量对应的转速 (按风扇规格改)
+#define FAN_DUTY_MIN        200     // 最低占空比, 再低电机会停转 (测速会判堵转)
+#define FAN_KICK_MS         300     // 起转全速时间
+#define FAN_MEAS_INTERVAL_MS 1000   // 低于 100% 时测速窗口的间隔
+
+void    Fan_Init(void);
+void    Fan_SetPercent(uint8_t percent);    // 0 ~ 100
+uint8_t Fan_GetPercent(void);
+void    Fan_Run(void);                      // 每个控制周期调用一次
+
+#endif
@@ -0,0 +1,63 @@
+#include "fsm.h"
+#include <stddef.h>
+
+static void FSM_Enter(FSM_t *fsm, uint8_t to, uint8_t reason)
+{
+    FSM_Trace_t *t = &fsm->trace[fsm->trace_head];
+    t->t_ms   = fsm->now_ms;
+    t->from   = fsm->state;
+    t->to     = to;
+    t->reason = reason;
+    fsm->trace_head = (fsm->trace_head + 1) & (FSM_TRACE_SIZE - 1);
+    if (fsm->trace_count < FSM_TRACE_SIZE) fsm->trace_count++;
+
+    fsm->state = to;
+    fsm->entered_ms = fsm->now_ms;
+    if (fsm->states[to].on_enter) fsm->states[to].on_enter(fsm);
+}
+
+void FSM_Init(FSM_t *fsm, const FSM_StateDef_t *states, uint8_t initial, void *ctx, uint32_t now_ms)
+{
+    fsm->states      = states;
+    fsm->ctx         = ctx;
+    fsm->state       = initial;
+    fsm->entered_ms  = now_ms;
+    fsm->now_ms      = now_ms;
+    fsm->trace_head  = 0;
+    fsm->trace_count = 0;
+    if (states[initial].on_enter) states[initial].on_enter(fsm);
+}
+
+void FSM_Step(FSM_t *fsm, uint32_t now_ms)
+{
+    const FSM_StateDef_t *s = &fsm->states[fsm->state];
+    fsm->now_ms = now_ms;
+
+    if (s->timeout_ms != FSM_NO_TIMEOUT && FSM_TimeInState(fsm) >= s->timeout_ms) {
+        FSM_Enter(fsm, s->timeout_to, FSM_REASON_TIMEOUT);
+    } else {
+        for (uint8_t i = 0; i < s->n_trans; i++) {
+            const FSM_Transition_t *tr = &s->trans[i];
+            if (tr->guard == NULL || tr->guard(fsm)) {
+                if (tr->action) tr->action(fsm);
+                FSM_Enter(fsm, tr->to, tr->reason);
+                break;
+            }
+        }
+    }
+
+    s = &fsm->states[fsm->state];
+    if (s->during) s->during(fsm);
+}
+
+uint32_t FSM_TimeInState(const FSM_t *fsm)
+{
+    return fsm->now_ms - fsm->entered_ms;
+}
+
+bool FSM_GetTrace(const FSM_t *fsm, uint8_t age, FSM_Trace_t *out)
+{
+    if (age >= fsm->trace_count) return false;
+    *out = fsm->trace[(fsm->trace_head - 1 - age) & (FSM_TRACE_SIZE - 1)];
+    return true;
+}
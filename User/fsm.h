@@ -0,0 +1,66 @@
+#ifndef __FSM_H
+#define __FSM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  通用表驱动状态机
+// ============================================================
+// 每个状态一行: 进入动作、驻留动作 (每步都执行, 一般用来刷新输出)、超时、迁移表。
+// 迁移表按优先级排列, 每步只检查当前状态自己的那几条, 命中第一条就迁移,
+// 所以每步耗时只和单个状态的迁移数有关 (O(1)), 与状态总数无关。
+// 每次迁移记入环形 trace (时间、起点、终点、原因), 出故障后可以倒查。
+
+#define FSM_TRACE_SIZE      16      // 2 的幂
+#define FSM_REASON_TIMEOUT  0xFF    // trace 里表示 "超时迁移"
+#define FSM_NO_TIMEOUT      0
+
+typedef struct FSM FSM_t;
+
+typedef bool (*FSM_Guard_t)(FSM_t *fsm);
+typedef void (*FSM_Action_t)(FSM_t *fsm);
+
+typedef struct {
+    FSM_Guard_t  guard;         // 条件 (NULL = 无条件)
+    FSM_Action_t action;        // 迁移时执行 (可为 NULL)
+    uint8_t      to;            // 目标状态
+    uint8_t      reason;        // 原因编号 (写入 trace, 由使用者定义)
+} FSM_Transition_t;
+
+typedef struct {
+    FSM_Action_t on_enter;      // 进入时执行一次 (可为 NULL)
+    FSM_Action_t during;        // 每步执行 (迁移判断之后, 可为 NULL)
+    uint32_t     timeout_ms;    // 驻留超过这个时间就去 timeout_to (FSM_NO_TIMEOUT = 不限)
+    uint8_t      timeout_to;
+    uint8_t      n_trans;
+    const FSM_Transition_t *trans;
+} FSM_StateDef_t;
+
+typedef struct {
+    uint32_t t_ms;
+    uint8_t  from;
+    uint8_t  to;
+    uint8_t  reason;
+} FSM_Trace_t;
+
+struct FSM {
+    const FSM_StateDef_t *states;
+    void     *ctx;              // 使用者的上下文 (输入/输出)
+    uint8_t   state;
+    uint32_t  entered_ms;       // 进入当前状态的时刻
+    uint32_t  now_ms;           // 本步时刻 (guard 里用)
+
+    FSM_Trace_t trace[FSM_TRACE_SIZE];
+    uint8_t   trace_head;       // 下一条写入位置
+    uint8_t   trace_count;
+};
+
+void     FSM_Init(FSM_t *fsm, const FSM_StateDef_t *states, uint8_t initial, void *ctx, uint32_t now_ms);
+void     FSM_Step(FSM_t *fsm, uint32_t now_ms);     // 最多迁移一次, 然后执行新状态的 during
+uint32_t FSM_TimeInState(const FSM_t *fsm);
+
+// 取 trace: age = 0 是最近一条; 没有这么多记录返回 false
+bool     FSM_GetTrace(const FSM_t *fsm, uint8_t age, FSM_Trace_t *out);
+
+#endif
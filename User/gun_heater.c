@@ -0,0 +1,274 @@
+#include "gun_heater.h"
+#include "board_config.h"
+
+#define GUN_HEAT_ON()   BOARD_PIN_LOW(GUN_HEATER_PORT, GUN_HEATER_PIN)     // 低电平加热
+#define GUN_HEAT_OFF()  BOARD_PIN_HIGH(GUN_HEATER_PORT, GUN_HEATER_PIN)
+
+#define GATE_PERIOD_US  IRON_PWM_PERIOD     // TIM3 1us 一跳, 1ms 一圈
+
+static volatile uint16_t duty_set = 0;  // 目标占空比 (千分比)
+static uint16_t sd_acc   = 0;           // sigma-delta 累加器
+static volatile bool tripped = false;
+
+static volatile GunFireMode_t fire_mode = GUN_FIRE_BURST;
+static volatile bool    synced = false;     // 过零锁定, 输出由中断驱动
+static bool             half2 = false;      // 整周波的后半波 (BURST 不做判断)
+static bool             cycle_on = false;   // BURST: 本周波通/断
+static bool             tick_on = false;    // 没同步时: 本节拍通/断
+static volatile uint8_t gate_skip = 0;      // PHASE: CH1 比较还要空过几圈才到点
+static volatile bool    gate_open = false;  // PHASE: 门极脉冲已经开始, 下一次比较是关
+static volatile bool    iron_lockout = false;   // 风枪导通期间断开烙铁 (功率仲裁要求峰值不超限)
+
+// 移相触发延时表: 功率 i/32 对应的触发角 (半周期的 1/1024)
+// 半波内从角度 θ 触发得到的功率比例 P = 1 - θ/π + sin(2θ)/(2π), 这里是它的反函数
+static const uint16_t phase_tab[33] = {
+    1024, 849, 800, 765, 736, 711, 688, 667, 648, 629, 611,
+     594, 577, 560, 544, 528, 512, 496, 480, 464, 447, 430,
+     413, 395, 376, 357, 336, 313, 288, 259, 224, 175,   0,
+};
+
+// 导通开始: 先断烙铁再开门极; 导通结束 (过零 / 本节拍不通) 再放开烙铁
+static void Gun_Fire(void)
+{
+    if (iron_lockout) Board_Iron_Lockout(true);
+    GUN_HEAT_ON();
+}
+
+static void Gun_Released(void)
+{
+    if (iron_lockout) Board_Iron_Lockout(false);
+}
+
+static void Gate_Cancel(void)
+{
+    TIM3->DIER &= ~TIM_DIER_CC1IE;
+    gate_open = false;
+    GUN_HEAT_OFF();
+}
+
+void GunHeater_Init(void)
+{
+    duty_set = 0;
+    sd_acc = 0;
+    GUN_HEAT_OFF();
+}
+
+void GunHeater_SetMode(GunFireMode_t mode)
+{
+    if (mode >= GUN_FIRE_COUNT || mode == fire_mode) return;
+
+    // 换模式从头开始: 先断开, 下一个过零按新模式输出
+    __disable_irq();
+    fire_mode = mode;
+    Gate_Cancel();
+    half2 = false;
+    cycle_on = false;
+    __enable_irq();
+}
+
+void GunHeater_SetIronLockout(bool on)
+{
+    if (on == iron_lockout) return;
+    iron_lockout = on;
+    if (!on) Board_Iron_Lockout(false);
+}
+
+void GunHeater_SetDuty(uint16_t duty)
+{
+    if (duty > GUN_DUTY_MAX) duty = GUN_DUTY_MAX;
+    duty_set = duty;
+}
+
+uint16_t GunHeater_GetDuty(void)
+{
+    return duty_set;
+}
+
+bool GunHeater_IsSynced(void)
+{
+    return synced;
+}
+
+// 一阶 sigma-delta: 累加器溢出一次就通一个节拍
+// 例: 占空比 300 -> 每 10 个节拍里均匀地通 3 个
+void GunHeater_Tick(void)
+{
+    if (synced) return;     // 过零中断在管
+
+    tick_on = false;
+    if (tripped) {
+        GUN_HEAT_OFF();
+        Gun_Released();
+        return;
+    }
+
+    sd_acc += duty_set;
+    if (sd_acc >= GUN_DUTY_MAX) {
+        sd_acc -= GUN_DUTY_MAX;
+        tick_on = true;
+        Gun_Fire();
+        if (tripped) GUN_HEAT_OFF();    // 刚好在判断之后跳闸
+    } else {
+        GUN_HEAT_OFF();
+        Gun_Released();
+    }
+}
+
+// 没同步: Tick 已经定了本节拍, 照实回答
+// BURST : 只看本周波在不在通。下一个周波要是在节拍中间开始, 开通那一刻由互锁切掉烙铁;
+//         周波 (>= 16.7ms) 比节拍长, 结束前至少还有一个节拍看到 cycle_on 把烙铁清零,
+//         所以过零沿提前放开互锁时烙铁已经是 0, 不会重叠。连下一个周波一起报的话,
+//         风枪占空比 g 时烙铁要让出约 2g 的节拍
+// PHASE : 每个半波只导通后面一段, 整个节拍让给风枪就太亏了; 返回 false,
+//         烙铁照常分时隙, 导通的那一段由互锁 (iron_lockout) 在硬件上断开
+bool GunHeater_MayConduct(void)
+{
+    if (tripped || duty_set == 0) return false;
+    if (!synced) return tick_on;
+    if (fire_mode == GUN_FIRE_PHASE) return false;
+    return cycle_on;
+}
+
+// 占空比 -> 过零后的触发延时 (us), 0 = 本半波不触发
+static uint16_t Phase_Delay(uint16_t duty, uint16_t half_us)
+{
+    uint32_t x = (uint32_t)duty * 32;
+    uint8_t  i = (uint8_t)(x / GUN_DUTY_MAX);
+    uint32_t q;
+
+    if (i >= 32) {
+        q = phase_tab[32];
+    } else {
+        uint32_t frac = x % GUN_DUTY_MAX;
+        q = phase_tab[i] - (uint32_t)(phase_tab[i] - phase_tab[i + 1]) * frac / GUN_DUTY_MAX;
+    }
+
+    uint32_t d = q * half_us >> 10;
+    if (d < GUN_PHASE_MIN_DELAY_US) d = GUN_PHASE_MIN_DELAY_US;
+    if (d + GUN_PHASE_GUARD_US > half_us) return 0;
+    return (uint16_t)d;
+}
+
+void GunHeater_ZeroCross(uint16_t t_edge, uint16_t zero_us, uint16_t half_us)
+{
+    synced = true;
+
+    // 沿比过零早 ZC_EDGE_LEAD_US, 可控硅电流这时已经接近 0, 上个半波的互锁在这里放开
+    if (tripped || duty_set == 0) {
+        Gate_Cancel();
+        Gun_Released();
+        half2 = false;
+        cycle_on = false;
+        return;
+    }
+
+    if (fire_mode == GUN_FIRE_BURST) {
+        // 整周波: 前半波判断, 后半波照抄
+        if (!half2) {
+            sd_acc += duty_set;
+            cycle_on = (sd_acc >= GUN_DUTY_MAX);
+            if (cycle_on) sd_acc -= GUN_DUTY_MAX;
+        }
+        half2 = !half2;
+        if (cycle_on) {
+            Gun_Fire();
+        } else {
+            GUN_HEAT_OFF();
+            Gun_Released();
+        }
+        if (tripped) GUN_HEAT_OFF();
+        return;
+    }
+
+    // PHASE: 上一个半波的脉冲早就结束了, 这里只排本半波的
+    GUN_HEAT_OFF();
+    Gun_Released();
+    uint16_t d = Phase_Delay(duty_set, half_us);
+    if (d == 0) return;
+
+    // TIM3 每 1ms 一圈, 沿的计数只能说明圈内位置: 按现在离沿过了多久换算成 "从现在起还要等多久"
+    uint16_t now = (uint16_t)TIM3->CNT;
+    uint16_t elapsed = (now >= t_edge) ? now - t_edge : now + GATE_PERIOD_US - t_edge;
+    int32_t  wait = (int32_t)zero_us + d - elapsed;
+    if (wait < 1) wait = 1;
+
+    // CCR1 每圈都会比中一次: 目标时刻拆成 "空过几圈 + 圈内位置" (圈数从 now 所在的圈算)
+    uint32_t t = now + (uint32_t)wait;
+    uint16_t ccr = (uint16_t)(t % GATE_PERIOD_US);
+    uint8_t  skip = (uint8_t)(t / GATE_PERIOD_US);
+
+    TIM3->CCR1 = ccr;
+    TIM3->SR = ~TIM_SR_CC1IF;
+    uint16_t now2 = (uint16_t)TIM3->CNT;
+    bool     hit = (TIM3->SR & TIM_SR_CC1IF) != 0;
+    // 写寄存器期间跨圈了: 圈数改从新的一圈算
+    if (now2 < now && skip) skip--;
+    // 这一圈的比较点在清标志之前就过了: 第一次比中是下一圈
+    if (!hit && now2 >= ccr && skip) skip--;
+    gate_skip = skip;
+    gate_open = false;
+    TIM3->DIER |= TIM_DIER_CC1IE;
+}
+
+void GunHeater_ZeroCrossLost(void)
+{
+    Gate_Cancel();
+    Gun_Released();     // 可控硅最多再导通到本半波结束
+    synced = false;
+    half2 = false;
+    cycle_on = false;
+}
+
+// CH1 比中: 还没到那一圈就空过; 到点开门极, 再把 CCR1 往后推一个脉冲宽度关门极
+// 脉冲跨圈时 CCR1 回绕到比当前计数小, 下一圈才比中, 正好
+void GunHeater_TIM_IRQHandler(void)
+{
+    if (!(TIM3->SR & TIM_SR_CC1IF) || !(TIM3->DIER & TIM_DIER_CC1IE)) return;
+    TIM3->SR = ~TIM_SR_CC1IF;
+
+    if (gate_skip) {
+        gate_skip--;
+        return;
+    }
+
+    if (!gate_open) {
+        if (!tripped) Gun_Fire();
+        gate_open = true;
+        TIM3->CCR1 = (uint16_t)((TIM3->CCR1 + GUN_GATE_PULSE_US) % GATE_PERIOD_US);
+    } else {
+        // 门极关了可控硅还导通到过零, 互锁留到下一个过零沿再放
+        TIM3->DIER &= ~TIM_DIER_CC1IE;
+        gate_open = false;
+        GUN_HEAT_OFF();
+    }
+}
+
+void GunHeater_Off(void)
+{
+    __disable_irq();
+    duty_set = 0;
+    sd_acc = 0;
+    tick_on = false;
+    Gate_Cancel();
+    Gun_Released();
+    half2 = false;
+    cycle_on = false;
+    __enable_irq();
+}
+
+// 只写寄存器 (HardFault 里也会调用)
+void GunHeater_Trip(void)
+{
+    tripped = true;
+    Gate_Cancel();
+}
+
+void GunHeater_ClearTrip(void)
+{
+    tripped = false;
+}
+
+bool GunHeater_IsTripped(void)
+{
+    return tripped;
+}
@@ -0,0 +1,56 @@
+#ifndef __GUN_HEATER_H
+#define __GUN_HEATER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  风枪加热输出 (PB7 -> 光耦/可控硅, 低电平加热)
+// ============================================================
+// 可控硅一旦触发要到过零才关断, 做不了高频 PWM。
+// 过零检测锁定后 (zero_cross.c), 输出完全由过零中断和 TIM3_CH1 比较中断驱动:
+//   BURST : 整周波通断。每两个过零沿 (一个整周波) 做一次 sigma-delta 判断,
+//           通的周波整周波保持门极有效, 正负半波成对出现, 没有直流分量。
+//           过零型光耦 (MOC3041) 和随机相位光耦都能用。
+//   PHASE : 移相触发。每个半波在过零后延时触发一个 GUN_GATE_PULSE_US 的门极脉冲,
+//           延时按正弦功率积分查表, 占空比和实际功率成线性。每个半波都调功率,
+//           分辨率比整周波高得多、温度更平稳; 但必须用随机相位光耦 (MOC3021 之类),
+//           过零型光耦只会在过零附近导通。
+// 没锁定 (没接检测或市电异常) 时退回老办法: 每个控制节拍 (10ms) 做 sigma-delta 决定通断。
+
+#define GUN_DUTY_MAX        1000    // 占空比满量程 (千分比)
+
+#define GUN_GATE_PULSE_US       200     // 移相触发的门极脉冲宽度
+#define GUN_PHASE_MIN_DELAY_US  300     // 过零后至少等这么久 (电压太低可控硅擎住不了)
+#define GUN_PHASE_GUARD_US      800     // 离下一个过零不足这么久就不触发 (脉冲会跨过零)
+
+typedef enum {
+    GUN_FIRE_BURST = 0,
+    GUN_FIRE_PHASE,
+    GUN_FIRE_COUNT
+} GunFireMode_t;
+
+void     GunHeater_Init(void);
+void     GunHeater_SetMode(GunFireMode_t mode);
+void     GunHeater_SetDuty(uint16_t duty);  // 0 ~ GUN_DUTY_MAX
+void     GunHeater_Tick(void);              // 每个控制节拍调用一次 (过零锁定时什么都不做)
+void     GunHeater_Off(void);               // 立即关断并清零累加器
+bool     GunHeater_IsSynced(void);          // 正在按过零同步输出
+bool     GunHeater_MayConduct(void);        // 本节拍风枪在导通 (功率仲裁用; 节拍中间才开始的导通由互锁切掉烙铁; PHASE 返回 false)
+// 导通互锁: 打开后风枪每次导通都先强制关断烙铁 PWM (Board_Iron_Lockout), 导通结束 (过零沿) 再放开。
+// 两路同时开会超过供电上限时由功率仲裁打开 (Pwr_NeedLockout)
+void     GunHeater_SetIronLockout(bool on);
+
+// 由 zero_cross.c 在中断里调用
+void     GunHeater_ZeroCross(uint16_t t_edge, uint16_t zero_us, uint16_t half_us);  // t_edge: 沿的 TIM3 计数, zero_us: 沿之后多久过零
+void     GunHeater_ZeroCrossLost(void);
+void     GunHeater_TIM_IRQHandler(void);    // 在 TIM3_IRQHandler 里调用 (CH1 先开门极, 再关)
+
+// 硬件保护跳闸 (可在中断里调用): 立即关断并锁存, 锁存期间 Tick 不再输出
+// 只有状态机回到 OFF 后由 main 调 GunHeater_ClearTrip 解除
+void     GunHeater_Trip(void);
+void     GunHeater_ClearTrip(void);
+bool     GunHeater_IsTripped(void);
+uint16_t GunHeater_GetDuty(void);
+
+#endif
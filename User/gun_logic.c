@@ -1,86 +1,219 @@
 #include "gun_logic.h"
+#include "fsm.h"
+#include <stdio.h>
 
-// 安全冷却阈值 (比如 ADC 值 200 大约对应 50度，具体看你校准)
-// 暂时假设我们传入的是摄氏度，或者 ADC 值。
-// 这里假设传入的是【ADC值】，假设室温是 0-100，高温是 2000+
-// 为了安全，我们定一个比较低的值，比如 ADC < 100 (接近室温) 才停风扇
-#define SAFE_TEMP_THRESHOLD  100 
+// 安全冷却阈值 (°C)
+// current_temp 传入的是热电偶换算后的摄氏度 (见 thermocouple.c)
+// 为了安全，我们定一个比较低的值，低于 50°C (接近室温) 才停风扇
+#define SAFE_TEMP_THRESHOLD  50 
 
-static GunState_t currentState = GUN_STATE_OFF;
+// 冷却风量曲线: 高于 COOL_FULL_TEMP 全速，降到 SAFE_TEMP_THRESHOLD 时为 COOL_MIN_PERCENT，中间线性
+// 温度越低风扇越慢，冷却后段安静很多，而热的时候仍然全速带走热量
+#define COOL_FULL_TEMP       150
+#define COOL_MIN_PERCENT     30
 
+// 时间参数 (ms)
+#define COOL_MIN_MS          5000       // 冷却至少吹 5s，防止测温点先凉下来而发热丝还烫
+#define COOL_TIMEOUT_MS      600000     // 冷却 10 分钟还降不下来 -> 故障 (测温或风道有问题)
+#define HANDLE_DEBOUNCE_MS   300        // 磁控开关状态保持 300ms 才算数 (手柄晃动不会来回切)
+
+static uint8_t Cooling_FanPercent(uint16_t temp)
+{
+    if (temp >= COOL_FULL_TEMP) return 100;
+    if (temp <= SAFE_TEMP_THRESHOLD) return COOL_MIN_PERCENT;
+    return (uint8_t)(COOL_MIN_PERCENT + (uint32_t)(100 - COOL_MIN_PERCENT) * (temp - SAFE_TEMP_THRESHOLD)
+                                        / (COOL_FULL_TEMP - SAFE_TEMP_THRESHOLD));
+}
+
+// ============================================================
+//  状态机上下文
+// ============================================================
+typedef struct {
+    const GunInputs_t *in;
+    GunOutputs_t out;
+    bool     handle_up;         // 消抖后的手柄状态
+    uint32_t handle_change_ms;  // 原始手柄信号最近一次变化的时刻
+    bool     handle_raw;
+    bool     wait_release;      // 曲线跑完后要先放回手柄 (或关开关) 才能再加热
+} GunCtx_t;
+
+static GunCtx_t gun_ctx;
+static FSM_t    gun_fsm;
+
+#define CTX(f)  ((GunCtx_t *)(f)->ctx)
+
+// 迁移原因 (写入 trace)
+enum {
+    RSN_START = 0,      // 开关开 + 手柄拿起
+    RSN_HOT,            // 关机状态下检测到余热
+    RSN_SW_OFF,         // 关开关
+    RSN_HANDLE_DOWN,    // 手柄放回
+    RSN_RESUME,         // 冷却中又拿起来用
+    RSN_COOLED,         // 凉透了
+    RSN_FAN_LOCK,       // 风扇堵转
+    RSN_ACK,            // 故障后用户关开关确认
+    RSN_PROFILE_DONE,   // 温度曲线跑完
+    RSN_FAULT,          // 安全监控报故障 (任一通道)
+    RSN_COUNT
+};
+
+static const char *const rsn_names[RSN_COUNT] = {
+    "start", "hot", "sw_off", "handle_down", "resume", "cooled", "fan_lock", "ack", "profile_done", "fault"
+};
+static const char *const state_names[] = { "OFF", "HEAT", "COOL", "ERROR" };
+
+// ============================================================
+//  条件
+// ============================================================
+// 堵转锁存还没解除时不许开始加热; 曲线跑完后手柄还在手上也不许 (否则冷却一拍就按 gun_target 重新加热)
+static bool G_Start(FSM_t *f)
+{
+    return CTX(f)->in->sw_is_on && CTX(f)->handle_up && !CTX(f)->in->fan_locked && !CTX(f)->wait_release;
+}
+static bool G_Hot(FSM_t *f)        { return CTX(f)->in->current_temp > SAFE_TEMP_THRESHOLD; }
+static bool G_SwOff(FSM_t *f)      { return !CTX(f)->in->sw_is_on; }
+static bool G_HandleDown(FSM_t *f) { return !CTX(f)->handle_up; }
+static bool G_FanLock(FSM_t *f)    { return CTX(f)->in->fan_locked; }
+static bool G_Fault(FSM_t *f)      { return CTX(f)->in->fault; }
+// 故障确认: 关开关, 且监控那边的故障已经解除
+static bool G_Ack(FSM_t *f)        { return !CTX(f)->in->sw_is_on && !CTX(f)->in->fault; }
+// 确认时还烫: 直接去冷却 (先回 OFF 的话风扇会停一拍)
+static bool G_AckHot(FSM_t *f)     { return G_Ack(f) && G_Hot(f) && !CTX(f)->in->fan_locked; }
+static bool G_ProfileDone(FSM_t *f) { return CTX(f)->in->profile_done; }
+
+// 温度降下来且吹够了最短时间
+static bool G_Cooled(FSM_t *f)
+{
+    return CTX(f)->in->current_temp < SAFE_TEMP_THRESHOLD && FSM_TimeInState(f) >= COOL_MIN_MS;
+}
+
+// ============================================================
+//  迁移动作
+// ============================================================
+static void A_ProfileDone(FSM_t *f) { CTX(f)->wait_release = true; }
+
+// ============================================================
+//  各状态输出 (每步刷新)
+// ============================================================
+static void Out_Off(FSM_t *f)
+{
+    GunOutputs_t *o = &CTX(f)->out;
+    o->fan_on = false;
+    o->fan_percent = 0;
+    o->heat_enable = false;
+}
+
+static void Out_Heating(FSM_t *f)
+{
+    GunOutputs_t *o = &CTX(f)->out;
+    uint8_t pct = CTX(f)->in->airflow;
+    if (pct < GUN_AIRFLOW_MIN) pct = GUN_AIRFLOW_MIN;
+    if (pct > GUN_AIRFLOW_MAX) pct = GUN_AIRFLOW_MAX;
+
+    o->fan_on = true;
+    o->fan_percent = pct;
+    o->heat_enable = true;  // 允许 PID 介入 (main 里按 PID 占空比通断)
+}
+
+// 故障: 停加热; 风扇没堵就全速吹 (传感器坏了不知道多热, 按最烫处理)
+static void Out_Error(FSM_t *f)
+{
+    GunOutputs_t *o = &CTX(f)->out;
+    bool fan_ok = !CTX(f)->in->fan_locked;
+    o->fan_on = fan_ok;
+    o->fan_percent = fan_ok ? 100 : 0;
+    o->heat_enable = false;
+}
+
+static void Out_Cooling(FSM_t *f)
+{
+    GunOutputs_t *o = &CTX(f)->out;
+    o->fan_on = true;       // 必须吹风！
+    o->fan_percent = Cooling_FanPercent(CTX(f)->in->current_temp);
+    o->heat_enable = false; // 严禁加热
+}
+
+// ============================================================
+//  状态表 (迁移按优先级排列，故障检查永远放第一条)
+// ============================================================
+static const FSM_Transition_t tr_off[] = {
+    { G_Fault,      NULL, GUN_STATE_ERROR,   RSN_FAULT },
+    { G_Start,      NULL, GUN_STATE_HEATING, RSN_START },
+    { G_Hot,        NULL, GUN_STATE_COOLING, RSN_HOT },     // 余热: 哪怕关机也要先吹凉
+};
+
+static const FSM_Transition_t tr_heating[] = {
+    { G_FanLock,    NULL, GUN_STATE_ERROR,   RSN_FAN_LOCK },    // 加热在测速中断里已经先断了
+    { G_Fault,      NULL, GUN_STATE_ERROR,   RSN_FAULT },       // 加热在监控任务里已经先断了
+    { G_SwOff,      NULL, GUN_STATE_COOLING, RSN_SW_OFF },
+    { G_HandleDown, NULL, GUN_STATE_COOLING, RSN_HANDLE_DOWN },
+    { G_ProfileDone, A_ProfileDone, GUN_STATE_COOLING, RSN_PROFILE_DONE },
+};
+
+static const FSM_Transition_t tr_cooling[] = {
+    { G_FanLock,    NULL, GUN_STATE_ERROR,   RSN_FAN_LOCK },
+    { G_Fault,      NULL, GUN_STATE_ERROR,   RSN_FAULT },
+    { G_Start,      NULL, GUN_STATE_HEATING, RSN_RESUME },  // 还没凉透就又拿起来用 -> 立即回加热
+    { G_Cooled,     NULL, GUN_STATE_OFF,     RSN_COOLED },
+};
+
+// 故障锁存: 只有用户把开关关掉 (确认故障) 才解除, 按温度回 OFF 或冷却
+static const FSM_Transition_t tr_error[] = {
+    { G_AckHot,     NULL, GUN_STATE_COOLING, RSN_ACK },
+    { G_Ack,        NULL, GUN_STATE_OFF,     RSN_ACK },
+};
+
+#define N(a)    (uint8_t)(sizeof(a) / sizeof(a[0]))
+
+static const FSM_StateDef_t gun_states[] = {
+    [GUN_STATE_OFF]     = { NULL, Out_Off,     FSM_NO_TIMEOUT,  0,               N(tr_off),     tr_off },
+    [GUN_STATE_HEATING] = { NULL, Out_Heating, FSM_NO_TIMEOUT,  0,               N(tr_heating), tr_heating },
+    [GUN_STATE_COOLING] = { NULL, Out_Cooling, COOL_TIMEOUT_MS, GUN_STATE_ERROR, N(tr_cooling), tr_cooling },
+    [GUN_STATE_ERROR]   = { NULL, Out_Error,   FSM_NO_TIMEOUT,  0,               N(tr_error),   tr_error },
+};
+
+// ============================================================
+//  对外接口
+// ============================================================
 void Gun_FSM_Init(void) {
-    currentState = GUN_STATE_OFF;
+    gun_ctx.in = NULL;
+    gun_ctx.handle_up = false;
+    gun_ctx.handle_raw = false;
+    gun_ctx.handle_change_ms = 0;
+    gun_ctx.wait_release = false;
+    FSM_Init(&gun_fsm, gun_states, GUN_STATE_OFF, &gun_ctx, 0);
+    Out_Off(&gun_fsm);
 }
 
 GunOutputs_t Gun_FSM_Run(GunInputs_t *in) {
-    GunOutputs_t out = {0};
-
-    switch (currentState) {
-        // --- 1. 关机/待机状态 ---
-        case GUN_STATE_OFF:
-            out.fan_on = false;
-            out.heat_enable = false;
-
-            // 状态流转:
-            // 如果 [开关开了] 且 [手柄拿起来了] -> 进加热
-            if (in->sw_is_on && in->handle_is_up) {
-                currentState = GUN_STATE_HEATING;
-            }
-            // 如果 [开关开了] 但 [手柄在架子上] -> 保持 OFF (或者叫待机)
-            // 如果 [余热检测]：哪怕是关机状态，如果检测到温度异常高，也得强行切到冷却
-            if (in->current_temp > SAFE_TEMP_THRESHOLD) {
-                currentState = GUN_STATE_COOLING;
-            }
-            break;
-
-        // --- 2. 加热工作状态 ---
-        case GUN_STATE_HEATING:
-            out.fan_on = true;
-            out.heat_enable = true; // 允许 PID 介入
-
-            // 状态流转:
-            // 如果 [开关关了] -> 进冷却
-            if (!in->sw_is_on) {
-                currentState = GUN_STATE_COOLING;
-            }
-            // 如果 [手柄放回架子] -> 进冷却
-            else if (!in->handle_is_up) {
-                currentState = GUN_STATE_COOLING;
-            }
-            break;
-
-        // --- 3. 冷却状态 (最关键的安全逻辑) ---
-        case GUN_STATE_COOLING:
-            out.fan_on = true;       // 必须吹风！
-            out.heat_enable = false; // 严禁加热
-
-            // 状态流转:
-            // 只有当 [温度足够低] 时，才允许根据开关状态决定去向
-            if (in->current_temp < SAFE_TEMP_THRESHOLD) {
-                if (in->sw_is_on && in->handle_is_up) {
-                    // 还没凉透你就又拿起来用了 -> 重新加热
-                    currentState = GUN_STATE_HEATING;
-                } else {
-                    // 凉透了，且没用车 -> 彻底关机
-                    currentState = GUN_STATE_OFF;
-                }
-            } 
-            // 如果温度还高，就死锁在这个状态，谁也别想关风扇
-            else {
-                // 如果此时用户又把手柄拿起来准备干活 (且开关开着)
-                // 允许立即打断冷却，切回加热 (体验更好)
-                if (in->sw_is_on && in->handle_is_up) {
-                    currentState = GUN_STATE_HEATING;
-                }
-            }
-            break;
-            
-        case GUN_STATE_ERROR:
-            out.fan_on = false;
-            out.heat_enable = false;
-            break;
+    gun_ctx.in = in;
+
+    // 手柄消抖: 原始信号保持 HANDLE_DEBOUNCE_MS 不变才采纳
+    if (in->handle_is_up != gun_ctx.handle_raw) {
+        gun_ctx.handle_raw = in->handle_is_up;
+        gun_ctx.handle_change_ms = in->now_ms;
+    } else if (in->now_ms - gun_ctx.handle_change_ms >= HANDLE_DEBOUNCE_MS) {
+        gun_ctx.handle_up = gun_ctx.handle_raw;
     }
+    if (!gun_ctx.handle_up || !in->sw_is_on) gun_ctx.wait_release = false;
+
+    FSM_Step(&gun_fsm, in->now_ms);
+
+    gun_ctx.out.state = (GunState_t)gun_fsm.state;
+    return gun_ctx.out;
+}
+
+GunState_t Gun_FSM_GetState(void) {
+    return (GunState_t)gun_fsm.state;
+}
 
-    out.state = currentState;
-    return out;
+// 打印最近的迁移记录 (从旧到新)
+void Gun_FSM_DumpTrace(void) {
+    FSM_Trace_t t;
+    for (int age = FSM_TRACE_SIZE - 1; age >= 0; age--) {
+        if (!FSM_GetTrace(&gun_fsm, (uint8_t)age, &t)) continue;
+        printf("  %lu ms: %s -> %s (%s)\r\n", (unsigned long)t.t_ms,
+               state_names[t.from], state_names[t.to],
+               (t.reason == FSM_REASON_TIMEOUT) ? "timeout" : rsn_names[t.reason]);
+    }
 }
@@ -9,26 +9,36 @@ typedef enum {
     GUN_STATE_OFF = 0,      // 彻底关机 (风扇停，加热停)
     GUN_STATE_HEATING,      // 正常工作 (风扇转，PID控制)
     GUN_STATE_COOLING,      // 冷却模式 (风扇转，加热停) - 比如放回架子，或关机后余热未散
-    GUN_STATE_ERROR         // 故障 (如风扇堵转)
+    GUN_STATE_ERROR         // 故障 (风扇堵转 / 传感器故障 / 热失控)
 } GunState_t;
 
 // 输入信号 (传感器 + 开关)
 typedef struct {
-    uint16_t current_temp;  // 当前温度 (ADC值或摄氏度)
+    uint16_t current_temp;  // 当前温度 (°C)
     bool     sw_is_on;      // 总开关是否开启 (1=开, 0=关)
     bool     handle_is_up;  // 手柄是否拿起来 (1=拿起, 0=在架子上)
-    bool     fan_locked;    // (选配) 风扇是否堵转
+    bool     fan_locked;    // 风扇堵转 (测速中断锁存, 见 tach.c)
+    uint8_t  airflow;       // 加热时的风量设定 (%)
+    bool     profile_done;  // 温度曲线跑完 (见 profile.h), 加热结束转冷却
+    bool     fault;         // 安全监控判定的故障 (见 supervisor.h), 锁存期间强制 ERROR
+    uint32_t now_ms;        // 当前时刻 (HAL_GetTick)，用于冷却最短时间/手柄消抖/超时
 } GunInputs_t;
 
 // 输出控制 (告诉 main 函数该干嘛)
 typedef struct {
     bool     fan_on;        // 是否开风扇
-    bool     heat_enable;   // 是否允许加热 (PID计算的前提)
+    uint8_t  fan_percent;   // 风扇转速 (%)，fan_on 为假时为 0
+    bool     heat_enable;   // 是否允许加热 (为假时 main 强制关断并复位 PID)
     GunState_t state;       // 当前状态 (用于显示屏判断显示内容)
 } GunOutputs_t;
 
+#define GUN_AIRFLOW_MIN     20      // 加热时最低风量 (%)，风太小发热丝会烧
+#define GUN_AIRFLOW_MAX     100
+
 // 核心函数
 void Gun_FSM_Init(void);
 GunOutputs_t Gun_FSM_Run(GunInputs_t *inputs);
+GunState_t Gun_FSM_GetState(void);
+void Gun_FSM_DumpTrace(void);   // 打印最近的状态迁移记录 (故障后倒查用)
 
 #endif
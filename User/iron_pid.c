@@ -44,3 +44,78 @@ double PID_Compute(PIDController *pid, double setpoint, double measurement) {
 
     return pid->out;
 }
+
+
+// ==========================================
+//  定点版 PID (Q16.16)
+// ==========================================
+void PIDQ_Init(PIDControllerQ16 *pid) {
+    pid->integrator      = 0;
+    pid->prevError       = 0;
+    pid->differentiator  = 0;
+    pid->prevMeasurement = 0;
+    pid->out             = 0;
+}
+
+// 修改 Kp/Ki/Kd 或 T 之后必须调用一次 (这里有 64 位除法, 不要放进控制循环)
+void PIDQ_SetTunings(PIDControllerQ16 *pid, q16_t Kp, q16_t Ki, q16_t Kd) {
+    int64_t den = 2 * (int64_t)PID_D_FILTER_TAU + pid->T;   // Q16
+
+    pid->Kp = Kp;
+    pid->Ki = Ki;
+    pid->Kd = Kd;
+
+    // 0.5 * Ki * T : Q16 * Q16 = Q32, 右移 2 位 → Q30 (再乘 0.5 即多移 1 位)
+    pid->kiT = (int32_t)(((int64_t)Ki * pid->T) >> 3);
+    pid->kdA = (int32_t)((2 * (int64_t)Kd * Q16_ONE) / den);
+    pid->kdB = (int32_t)(((2 * (int64_t)PID_D_FILTER_TAU - pid->T) * (1LL << 30)) / den);
+}
+
+int32_t PIDQ_Compute(PIDControllerQ16 *pid, int32_t setpoint, int32_t measurement) {
+    int32_t error = setpoint - measurement;
+
+    // 1. 比例项 (Q16)
+    int64_t proportional = (int64_t)pid->Kp * error;
+
+    // 2. 积分项 (梯形积分, Q30 系数 * 整数误差 → 右移 14 位得到 Q16)
+    int64_t integrator = pid->integrator
+                       + (((int64_t)pid->kiT * (error + pid->prevError)) >> 14);
+
+    // 积分限幅 (防止积分饱和/Windup)
+    int64_t limMaxInt = (int64_t)pid->limMaxInt * Q16_ONE;
+    int64_t limMinInt = (int64_t)pid->limMinInt * Q16_ONE;
+    if (integrator > limMaxInt) {
+        integrator = limMaxInt;
+    } else if (integrator < limMinInt) {
+        integrator = limMinInt;
+    }
+    pid->integrator = (q16_t)integrator;
+
+    // 3. 微分项 (测量值微分 + 一阶低通, 与 double 版本同一个差分方程)
+    pid->differentiator = (q16_t)(-((int64_t)pid->kdA * (measurement - pid->prevMeasurement)
+                                  + (((int64_t)pid->kdB * pid->differentiator) >> 30)));
+
+    // 总输出 (Q16 → 整数, 四舍五入)
+    int64_t out = (proportional + pid->integrator + pid->differentiator + (Q16_ONE / 2)) >> 16;
+
+    // 输出限幅
+    if (out > pid->limMax) {
+        out = pid->limMax;
+    } else if (out < pid->limMin) {
+        out = pid->limMin;
+    }
+    pid->out = (int32_t)out;
+
+    pid->prevError       = error;
+    pid->prevMeasurement = measurement;
+
+    return pid->out;
+}
+
+// 把积分项设成 value (与输出同单位), 受积分限幅约束
+// 积分项在稳态时就等于维持温度所需的输出, 预载后不用再从 0 慢慢累积
+void PIDQ_Preload(PIDControllerQ16 *pid, int32_t value) {
+    if (value > pid->limMaxInt) value = pid->limMaxInt;
+    if (value < pid->limMinInt) value = pid->limMinInt;
+    pid->integrator = (q16_t)((int64_t)value * Q16_ONE);
+}
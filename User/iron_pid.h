@@ -25,4 +25,47 @@ typedef struct {
 void PID_Init(PIDController *pid);
 double PID_Compute(PIDController *pid, double setpoint, double measurement);
 
+// ==========================================
+//  定点版 PID (Q16.16, M0+ 没有 FPU)
+// ==========================================
+// 算法与 PID_Compute 完全一致: 梯形积分 + 积分限幅 + 测量值微分(一阶低通)。
+// CMSIS-DSP 的 arm_pid_q15/q31 是增量式的, 没有积分限幅和测量值微分, 所以这里自己实现。
+// 系数在 PIDQ_SetTunings 里一次算好, 运行时只有整数乘加, 不链接软浮点库。
+typedef int32_t q16_t;
+
+#define Q16_ONE             65536
+// 编译期常量转换, 例如 Q16(0.05)。不要对运行时变量使用 (会引入浮点)
+#define Q16(x)              ((q16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+// 微分低通时间常数 (秒), 与 double 版本里的 0.01f 相同
+#define PID_D_FILTER_TAU    Q16(0.01)
+
+typedef struct {
+    q16_t   Kp;              // 比例系数 (Q16)
+    q16_t   Ki;              // 积分系数 (Q16)
+    q16_t   Kd;              // 微分系数 (Q16)
+    int32_t limMin;          // 输出下限 (整数, 如 0)
+    int32_t limMax;          // 输出上限 (整数, 如 1000)
+    int32_t limMinInt;       // 积分限制下限 (整数)
+    int32_t limMaxInt;       // 积分限制上限 (整数)
+    q16_t   T;               // 采样周期 (秒, Q16)
+
+    // 预计算系数 (PIDQ_SetTunings 生成)
+    int32_t kiT;             // 0.5 * Ki * T          (Q30)
+    int32_t kdA;             // 2 * Kd / (2tau + T)    (Q16)
+    int32_t kdB;             // (2tau - T) / (2tau + T)(Q30)
+
+    // 运行时变量 (Q16)
+    q16_t   integrator;
+    int32_t prevError;       // 上一次误差 (整数, 与输入同单位)
+    q16_t   differentiator;
+    int32_t prevMeasurement;
+    int32_t out;             // 计算结果 (整数)
+} PIDControllerQ16;
+
+void    PIDQ_Init(PIDControllerQ16 *pid);
+void    PIDQ_SetTunings(PIDControllerQ16 *pid, q16_t Kp, q16_t Ki, q16_t Kd);
+int32_t PIDQ_Compute(PIDControllerQ16 *pid, int32_t setpoint, int32_t measurement);
+void    PIDQ_Preload(PIDControllerQ16 *pid, int32_t value);  // 直接设定积分项 (输出单位), 用于前馈
+
 #endif
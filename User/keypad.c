@@ -0,0 +1,91 @@
+#include "keypad.h"
+#include "tm1637.h"
+#include "py32f0xx_hal.h"
+
+// 事件环形缓冲区: 中断写 head，主循环读 tail (单生产者/单消费者，无需关中断)
+static KeyEvent_t key_queue[KEY_QUEUE_SIZE];
+static volatile uint8_t key_head = 0;
+static volatile uint8_t key_tail = 0;
+
+// 消抖状态
+static uint8_t  raw_last    = KEY_CODE_NONE;  // 上一次原始读数
+static uint8_t  raw_count   = 0;              // 原始读数连续一致的次数
+static uint8_t  key_stable  = KEY_CODE_NONE;  // 消抖后的按键
+static uint32_t press_time  = 0;
+static uint32_t repeat_time = 0;
+static bool     long_sent   = false;
+
+static void Keypad_Push(uint8_t code, KeyEventType_t type)
+{
+    uint8_t next = (key_head + 1) & (KEY_QUEUE_SIZE - 1);
+    if (next == key_tail) {
+        return; // 队列满，丢弃 (UI 跟不上时不要阻塞中断)
+    }
+    key_queue[key_head].code = code;
+    key_queue[key_head].type = type;
+    key_head = next;
+}
+
+static void Keypad_OnRaw(uint8_t raw)
+{
+    Keypad_Feed(raw, HAL_GetTick());
+}
+
+void Keypad_Init(void)
+{
+    key_head = key_tail = 0;
+    TM1637_SetKeyCallback(Keypad_OnRaw);
+}
+
+void Keypad_Feed(uint8_t raw, uint32_t now_ms)
+{
+    // 1. 消抖: 连续 KEY_DEBOUNCE_SCANS 次一致才更新稳定值
+    if (raw == raw_last) {
+        if (raw_count < KEY_DEBOUNCE_SCANS) raw_count++;
+    } else {
+        raw_last = raw;
+        raw_count = 1;
+    }
+    if (raw_count < KEY_DEBOUNCE_SCANS) {
+        return;
+    }
+
+    // 2. 边沿: 按下 / 松开 / 换键
+    if (raw != key_stable) {
+        if (key_stable != KEY_CODE_NONE) {
+            Keypad_Push(key_stable, KEY_EVT_RELEASE);
+        }
+        key_stable = raw;
+        if (raw != KEY_CODE_NONE) {
+            press_time = now_ms;
+            long_sent = false;
+            Keypad_Push(raw, KEY_EVT_PRESS);
+        }
+        return;
+    }
+
+    // 3. 持续按住: 长按 + 连发
+    if (key_stable == KEY_CODE_NONE) {
+        return;
+    }
+    if (!long_sent) {
+        if (now_ms - press_time >= KEY_LONG_MS) {
+            long_sent = true;
+            repeat_time = now_ms;
+            Keypad_Push(key_stable, KEY_EVT_LONG);
+        }
+    } else if (now_ms - repeat_time >= KEY_REPEAT_MS) {
+        repeat_time = now_ms;
+        Keypad_Push(key_stable, KEY_EVT_REPEAT);
+    }
+}
+
+bool Keypad_GetEvent(KeyEvent_t *evt)
+{
+    if (key_tail == key_head) {
+        return false;
+    }
+    *evt = key_queue[key_tail];
+    key_tail = (key_tail + 1) & (KEY_QUEUE_SIZE - 1);
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef __KEYPAD_H
+#define __KEYPAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ==========================================
+//  按键事件 (TM1637 键扫 -> 消抖 -> 事件队列)
+// ==========================================
+#define KEY_CODE_NONE       0xFF    // TM1637 读回 0xFF 表示没有按键
+
+#define KEY_DEBOUNCE_SCANS  2       // 连续 N 次扫描一致才算数 (UI 20Hz 扫描 -> 50~100ms)
+#define KEY_LONG_MS         500     // 按住超过 500ms 算长按
+#define KEY_REPEAT_MS       100     // 长按后每 100ms 连发一次
+#define KEY_QUEUE_SIZE      8       // 事件队列长度 (2 的幂)
+
+typedef enum {
+    KEY_EVT_PRESS = 0,  // 刚按下 (短按)
+    KEY_EVT_LONG,       // 长按触发 (按住 KEY_LONG_MS)
+    KEY_EVT_REPEAT,     // 长按连发
+    KEY_EVT_RELEASE     // 松开
+} KeyEventType_t;
+
+typedef struct {
+    uint8_t code;       // TM1637 键码
+    uint8_t type;       // KeyEventType_t
+} KeyEvent_t;
+
+void Keypad_Init(void);
+
+// 喂入一次原始键码 (在 TM1637 读键完成的中断里调用)
+void Keypad_Feed(uint8_t raw, uint32_t now_ms);
+
+// 取出一个事件 (主循环调用)，没有事件返回 false
+bool Keypad_GetEvent(KeyEvent_t *evt);
+
+#endif
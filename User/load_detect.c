@@ -0,0 +1,42 @@
+#include "load_detect.h"
+#include <string.h>
+
+void LoadDetect_Init(LoadDetect_t *ld)
+{
+    memset(ld, 0, sizeof(*ld));
+}
+
+void LoadDetect_Start(LoadDetect_t *ld)
+{
+    ld->active = true;
+    ld->hold_ms = 0;
+}
+
+bool LoadDetect_Update(LoadDetect_t *ld, int32_t temp, int32_t err, uint16_t period_ms)
+{
+    // hist[idx] 是一个窗口之前的温度
+    int32_t old = ld->hist[ld->idx];
+    ld->hist[ld->idx] = (int16_t)temp;
+    if (++ld->idx >= LOAD_WINDOW_TICKS) {
+        ld->idx = 0;
+        ld->filled = 1;
+    }
+    if (!ld->filled) return false;  // 窗口没填满, 斜率还不可信
+
+    int32_t d = (temp - old) * 1000 / (LOAD_WINDOW_TICKS * (int32_t)period_ms);
+    ld->slope += (d - ld->slope) / 4;
+
+    if (!ld->active) {
+        if (ld->slope < LOAD_SLOPE_TRIG && err > LOAD_ERR_MIN) {
+            ld->active = true;
+            ld->hold_ms = 0;
+        }
+    } else if (err < LOAD_ERR_MIN && err > -LOAD_ERR_MIN) {
+        // 增强参数下积分跟着烙铁头的吸热走, 稳住一段时间后积分就是新的稳态值, 再切回原参数
+        ld->hold_ms += period_ms;
+        if (ld->hold_ms >= LOAD_HOLD_MS) ld->active = false;
+    } else {
+        ld->hold_ms = 0;
+    }
+    return ld->active;
+}
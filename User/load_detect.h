@@ -0,0 +1,38 @@
+#ifndef __LOAD_DETECT_H
+#define __LOAD_DETECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  烙铁热负载检测 (平滑 dT/dt)
+// ============================================================
+// 烙铁头碰到大面积铺铜时温度会突然往下掉。普通 PID 要等误差变大才加功率,
+// 这里看温度的变化率: 低于设定点且在快速下降 -> 判定为 "有负载", 由调用者切换到增强参数;
+// 温度回到设定点 ±1°C 内并保持 LOAD_HOLD_MS -> 恢复正常。一回到设定点就退出的话,
+// 烙铁头还在吸热, 增强期间攒的积分跟不上, 温度又往下掉, 原来的 Ki 要很久才补回来。
+// 变化率取 100ms 窗口的差分再做一阶低通, ADC 噪声不会误触发。
+
+#define LOAD_WINDOW_TICKS   10      // 差分窗口 (控制周期数)
+#define LOAD_SLOPE_TRIG     (-20)   // 下降快于 2°C/s 判为负载 (0.1°C/s)
+#define LOAD_ERR_MIN        10      // 且至少低于设定点 1°C (0.1°C); 恢复也以此为界
+#define LOAD_HOLD_MS        3000    // 在 ±LOAD_ERR_MIN 内保持这么久才退出增强
+
+typedef struct {
+    int16_t  hist[LOAD_WINDOW_TICKS];   // 最近一个窗口的温度
+    uint8_t  idx;
+    uint8_t  filled;
+    int32_t  slope;                     // 平滑后的 dT/dt (0.1°C/s)
+    uint16_t hold_ms;                   // 增强中已在 ±LOAD_ERR_MIN 内的时间
+    bool     active;                    // 当前是否处于负载增强
+} LoadDetect_t;
+
+void LoadDetect_Init(LoadDetect_t *ld);
+// 不等斜率判定, 直接进入增强 (升温到点交接时用, 退出条件不变)
+void LoadDetect_Start(LoadDetect_t *ld);
+
+// 每个控制周期调用一次: temp 为实测温度, err = 设定 - 实测 (都是 0.1°C)
+// 返回是否处于负载增强状态
+bool LoadDetect_Update(LoadDetect_t *ld, int32_t temp, int32_t err, uint16_t period_ms);
+
+#endif
@@ -0,0 +1,193 @@
+#include "lowpower.h"
+#include "board_config.h"
+#include "supervisor.h"
+#include "comp_trip.h"
+#include "gun_heater.h"
+#include "scheduler.h"
+
+extern __IO uint32_t uwTick;    // HAL 的毫秒计数 (py32f0xx_hal.c), 头文件里没有声明
+
+#define LP_LPTIM_HZ         (LSI_VALUE / 128)                   // 256Hz, 一跳约 3.9ms
+#define LP_SLICE_TICKS      (LP_SLICE_MS * LP_LPTIM_HZ / 1000)
+#define LP_LATENCY_MAX_US   5000000UL   // 醒来 5s 内没加热就不算 "唤醒延迟" (只是拧了一下旋钮看看)
+
+static LPTIM_HandleTypeDef hlptim;
+static LowPowerStats_t stats;
+
+static uint16_t          wake_mask = 0;         // 唤醒引脚对应的 EXTI 线
+static volatile uint16_t wake_lines = 0;        // 本次睡眠里触发过的唤醒线
+static volatile bool     slice_done = false;    // LPTIM 单次定时到点
+static bool              latency_pending = false;
+
+static const struct {
+    GPIO_TypeDef *port;
+    uint16_t      pin;
+} wake_pins[] = {
+    { IRON_SW_PORT,  IRON_SW_PIN  },
+    { GUN_SW_PORT,   GUN_SW_PIN   },
+    { GUN_REED_PORT, GUN_REED_PIN },
+    { ENC_A_PORT,    ENC_A_PIN    },
+    { ENC_B_PORT,    ENC_B_PIN    },
+    { CMD_RX_PORT,   CMD_RX_PIN   },
+};
+
+void LowPower_Init(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_PeriphCLKInitTypeDef clk = {0};
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_LPTIM_CLK_ENABLE();
+
+    // LPTIM 用 LSI (看门狗启动后 LSI 也会开, 这里不依赖初始化顺序)
+    osc.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+    osc.LSIState = RCC_LSI_ON;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+    {
+        while(1);
+    }
+    clk.PeriphClockSelection = RCC_PERIPHCLK_LPTIM;
+    clk.LptimClockSelection = RCC_LPTIMCLKSOURCE_LSI;
+    if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK)
+    {
+        while(1);
+    }
+
+    hlptim.Instance = LPTIM1;
+    hlptim.Init.Prescaler = LPTIM_PRESCALER_DIV128;
+    hlptim.Init.UpdateMode = LPTIM_UPDATE_IMMEDIATE;
+    if (HAL_LPTIM_Init(&hlptim) != HAL_OK)
+    {
+        while(1);
+    }
+    HAL_NVIC_SetPriority(LPTIM1_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+    // 唤醒引脚接到 EXTI (双边沿), 引脚本身的模式 (输入/复用) 不动, EXTI 照样能看到电平
+    // 醒着的时候屏蔽: 开关/编码器平时由各自的任务读, 不需要中断
+    for (uint8_t i = 0; i < sizeof(wake_pins) / sizeof(wake_pins[0]); i++) {
+        uint16_t pin = wake_pins[i].pin;
+        uint8_t  line = 0;
+        while (!(pin & (1u << line))) line++;
+
+        uint32_t shift = 8u * (line & 0x03u);
+        MODIFY_REG(EXTI->EXTICR[line >> 2], 0xFFu << shift, GPIO_GET_INDEX(wake_pins[i].port) << shift);
+        wake_mask |= pin;
+    }
+    EXTI->IMR  &= ~wake_mask;
+    EXTI->EMR  &= ~wake_mask;
+    EXTI->RTSR |= wake_mask;
+    EXTI->FTSR |= wake_mask;
+
+    HAL_NVIC_SetPriority(EXTI2_3_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(EXTI2_3_IRQn);
+    HAL_NVIC_SetPriority(EXTI4_15_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(EXTI4_15_IRQn);
+}
+
+// LPTIM 计数在 LSI 时钟域, 连读两次一样才可信
+static uint32_t LPTIM_ReadCount(void)
+{
+    uint32_t a, b;
+    do {
+        a = LPTIM1->CNT;
+        b = LPTIM1->CNT;
+    } while (a != b);
+    return a;
+}
+
+uint16_t LowPower_Sleep(void)
+{
+    uint32_t imr = EXTI->IMR;
+    uint32_t slept = 0;
+
+    // 睡眠循环只喂狗不跑任务, 没人看着加热输出: 进来先把两路在硬件上断掉,
+    // 不依赖调用者有没有关干净。醒来时没有新的跳闸才撤销
+    bool gun_tripped = GunHeater_IsTripped();
+    Board_Heaters_Cut();
+
+    // 过零屏蔽, 唤醒引脚清掉旧的挂起再打开
+    wake_lines = 0;
+    EXTI->PR = wake_mask;
+    EXTI->IMR = (imr & ~(uint32_t)GUN_ZC_PIN) | wake_mask;
+
+    // 中断使能只能在 LPTIM 关着时写; 使能后要等几个 LSI 周期才能写 ARR (同 LPTIM 唤醒例程)
+    __HAL_LPTIM_CLEAR_FLAG(&hlptim, LPTIM_FLAG_ARRM);
+    __HAL_LPTIM_ENABLE_IT(&hlptim, LPTIM_IT_ARRM);
+    __HAL_LPTIM_ENABLE(&hlptim);
+    HAL_Delay(1);
+    __HAL_LPTIM_AUTORELOAD_SET(&hlptim, LP_SLICE_TICKS);
+    HAL_SuspendTick();
+
+    slice_done = true;
+    while (wake_lines == 0) {
+        if (slice_done) {
+            slice_done = false;
+            Sup_WatchdogKick();
+            __HAL_LPTIM_START_SINGLE(&hlptim);
+        }
+
+        // 关中断再判断一次: 唤醒沿刚好落在判断和 WFI 之间时, 挂起的中断会让 WFI 立即返回
+        __disable_irq();
+        if (wake_lines == 0) {
+            HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+        }
+        __enable_irq();
+
+        // 比较器超温之类的中断也会叫醒, 没到点就接着睡
+        if (slice_done) slept += LP_SLICE_MS;
+    }
+
+    // 系统时钟就是 HSI, 醒来后不用重新配置
+    if (!slice_done) slept += LPTIM_ReadCount() * 1000 / LP_LPTIM_HZ;
+    HAL_LPTIM_SetOnce_Stop_IT(&hlptim);
+
+    EXTI->IMR = (EXTI->IMR & ~(uint32_t)wake_mask) | (imr & GUN_ZC_PIN);
+    if (!CompTrip_IsTripped() && !Board_HwTrip_IsActive()) {
+        Board_Iron_Release();
+        if (!gun_tripped) GunHeater_ClearTrip();
+    }
+    uwTick += slept;    // HAL_GetTick 接着睡之前走, 待机/自动保存的计时不会停
+    HAL_ResumeTick();
+
+    stats.count++;
+    stats.last_ms = slept;
+    stats.total_ms += slept;
+    stats.last_wake = wake_lines;
+    stats.wake_us = Sched_Micros();
+    stats.heat_latency_us = 0;
+    latency_pending = true;
+    return stats.last_wake;
+}
+
+void LowPower_MarkHeating(void)
+{
+    if (!latency_pending) return;
+    latency_pending = false;
+
+    uint32_t dt = Sched_Micros() - stats.wake_us;
+    if (dt <= LP_LATENCY_MAX_US) stats.heat_latency_us = dt;
+}
+
+const LowPowerStats_t *LowPower_GetStats(void)
+{
+    return &stats;
+}
+
+void LowPower_EXTI_IRQHandler(void)
+{
+    uint32_t pr = EXTI->PR & wake_mask;
+    if (pr == 0) return;
+
+    EXTI->PR = pr;
+    EXTI->IMR &= ~wake_mask;    // 醒了就够了, 触点抖动不再反复进中断
+    wake_lines |= (uint16_t)pr;
+}
+
+void LowPower_LPTIM_IRQHandler(void)
+{
+    if (__HAL_LPTIM_GET_FLAG(&hlptim, LPTIM_FLAG_ARRM)) {
+        __HAL_LPTIM_CLEAR_FLAG(&hlptim, LPTIM_FLAG_ARRM);
+        slice_done = true;
+    }
+}
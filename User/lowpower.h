@@ -0,0 +1,48 @@
+#ifndef __LOWPOWER_H
+#define __LOWPOWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  STOP 休眠 (LPTIM 定时唤醒 + EXTI 引脚唤醒)
+// ============================================================
+// 两路都不加热时由主循环调用 LowPower_Sleep: 内核和 HSI 停掉, 只剩 LSI 驱动 LPTIM 和看门狗。
+//   - LPTIM (LSI / 128 = 256Hz) 每 LP_SLICE_MS 单次定时唤醒一次, 只喂狗, 马上接着睡;
+//     看门狗 (500ms) 在 STOP 里照样计数, 所以间隔必须比它短。
+//   - 下列引脚任一跳变 (EXTI, 醒着的时候屏蔽) 就真正醒来, 回到调度器:
+//       烙铁开关 PA5、风枪开关 PB6、磁控 PB4、编码器 PA8/PB3、串口 RX PA10
+//     串口 RX 唤醒的那个字节收不全 (HSI 起振后 USART 才开始工作), 上位机要先发一个 0x00。
+//   - 过零 (EXTI1) 在睡眠期间屏蔽, 否则每 10ms 醒一次; 醒来后重新锁定。
+//   - 比较器超温 (EXTI17) 不屏蔽, 睡着也照样断电。
+// 按键在 TM1637 里, 要主动扫描才读得到, 不能唤醒。
+// 睡眠期间 SysTick 停了, 醒来后把睡掉的时间补进 HAL_GetTick, 待机/保存之类的计时不受影响;
+// Sched_Micros 不补 (TIM14 停了), 只用来量醒来之后的时间。
+
+#define LP_SLICE_MS         250     // LPTIM 单次定时 (每次醒来喂狗)
+
+typedef struct {
+    uint32_t count;             // 睡眠次数
+    uint32_t total_ms;          // 累计睡眠时间 (按 LPTIM 计)
+    uint32_t last_ms;           // 最近一次睡了多久
+    uint16_t last_wake;         // 最近一次唤醒的 EXTI 线 (位 = 引脚号), 0 = 不是引脚
+    uint32_t wake_us;           // 最近一次醒来的时刻 (Sched_Micros)
+    uint32_t heat_latency_us;   // 醒来 -> 第一次加热输出, 0 = 还没有
+} LowPowerStats_t;
+
+void     LowPower_Init(void);   // 在 Board_Init 之后调用 (用到 LSI, 看门狗已经把它打开了)
+
+// 睡到有引脚唤醒为止, 返回唤醒的 EXTI 线。进入时自己先 Board_Heaters_Cut 断两路加热,
+// 醒来后 (期间比较器/ADC 没有跳闸) 再撤销; 调用者负责把设定清零、等串口发完
+uint16_t LowPower_Sleep(void);
+
+// 控制任务里调用: 本周期有加热输出 -> 记下醒来后的第一次 (唤醒延迟)
+void     LowPower_MarkHeating(void);
+
+const LowPowerStats_t *LowPower_GetStats(void);
+
+// 中断入口 (见 py32f0xx_it.c)
+void     LowPower_EXTI_IRQHandler(void);    // EXTI2_3 / EXTI4_15
+void     LowPower_LPTIM_IRQHandler(void);   // LPTIM1
+
+#endif
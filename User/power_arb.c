@@ -0,0 +1,99 @@
+#include "power_arb.h"
+
+#define PWR_SCALE   1000    // 占空比满量程 (PWM 周期 / 千分比)
+
+static uint32_t Min32(uint32_t a, uint32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+void Pwr_Init(PwrArbiter_t *a, uint16_t iron_max)
+{
+    a->iron_max = iron_max;
+    a->iron_grant = 0;
+    a->gun_grant = 0;
+    a->iron_carry = 0;
+    a->throttled = 0;
+}
+
+// 烙铁在一个时隙里最多能用多少 PWM (gun_on: 这个时隙风枪导通)
+// 按峰值算: 烙铁 PWM 的每个脉冲都是满功率 iron_w, 降低占空比只降平均值, 所以只有 "全给" 和 "不给"
+static uint32_t Iron_Cap(const PwrArbiter_t *a, const PwrConfig_t *cfg, bool gun_on)
+{
+    uint32_t peak = cfg->iron_w;
+    if (gun_on) peak += cfg->gun_w;
+    return (peak <= cfg->limit_w) ? a->iron_max : 0;
+}
+
+bool Pwr_NeedLockout(const PwrConfig_t *cfg)
+{
+    if (cfg->limit_w == 0) return false;
+    return (uint32_t)cfg->iron_w + cfg->gun_w > cfg->limit_w;
+}
+
+// 风枪占空比最多给到多少, 烙铁才能平均拿到 need:
+//   烙铁平均上限 = (g * r + (1000 - g) * f) / 1000, r/f = 风枪通/断时隙的烙铁上限
+static uint32_t Gun_MaxFor(uint32_t need, uint32_t r, uint32_t f)
+{
+    if (need <= r || f <= r) return PWR_SCALE;
+    return (f - need) * PWR_SCALE / (f - r);
+}
+
+uint16_t Pwr_GunGrant(PwrArbiter_t *a, const PwrConfig_t *cfg, uint16_t iron_req, uint16_t gun_req)
+{
+    if (iron_req > a->iron_max) iron_req = a->iron_max;
+    if (gun_req > PWR_SCALE)    gun_req = PWR_SCALE;
+
+    a->iron_grant = iron_req;
+    a->gun_grant  = gun_req;
+    if (cfg->limit_w == 0 || cfg->iron_w == 0 || cfg->gun_w == 0) return gun_req;
+
+    uint32_t r = Iron_Cap(a, cfg, true);
+    uint32_t f = Iron_Cap(a, cfg, false);
+    // 风枪单独导通就超限: 只能不开
+    uint32_t gmax = (cfg->gun_w > cfg->limit_w) ? 0 : PWR_SCALE;
+    uint32_t gi, gg;
+
+    switch (cfg->priority) {
+    case PWR_PRIO_GUN:
+        gg = Min32(gun_req, gmax);
+        gi = Min32(iron_req, (gg * r + (PWR_SCALE - gg) * f) / PWR_SCALE);
+        break;
+    case PWR_PRIO_FAIR: {
+        // 烙铁保底 iron_share% 的满功率, 风枪只受这个约束; 风枪用不完的时隙都给烙铁
+        uint32_t share = (cfg->iron_share > 100) ? 100 : cfg->iron_share;
+        uint32_t li = Min32(iron_req, f * share / 100);
+        gg = Min32(Min32(gun_req, gmax), Gun_MaxFor(li, r, f));
+        gi = Min32(iron_req, (gg * r + (PWR_SCALE - gg) * f) / PWR_SCALE);
+        break;
+    }
+    case PWR_PRIO_IRON:
+    default:
+        gi = Min32(iron_req, f);
+        gg = Min32(Min32(gun_req, gmax), Gun_MaxFor(gi, r, f));
+        break;
+    }
+
+    if (gi < iron_req || gg < gun_req) a->throttled++;
+    a->iron_grant = (uint16_t)gi;
+    a->gun_grant  = (uint16_t)gg;
+    return a->gun_grant;
+}
+
+uint16_t Pwr_IronSlot(PwrArbiter_t *a, const PwrConfig_t *cfg, bool gun_on)
+{
+    uint32_t cap = a->iron_max;
+
+    // 本时隙还剩多少功率给烙铁
+    if (cfg->limit_w != 0 && cfg->iron_w != 0) cap = Iron_Cap(a, cfg, gun_on);
+
+    if (a->iron_grant == 0) a->iron_carry = 0;     // 不要热了 (到温/关机), 欠账作废
+    int32_t want = (int32_t)a->iron_grant + a->iron_carry;
+    uint16_t out = (uint16_t)Min32((uint32_t)want, cap);
+
+    // 欠账最多记一个时隙的满量程, 长时间补不上的 (风枪一直导通) 就放弃, 不能越积越多
+    a->iron_carry = want - out;
+    if (a->iron_carry > a->iron_max) a->iron_carry = a->iron_max;
+
+    return out;
+}
@@ -0,0 +1,66 @@
+#ifndef __POWER_ARB_H
+#define __POWER_ARB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  功率仲裁 (烙铁 + 风枪共用一个供电上限)
+// ============================================================
+// 限的是峰值: 任何时刻 烙铁功率 + 风枪功率 <= limit_w。烙铁 1kHz PWM 的每个脉冲都是满功率
+// iron_w, 风枪可控硅导通时就是满功率 gun_w, 降占空比只降平均值, 所以两路只有 "能同时开" 和
+// "不能同时开" 两种情况:
+//   iron_w + gun_w <= limit_w : 不用管, 两边原样输出
+//   否则 (Pwr_NeedLockout)    : 两路错开。风枪导通期间烙铁 PWM 在硬件上强制关断
+//                               (GunHeater_SetIronLockout -> Board_Iron_Lockout), 过零才放开;
+//                               下面的时隙分配再把烙铁的平均功率挪到风枪不导通的时隙里
+// iron_w 或 gun_w 单独就超过 limit_w 的那一路永远不开。
+//
+// 以控制节拍 (10ms) 为时隙, 每个节拍分两步:
+//   1. Pwr_GunGrant: 烙铁在风枪导通的时隙拿不到, 不导通的时隙可以满 PWM,
+//      所以风枪占空比越高, 烙铁能拿到的平均 PWM 越低。请求满足不了时按优先级分配:
+//        IRON : 烙铁请求先满足, 风枪占空比压到烙铁够用为止
+//        GUN  : 风枪请求先满足, 烙铁用剩下的
+//        FAIR : 烙铁保底 iron_share% 的满功率, 其余时隙归风枪, 风枪用不完的再给烙铁
+//      返回风枪这节拍可用的平均占空比, 风枪自己的 sigma-delta / 过零触发照常分配通断。
+//   2. Pwr_IronSlot: 按风枪这个时隙导不导通取烙铁上限, 让出去的部分记在 carry 里,
+//      到风枪不导通的时隙补回来, 所以烙铁平均功率就是第 1 步分到的, 只是和风枪错开了。
+//      移相触发 (PHASE) 每个半波都导通一段, 没有整段空出来的时隙, GunHeater_MayConduct 返回 false:
+//      烙铁照常输出, 导通那一段被互锁切掉, 实际平均功率比分到的少 (少的比例约等于导通时间占比),
+//      由烙铁 PID 自己补。
+// limit_w = 0 表示不限制 (两边原样输出)。
+// 不依赖 HAL, 可以在 PC 上单独编译测试。
+
+typedef enum {
+    PWR_PRIO_IRON = 0,
+    PWR_PRIO_GUN,
+    PWR_PRIO_FAIR,
+    PWR_PRIO_COUNT
+} PwrPriority_t;
+
+// 配置 (存在 Flash 设置里)
+typedef struct {
+    uint16_t limit_w;       // 供电上限 (W), 0 = 不限制
+    uint16_t iron_w;        // 烙铁 PWM 满量程 (1000) 时的功率 (W)
+    uint16_t gun_w;         // 风枪导通时的功率 (W)
+    uint8_t  priority;      // PwrPriority_t
+    uint8_t  iron_share;    // FAIR 时烙铁保底份额 (%)
+} PwrConfig_t;
+
+typedef struct {
+    uint16_t iron_max;      // 烙铁 PWM 上限 (计数, 周期 1000)
+    uint16_t iron_grant;    // 本节拍分给烙铁的平均 PWM (计数)
+    uint16_t gun_grant;     // 本节拍分给风枪的平均占空比 (千分比)
+    int32_t  iron_carry;    // 烙铁被错开、还没补上的 PWM (计数)
+    uint32_t throttled;     // 请求被削减过的节拍数
+} PwrArbiter_t;
+
+void     Pwr_Init(PwrArbiter_t *a, uint16_t iron_max);
+// 第 1 步: iron_req = PWM 计数 (0~iron_max), gun_req = 千分比; 返回风枪可用占空比
+uint16_t Pwr_GunGrant(PwrArbiter_t *a, const PwrConfig_t *cfg, uint16_t iron_req, uint16_t gun_req);
+// 第 2 步: gun_on = 风枪在本时隙会不会导通 (GunHeater_MayConduct); 返回本时隙烙铁 PWM
+uint16_t Pwr_IronSlot(PwrArbiter_t *a, const PwrConfig_t *cfg, bool gun_on);
+// 两路同时导通会超过 limit_w -> 风枪导通期间要断开烙铁
+bool     Pwr_NeedLockout(const PwrConfig_t *cfg);
+
+#endif
@@ -0,0 +1,64 @@
+#include "power_mgr.h"
+
+#define PM_MIN_MS   60000UL
+
+static const char *const state_names[] = { "ACTIVE", "STANDBY", "OFF" };
+
+void PM_Init(PowerMgr_t *pm)
+{
+    pm->state = PM_ACTIVE;
+    pm->idle_ms = 0;
+    pm->iron_was_on = false;
+}
+
+PmState_t PM_Update(PowerMgr_t *pm, const PmConfig_t *cfg, const PmInputs_t *in, uint16_t period_ms)
+{
+    bool act = in->activity || (in->iron_on != pm->iron_was_on);
+    pm->iron_was_on = in->iron_on;
+
+    if (act) {
+        pm->idle_ms = 0;
+    } else if (pm->idle_ms < UINT32_MAX - period_ms) {
+        pm->idle_ms += period_ms;
+    }
+
+    if (act || !in->iron_on) {
+        pm->state = PM_ACTIVE;
+        return pm->state;
+    }
+
+    // 两段都按 "距离上一次动作" 算, 关机时刻 = 待机 + 关机两段之和
+    uint32_t t_standby = cfg->standby_min * PM_MIN_MS;
+    uint32_t t_off     = (cfg->standby_min + cfg->off_min) * PM_MIN_MS;
+
+    if (cfg->off_min != 0 && pm->idle_ms >= t_off) {
+        pm->state = PM_OFF;
+    } else if (cfg->standby_min != 0 && pm->idle_ms >= t_standby) {
+        pm->state = PM_STANDBY;
+    }
+    return pm->state;
+}
+
+bool PM_IronEnabled(const PowerMgr_t *pm)
+{
+    return pm->state != PM_OFF;
+}
+
+int32_t PM_IronSetpoint(const PowerMgr_t *pm, const PmConfig_t *cfg, int32_t sp)
+{
+    int32_t sb = (int32_t)cfg->standby_temp * 10;
+    if (pm->state == PM_STANDBY && sp > sb) return sb;
+    return sp;
+}
+
+bool PM_SleepReady(const PowerMgr_t *pm, const PmInputs_t *in)
+{
+    if (in->busy || !in->gun_idle) return false;
+    if (in->iron_on && pm->state != PM_OFF) return false;
+    return pm->idle_ms >= PM_SLEEP_DELAY_MS;
+}
+
+const char *PM_StateName(PmState_t s)
+{
+    return (s <= PM_OFF) ? state_names[s] : "?";
+}
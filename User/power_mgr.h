@@ -0,0 +1,62 @@
+#ifndef __POWER_MGR_H
+#define __POWER_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  待机 / 自动关机 / 休眠判定
+// ============================================================
+// 烙铁没有运动传感器, "有人在用" 的依据是: 开关/磁控动作、按键、编码器、远程命令,
+// 以及烙铁头的热负载 (load_detect, 焊的时候温度会往下掉)。这些都算一次动作 (activity)。
+//
+//   ACTIVE  --无动作 standby_min 分钟-->  STANDBY (设定温度降到 standby_temp)
+//   STANDBY --再过 off_min 分钟------->  OFF     (烙铁停止加热, 开关仍然是开的)
+//   任意状态 --有动作------------------>  ACTIVE
+// standby_min = 0 跳过待机, off_min = 0 不自动关。烙铁开关关着时状态固定为 ACTIVE,
+// 重新打开开关本身就是一次动作。
+//
+// 休眠 (PM_SleepReady): 烙铁关着或已自动关、风枪在 OFF 且凉了、没有别的事在做,
+// 并且已经 PM_SLEEP_DELAY_MS 没有动作 -> 可以进 STOP, 由调用者负责进出。
+// 不依赖 HAL, 可以在 PC 上单独编译测试。
+
+#define PM_SLEEP_DELAY_MS   10000   // 条件满足后再等这么久才睡 (刚关开关时显示屏还要看一眼)
+
+typedef enum {
+    PM_ACTIVE = 0,
+    PM_STANDBY,
+    PM_OFF,
+} PmState_t;
+
+// 配置 (存在 Flash 设置里)
+typedef struct {
+    uint8_t  standby_min;   // 无动作多少分钟后待机, 0 = 不待机
+    uint8_t  off_min;       // 待机后再过多少分钟关烙铁, 0 = 不关
+    uint16_t standby_temp;  // 待机温度 (°C), 设定温度比它低时不变
+} PmConfig_t;
+
+typedef struct {
+    bool iron_on;           // 烙铁开关
+    bool activity;          // 本周期有动作 (不含烙铁开关, 开关变化在里面自己判断)
+    bool gun_idle;          // 风枪在 OFF 状态 (已经吹凉)
+    bool busy;              // 有事没做完, 不许睡 (故障未确认/设置待保存/曲线/整定/遥测)
+} PmInputs_t;
+
+typedef struct {
+    PmState_t state;
+    uint32_t  idle_ms;      // 距离上一次动作
+    bool      iron_was_on;
+} PowerMgr_t;
+
+void      PM_Init(PowerMgr_t *pm);
+// 每个周期调用一次, 返回新状态
+PmState_t PM_Update(PowerMgr_t *pm, const PmConfig_t *cfg, const PmInputs_t *in, uint16_t period_ms);
+// 烙铁允许加热 (没有被自动关)
+bool      PM_IronEnabled(const PowerMgr_t *pm);
+// 烙铁实际设定值: sp 为用户设定 (0.1°C), 待机时压到 standby_temp
+int32_t   PM_IronSetpoint(const PowerMgr_t *pm, const PmConfig_t *cfg, int32_t sp);
+// 可以进 STOP (in 为最近一次 PM_Update 的输入)
+bool      PM_SleepReady(const PowerMgr_t *pm, const PmInputs_t *in);
+const char *PM_StateName(PmState_t s);
+
+#endif
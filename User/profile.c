@@ -0,0 +1,83 @@
+#include "profile.h"
+
+#define SEG_TEMP(r)     ((int32_t)(r)->p->seg[(r)->seg].temp * 10)    // 0.1°C
+
+// 秒 -> 控制周期数
+static uint32_t To_Ticks(const ProfileRun_t *r, uint16_t s)
+{
+    return (uint32_t)s * 1000U / r->period_ms;
+}
+
+// 进入当前段的爬升阶段: 按剩余温差和周期数算出每拍增量
+static void Seg_Enter(ProfileRun_t *r)
+{
+    int32_t delta = (SEG_TEMP(r) << 16) - r->sp;
+
+    r->holding = false;
+    r->ticks = 0;
+    r->ticks_end = To_Ticks(r, r->p->seg[r->seg].ramp_s);
+    r->slope = (r->ticks_end > 0) ? delta / (int32_t)r->ticks_end : 0;
+    if (r->ticks_end == 0) r->sp = SEG_TEMP(r) << 16;
+}
+
+bool Profile_Start(ProfileRun_t *r, const GunProfile_t *p, int16_t start_temp, uint16_t period_ms)
+{
+    r->p = p;
+    if (p->n_seg == 0 || p->n_seg > PROFILE_MAX_SEGS || period_ms == 0) {
+        r->state = PROF_IDLE;
+        return false;
+    }
+
+    r->state = PROF_RUNNING;
+    r->period_ms = period_ms;
+    r->seg = 0;
+    if (start_temp < 0) start_temp = 0;
+    if (start_temp > PROFILE_TEMP_MAX * 10) start_temp = PROFILE_TEMP_MAX * 10;
+    r->sp = (int32_t)start_temp << 16;
+    Seg_Enter(r);
+    return true;
+}
+
+int16_t Profile_Step(ProfileRun_t *r)
+{
+    if (r->state != PROF_RUNNING) return (int16_t)(r->sp >> 16);
+
+    r->ticks++;
+    if (!r->holding) {
+        // 爬升: 每拍加一次斜率, 最后一拍直接落到段终点 (消除累加误差)
+        r->sp += r->slope;
+        if (r->ticks >= r->ticks_end) {
+            r->sp = SEG_TEMP(r) << 16;
+            r->holding = true;
+            r->ticks = 0;
+            r->ticks_end = To_Ticks(r, r->p->seg[r->seg].hold_s);
+        }
+    } else if (r->ticks >= r->ticks_end) {
+        if (r->seg + 1 >= r->p->n_seg) {
+            r->state = PROF_DONE;
+        } else {
+            r->seg++;
+            Seg_Enter(r);
+        }
+    }
+    return (int16_t)(r->sp >> 16);
+}
+
+void Profile_Abort(ProfileRun_t *r)
+{
+    if (r->state == PROF_RUNNING) r->state = PROF_ABORTED;
+}
+
+void Profile_Reset(ProfileRun_t *r)
+{
+    r->state = PROF_IDLE;
+}
+
+uint32_t Profile_TotalSeconds(const GunProfile_t *p)
+{
+    uint32_t s = 0;
+    for (uint8_t i = 0; i < p->n_seg && i < PROFILE_MAX_SEGS; i++) {
+        s += p->seg[i].ramp_s + p->seg[i].hold_s;
+    }
+    return s;
+}
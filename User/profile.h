@@ -0,0 +1,64 @@
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  时间-温度曲线 (风枪预热/回流)
+// ============================================================
+// 曲线由若干段组成, 每段: 从上一段的终点温度线性爬升到 temp (用 ramp_s 秒), 再保持 hold_s 秒。
+// 第一段从启动时的实测温度开始爬。降温段同样写成一段 (temp 比上一段低)。
+// 例: 预热 150°C/60s -> 保温 180°C/90s -> 峰值 230°C/20s -> 降到 100°C
+//
+// 每个控制周期调用 Profile_Step 取本拍的设定值。斜率在进入每段时算一次 (Q16),
+// 之后每拍只做一次加法, 没有乘除法。
+
+#define PROFILE_MAX_SEGS    5
+#define PROFILE_TEMP_MAX    500     // 段温度上限 (°C), 同时用来限制起点温度 (传感器故障时读数可能很大)
+
+typedef struct {
+    uint16_t temp;          // 段终点温度 (°C)
+    uint16_t ramp_s;        // 爬升时间 (秒), 0 = 直接跳到 temp
+    uint16_t hold_s;        // 到点后保持时间 (秒)
+} ProfileSeg_t;
+
+typedef struct {
+    uint8_t      n_seg;     // 有效段数 (0 = 没有曲线)
+    uint8_t      reserved;
+    ProfileSeg_t seg[PROFILE_MAX_SEGS];
+} GunProfile_t;
+
+typedef enum {
+    PROF_IDLE = 0,
+    PROF_RUNNING,
+    PROF_DONE,              // 最后一段保持结束
+    PROF_ABORTED
+} ProfileState_t;
+
+typedef struct {
+    const GunProfile_t *p;
+    ProfileState_t state;
+    uint8_t  seg;           // 当前段
+    bool     holding;       // false = 爬升中, true = 保持中
+    uint16_t period_ms;     // 调用周期
+    uint32_t ticks;         // 本阶段已走的周期数
+    uint32_t ticks_end;     // 本阶段总周期数
+    int32_t  sp;            // 当前设定值 (Q16, 0.1°C)
+    int32_t  slope;         // 每周期增量 (Q16, 0.1°C)
+} ProfileRun_t;
+
+// start_temp: 当前实测温度 (0.1°C), 第一段从这里开始爬
+// 曲线为空返回 false
+bool    Profile_Start(ProfileRun_t *r, const GunProfile_t *p, int16_t start_temp, uint16_t period_ms);
+
+// 每个控制周期调用一次, 返回本拍设定值 (0.1°C); 结束后保持最后的设定值
+int16_t Profile_Step(ProfileRun_t *r);
+
+void    Profile_Abort(ProfileRun_t *r);
+void    Profile_Reset(ProfileRun_t *r);     // 回到 IDLE (DONE / ABORTED 处理完之后)
+
+// 曲线总时长 (秒)
+uint32_t Profile_TotalSeconds(const GunProfile_t *p);
+
+#endif
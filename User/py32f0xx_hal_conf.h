@@ -42,11 +42,11 @@
 /* #define HAL_COMP_MODULE_ENABLED */  
 #define HAL_FLASH_MODULE_ENABLED   
 #define HAL_GPIO_MODULE_ENABLED    
-/* #define HAL_IWDG_MODULE_ENABLED */  
+#define HAL_IWDG_MODULE_ENABLED  
 /* #define HAL_WWDG_MODULE_ENABLED */ 
 #define HAL_TIM_MODULE_ENABLED 
 #define HAL_DMA_MODULE_ENABLED
-/* #define HAL_LPTIM_MODULE_ENABLED */  
+#define HAL_LPTIM_MODULE_ENABLED
 #define HAL_PWR_MODULE_ENABLED
 /* #define HAL_I2C_MODULE_ENABLED */ 
 #define HAL_UART_MODULE_ENABLED 
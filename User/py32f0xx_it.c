@@ -23,6 +23,16 @@
 /* Includes ------------------------------------------------------------------*/
 #include "py32f0xx_hal.h"
 #include "py32f0xx_it.h"
+#include "scheduler.h"
+#include "tm1637.h"
+#include "tach.h"
+#include "telemetry.h"
+#include "remote.h"
+#include "board_config.h"
+#include "comp_trip.h"
+#include "zero_cross.h"
+#include "gun_heater.h"
+#include "lowpower.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
@@ -48,6 +58,8 @@ void NMI_Handler(void)
   */
 void HardFault_Handler(void)
 {
+  /* 先断加热 (只写寄存器), 然后等 IWDG 复位 */
+  Board_Heaters_Cut();
   while (1)
   {
   }
@@ -82,4 +94,93 @@ void SysTick_Handler(void)
 /* please refer to the startup file.                                          */
 /******************************************************************************/
 
+/**
+  * @brief This function handles TIM14 global interrupt (scheduler tick).
+  */
+void TIM14_IRQHandler(void)
+{
+  Sched_TIM_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM16 global interrupt (TM1637 bit clock).
+  */
+void TIM16_IRQHandler(void)
+{
+  TM1637_TIM_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM17 global interrupt (fan tach capture / stall).
+  */
+void TIM17_IRQHandler(void)
+{
+  Tach_TIM_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line 0/1 interrupt (mains zero-cross).
+  */
+void EXTI0_1_IRQHandler(void)
+{
+  ZC_EXTI_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line 2/3 interrupt (STOP wakeup: encoder B).
+  */
+void EXTI2_3_IRQHandler(void)
+{
+  LowPower_EXTI_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line 4..15 interrupt (STOP wakeup: switches, reed, encoder A, UART RX).
+  */
+void EXTI4_15_IRQHandler(void)
+{
+  LowPower_EXTI_IRQHandler();
+}
+
+/**
+  * @brief This function handles LPTIM1 interrupt (STOP wakeup slice).
+  */
+void LPTIM1_IRQHandler(void)
+{
+  LowPower_LPTIM_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM3 global interrupt (gun gate pulses on CH1 compare).
+  */
+void TIM3_IRQHandler(void)
+{
+  GunHeater_TIM_IRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 channel 2/3 interrupt (telemetry UART TX).
+  */
+void DMA1_Channel2_3_IRQHandler(void)
+{
+  Telemetry_DMA_IRQHandler();
+}
+
+/**
+  * @brief This function handles ADC/COMP interrupt (analog watchdog / COMP1 -> hardware overtemperature cutoff).
+  */
+void ADC_COMP_IRQHandler(void)
+{
+  Board_ADC_AWD_IRQHandler();
+  CompTrip_IRQHandler();
+}
+
+/**
+  * @brief This function handles USART1 interrupt (idle line -> remote command).
+  */
+void USART1_IRQHandler(void)
+{
+  Remote_UART_IRQHandler();
+}
+
 /************************ (C) COPYRIGHT Puya *****END OF FILE******************/
@@ -0,0 +1,336 @@
+#include "remote.h"
+#include "telemetry.h"
+#include "settings.h"
+#include "board_config.h"
+#include "comp_trip.h"
+#include "autotune.h"
+#include "gun_logic.h"
+#include "gun_heater.h"
+#include "crc16.h"
+#include "py32f0xx_bsp_printf.h"
+#include <stddef.h>
+#include <string.h>
+
+static DMA_HandleTypeDef hdma_rx;
+
+static uint8_t           rx_buf[REMOTE_RX_BUF_SIZE];   // DMA 循环写
+static uint16_t          rx_tail = 0;                  // 已经取走的位置
+static volatile uint8_t  rx_idle = 0;                  // IDLE 中断置位, Remote_Poll 清零
+
+static uint8_t  frame[REMOTE_MAX_FRAME];                // 正在拼的一帧 (COBS 编码)
+static uint8_t  frame_len = 0;
+static bool     frame_overflow = false;                 // 超长帧: 丢到下一个 0x00 为止
+
+static uint16_t stream_period_ms = 10;                  // 默认每个控制周期一帧 (与原来一致)
+
+// ============================================================
+//  字段表: 编号 -> sys_settings 里的位置、类型、范围
+// ============================================================
+typedef struct {
+    uint8_t offset;     // offsetof(SystemSettings_t, ...)
+    uint8_t size;       // 1 / 2 / 4 字节
+    uint8_t is_signed;
+    uint8_t change;     // 写入后附加的 REMOTE_CHG_* 标志
+    int32_t min;
+    int32_t max;
+} RemoteFieldDef_t;
+
+#define FIELD(member, sgn, chg, lo, hi) \
+    { offsetof(SystemSettings_t, member), sizeof(((SystemSettings_t *)0)->member), sgn, chg, lo, hi }
+
+static const RemoteFieldDef_t fields[REMOTE_F_COUNT] = {
+    // 温度范围与按键限幅相同 (100 ~ 480°C)
+    [REMOTE_F_IRON_TARGET]     = FIELD(iron_target,     0, 0, 100, 480),
+    [REMOTE_F_GUN_TARGET]      = FIELD(gun_target,      0, 0, 100, 480),
+    // 校准: 增益 0.5 ~ 2.0, 偏移 ±50°C, 超出说明两点校准本身就有问题
+    [REMOTE_F_IRON_CAL_GAIN]   = FIELD(iron_cal.gain,   0, 0, TC_CAL_GAIN_ONE / 2, TC_CAL_GAIN_ONE * 2),
+    [REMOTE_F_IRON_CAL_OFFSET] = FIELD(iron_cal.offset, 1, 0, -500, 500),
+    [REMOTE_F_GUN_CAL_GAIN]    = FIELD(gun_cal.gain,    0, 0, TC_CAL_GAIN_ONE / 2, TC_CAL_GAIN_ONE * 2),
+    [REMOTE_F_GUN_CAL_OFFSET]  = FIELD(gun_cal.offset,  1, 0, -500, 500),
+    // PID 参数: 与自整定的上限相同
+    [REMOTE_F_IRON_KP]         = FIELD(iron_pid.Kp,     1, REMOTE_CHG_IRON_PID, 0, AT_GAIN_MAX),
+    [REMOTE_F_IRON_KI]         = FIELD(iron_pid.Ki,     1, REMOTE_CHG_IRON_PID, 0, AT_GAIN_MAX),
+    [REMOTE_F_IRON_KD]         = FIELD(iron_pid.Kd,     1, REMOTE_CHG_IRON_PID, 0, AT_KD_MAX),
+    [REMOTE_F_GUN_KP]          = FIELD(gun_pid.Kp,      1, REMOTE_CHG_GUN_PID,  0, AT_GAIN_MAX),
+    [REMOTE_F_GUN_KI]          = FIELD(gun_pid.Ki,      1, REMOTE_CHG_GUN_PID,  0, AT_GAIN_MAX),
+    [REMOTE_F_GUN_KD]          = FIELD(gun_pid.Kd,      1, REMOTE_CHG_GUN_PID,  0, AT_KD_MAX),
+    [REMOTE_F_GUN_AIRFLOW]     = FIELD(gun_airflow,     0, 0, GUN_AIRFLOW_MIN, GUN_AIRFLOW_MAX),
+    // 前馈: 满占空比 / 1°C 已经远超任何实际负载
+    [REMOTE_F_IRON_FF]         = FIELD(iron_ff,         1, 0, 0, Q16(IRON_PWM_MAX / 10.0)),
+    [REMOTE_F_PROFILE_SEGS]    = FIELD(gun_profile.n_seg, 0, 0, 0, PROFILE_MAX_SEGS),
+    [REMOTE_F_GUN_FIRE_MODE]   = FIELD(gun_fire_mode,   0, 0, 0, GUN_FIRE_COUNT - 1),
+    // 功率仲裁: 上限 0 = 不限制
+    [REMOTE_F_POWER_LIMIT]     = FIELD(power.limit_w,   0, 0, 0, 3000),
+    [REMOTE_F_IRON_WATTS]      = FIELD(power.iron_w,    0, 0, 1, 300),
+    [REMOTE_F_GUN_WATTS]       = FIELD(power.gun_w,     0, 0, 1, 2000),
+    [REMOTE_F_POWER_PRIORITY]  = FIELD(power.priority,  0, 0, 0, PWR_PRIO_COUNT - 1),
+    [REMOTE_F_IRON_SHARE]      = FIELD(power.iron_share, 0, 0, 0, 100),
+    // 待机温度下限同设定温度; 时间最长 4 小时出头 (uint8_t)
+    [REMOTE_F_STANDBY_MIN]     = FIELD(standby.standby_min,  0, 0, 0, 255),
+    [REMOTE_F_OFF_MIN]         = FIELD(standby.off_min,      0, 0, 0, 255),
+    [REMOTE_F_STANDBY_TEMP]    = FIELD(standby.standby_temp, 0, 0, 100, 480),
+};
+
+#define SEG_TIME_MAX    3600    // 单段爬升/保持最长 1 小时
+
+static int32_t Field_Get(const RemoteFieldDef_t *f)
+{
+    const uint8_t *p = (const uint8_t *)&sys_settings + f->offset;
+
+    switch (f->size) {
+    case 1:  return f->is_signed ? *(const int8_t *)p  : *(const uint8_t *)p;
+    case 2:  return f->is_signed ? *(const int16_t *)p : *(const uint16_t *)p;
+    default: return *(const int32_t *)p;
+    }
+}
+
+static void Field_Set(const RemoteFieldDef_t *f, int32_t v)
+{
+    uint8_t *p = (uint8_t *)&sys_settings + f->offset;
+
+    switch (f->size) {
+    case 1:  *p = (uint8_t)v;             break;
+    case 2:  *(uint16_t *)p = (uint16_t)v; break;
+    default: *(int32_t *)p = v;           break;
+    }
+}
+
+// ============================================================
+//  初始化: RX 改到 PA10, 循环 DMA, 打开 IDLE 中断
+// ============================================================
+void Remote_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    GPIO_InitStruct.Pin = CMD_RX_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;     // 没接串口时不乱收
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = CMD_RX_AF;
+    HAL_GPIO_Init(CMD_RX_PORT, &GPIO_InitStruct);
+
+    __HAL_RCC_DMA_CLK_ENABLE();
+    hdma_rx.Instance = DMA1_Channel3;
+    hdma_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_rx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_rx) != HAL_OK)
+    {
+        while(1);
+    }
+    HAL_DMA_ChannelMap(&hdma_rx, DMA_CHANNEL_MAP_USART1_RX);
+
+    // 不开 DMA 中断: 循环模式自己绕回, 写到哪里看 CNDTR 就知道
+    HAL_DMA_Start(&hdma_rx, (uint32_t)&DebugUartHandle.Instance->DR, (uint32_t)rx_buf, REMOTE_RX_BUF_SIZE);
+
+    // 清掉上电以来残留的状态 (读 SR 再读 DR)
+    __HAL_UART_CLEAR_IDLEFLAG(&DebugUartHandle);
+    SET_BIT(DebugUartHandle.Instance->CR3, USART_CR3_DMAR);
+    SET_BIT(DebugUartHandle.Instance->CR1, USART_CR1_IDLEIE);
+
+    // BSP 把 USART1 中断设成了最高优先级, 这里只是置个标志, 降到最低
+    HAL_NVIC_SetPriority(USART1_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+void Remote_UART_IRQHandler(void)
+{
+    USART_TypeDef *uart = DebugUartHandle.Instance;
+
+    if (uart->SR & (USART_SR_IDLE | USART_SR_ORE)) {
+        // 读 SR 再读 DR 清 IDLE/ORE; 空闲时 DR 里没有新数据, 不会抢走 DMA 的字节
+        (void)uart->DR;
+        rx_idle = 1;
+    }
+}
+
+// ============================================================
+//  命令处理
+// ============================================================
+static uint16_t Get_U16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void Put_U16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static int32_t Get_I32(const uint8_t *p)
+{
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static void Put_I32(uint8_t *p, int32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void Reply(uint8_t cmd, uint8_t status, const uint8_t *data, uint8_t len)
+{
+    uint8_t rsp[1 + 12];
+    rsp[0] = status;
+    if (len) memcpy(&rsp[1], data, len);
+    Telemetry_Send(cmd | REMOTE_RSP, rsp, 1 + len);
+}
+
+// 执行一条命令 (已经过 CRC 校验), 返回 REMOTE_CHG_*
+static uint8_t Remote_Exec(uint8_t cmd, const uint8_t *arg, uint8_t len)
+{
+    uint8_t out[12];
+    const RemoteFieldDef_t *f;
+    ProfileSeg_t *seg;
+
+    switch (cmd) {
+    case REMOTE_CMD_PING:
+        out[0] = REMOTE_PROTO_VERSION;
+        Reply(cmd, REMOTE_OK, out, 1);
+        return 0;
+
+    case REMOTE_CMD_GET:
+        if (len != 1)                 { Reply(cmd, REMOTE_ERR_LEN, NULL, 0);   return 0; }
+        if (arg[0] >= REMOTE_F_COUNT) { Reply(cmd, REMOTE_ERR_FIELD, NULL, 0); return 0; }
+        out[0] = arg[0];
+        Put_I32(&out[1], Field_Get(&fields[arg[0]]));
+        Reply(cmd, REMOTE_OK, out, 5);
+        return 0;
+
+    case REMOTE_CMD_SET: {
+        if (len != 5)                 { Reply(cmd, REMOTE_ERR_LEN, NULL, 0);   return 0; }
+        if (arg[0] >= REMOTE_F_COUNT) { Reply(cmd, REMOTE_ERR_FIELD, NULL, 0); return 0; }
+        f = &fields[arg[0]];
+        int32_t v = Get_I32(&arg[1]);
+        if (v < f->min || v > f->max) { Reply(cmd, REMOTE_ERR_RANGE, NULL, 0); return 0; }
+        Field_Set(f, v);
+        out[0] = arg[0];
+        Put_I32(&out[1], Field_Get(f));
+        Reply(cmd, REMOTE_OK, out, 5);
+        return REMOTE_CHG_SETTINGS | f->change;
+    }
+
+    case REMOTE_CMD_SAVE:
+        if (len != 0) { Reply(cmd, REMOTE_ERR_LEN, NULL, 0); return 0; }
+        Settings_Save();
+        Reply(cmd, REMOTE_OK, NULL, 0);
+        return 0;
+
+    case REMOTE_CMD_STREAM:
+        if (len != 2) { Reply(cmd, REMOTE_ERR_LEN, NULL, 0); return 0; }
+        stream_period_ms = Get_U16(arg);
+        Reply(cmd, REMOTE_OK, arg, 2);
+        return 0;
+
+    case REMOTE_CMD_PROFILE:
+        if (len != 1) { Reply(cmd, REMOTE_ERR_LEN, NULL, 0); return 0; }
+        if (arg[0] == 0) {
+            Reply(cmd, REMOTE_OK, NULL, 0);
+            return REMOTE_CHG_PROFILE_STOP;
+        }
+        if (Gun_FSM_GetState() != GUN_STATE_HEATING || sys_settings.gun_profile.n_seg == 0) {
+            Reply(cmd, REMOTE_ERR_STATE, NULL, 0);
+            return 0;
+        }
+        Reply(cmd, REMOTE_OK, NULL, 0);
+        return REMOTE_CHG_PROFILE_RUN;
+
+    case REMOTE_CMD_SEGMENT:
+        if (len != 1 && len != 7)         { Reply(cmd, REMOTE_ERR_LEN, NULL, 0);   return 0; }
+        if (arg[0] >= PROFILE_MAX_SEGS)   { Reply(cmd, REMOTE_ERR_FIELD, NULL, 0); return 0; }
+        seg = &sys_settings.gun_profile.seg[arg[0]];
+        if (len == 7) {
+            uint16_t temp = Get_U16(&arg[1]), ramp = Get_U16(&arg[3]), hold = Get_U16(&arg[5]);
+            if (temp > PROFILE_TEMP_MAX || ramp > SEG_TIME_MAX || hold > SEG_TIME_MAX) {
+                Reply(cmd, REMOTE_ERR_RANGE, NULL, 0);
+                return 0;
+            }
+            seg->temp = temp;
+            seg->ramp_s = ramp;
+            seg->hold_s = hold;
+        }
+        out[0] = arg[0];
+        Put_U16(&out[1], seg->temp);
+        Put_U16(&out[3], seg->ramp_s);
+        Put_U16(&out[5], seg->hold_s);
+        Reply(cmd, REMOTE_OK, out, 7);
+        return (len == 7) ? REMOTE_CHG_SETTINGS : 0;
+
+    case REMOTE_CMD_COUNTERS:
+        if (len != 0) { Reply(cmd, REMOTE_ERR_LEN, NULL, 0); return 0; }
+        Put_I32(&out[0], (int32_t)Board_HwTrip_GetCount());
+        Put_I32(&out[4], (int32_t)Telemetry_GetDropped());
+        Put_I32(&out[8], (int32_t)CompTrip_GetCount());
+        Reply(cmd, REMOTE_OK, out, 12);
+        return 0;
+
+    default:
+        Reply(cmd, REMOTE_ERR_CMD, NULL, 0);
+        return 0;
+    }
+}
+
+// COBS 解码 (原地), 返回解码后长度, 格式错误返回 0
+static uint8_t COBS_Decode(uint8_t *buf, uint8_t len)
+{
+    uint8_t in = 0, out = 0;
+
+    while (in < len) {
+        uint8_t code = buf[in++];
+        if (code == 0 || in + code - 1 > len) return 0;
+        for (uint8_t i = 1; i < code; i++) buf[out++] = buf[in++];
+        if (code < 0xFF && in < len) buf[out++] = 0;
+    }
+    return out;
+}
+
+static uint8_t Remote_Frame(void)
+{
+    uint8_t n = COBS_Decode(frame, frame_len);
+    if (n < 3) return 0;
+
+    uint16_t crc = frame[n - 2] | (frame[n - 1] << 8);
+    if (CRC16(frame, n - 2) != crc) return 0;   // 坏帧直接丢, 上位机超时重发
+
+    return Remote_Exec(frame[0], &frame[1], n - 3);
+}
+
+uint8_t Remote_Poll(void)
+{
+    uint8_t changed = 0;
+
+    if (!rx_idle) return 0;
+    rx_idle = 0;
+
+    uint16_t head = REMOTE_RX_BUF_SIZE - __HAL_DMA_GET_COUNTER(&hdma_rx);
+    if (head == REMOTE_RX_BUF_SIZE) head = 0;
+
+    while (rx_tail != head) {
+        uint8_t c = rx_buf[rx_tail];
+        rx_tail = (rx_tail + 1) % REMOTE_RX_BUF_SIZE;
+
+        if (c == 0) {
+            if (!frame_overflow && frame_len) changed |= Remote_Frame();
+            frame_len = 0;
+            frame_overflow = false;
+        } else if (frame_len < REMOTE_MAX_FRAME) {
+            frame[frame_len++] = c;
+        } else {
+            frame_overflow = true;
+        }
+    }
+    return changed;
+}
+
+uint16_t Remote_GetStreamPeriod(void)
+{
+    return stream_period_ms;
+}
@@ -0,0 +1,98 @@
+#ifndef __REMOTE_H
+#define __REMOTE_H
+
+#include <stdint.h>
+
+// ============================================================
+//  远程命令 (USART1 RX, 循环 DMA + 空闲线中断)
+// ============================================================
+// 接收不开字节中断: DMA 循环写 rx_buf，总线空闲 (一帧收完) 时 USART 进一次
+// IDLE 中断置标志，Remote_Poll 在任务里把新数据取走、拆帧、执行。
+//
+// 帧格式与遥测相同: COBS( cmd[1] + payload[n] + CRC16[2, 小端] ) + 0x00
+// 应答走遥测通道, type = cmd | REMOTE_RSP, payload[0] = 状态码
+//
+//   PING    -                       -> ok, REMOTE_PROTO_VERSION
+//   GET     id[1]                   -> ok, id, value[4]
+//   SET     id[1] value[4]          -> ok, id, value[4] (写入后的值)
+//   SAVE    -                       -> ok               (立即写 Flash)
+//   STREAM  period_ms[2]            -> ok, period_ms[2] (采样帧周期, 0 = 停)
+//   PROFILE run[1]                  -> ok               (1 = 开始跑风枪曲线, 0 = 停; 风枪须在加热中)
+//   SEGMENT idx[1]                  -> ok, idx, temp[2], ramp_s[2], hold_s[2]
+//   SEGMENT idx[1] temp ramp hold   -> 同上 (写入; 段数用字段 PROFILE_SEGS 设)
+//   COUNTERS -                      -> ok, hw_trips[4], telem_dropped[4], comp_trips[4]
+// 多字节一律小端; value 是 int32，按字段实际类型截取并检查范围。
+// 站在 STOP 休眠时 (见 lowpower.h) 第一个字节只用来唤醒、收不全: 上位机先发一个 0x00, 稍等再发帧。
+// 上位机工具: Misc/remote.py
+
+#define REMOTE_PROTO_VERSION    1
+#define REMOTE_RX_BUF_SIZE      128     // DMA 循环缓冲 (460800 下约 2.7ms 的数据)
+#define REMOTE_MAX_FRAME        16      // 单条命令编码后最大长度
+
+// 命令 (与 TelemType_t 共用 type 空间，不要重叠)
+typedef enum {
+    REMOTE_CMD_PING   = 0x20,
+    REMOTE_CMD_GET    = 0x21,
+    REMOTE_CMD_SET    = 0x22,
+    REMOTE_CMD_SAVE   = 0x23,
+    REMOTE_CMD_STREAM = 0x24,
+    REMOTE_CMD_PROFILE = 0x25,
+    REMOTE_CMD_SEGMENT = 0x26,
+    REMOTE_CMD_COUNTERS = 0x27,
+} RemoteCmd_t;
+
+#define REMOTE_RSP              0x80    // 应答 type = 命令 | 0x80
+
+typedef enum {
+    REMOTE_OK = 0,
+    REMOTE_ERR_CMD,         // 未知命令
+    REMOTE_ERR_LEN,         // 负载长度不对
+    REMOTE_ERR_FIELD,       // 未知字段
+    REMOTE_ERR_RANGE,       // 数值越界 (未写入)
+    REMOTE_ERR_STATE,       // 当前状态不允许 (如风枪没在加热就要跑曲线)
+} RemoteStatus_t;
+
+// 字段编号 (对应 SystemSettings_t，只能在末尾加)
+typedef enum {
+    REMOTE_F_IRON_TARGET = 0,   // °C
+    REMOTE_F_GUN_TARGET,        // °C
+    REMOTE_F_IRON_CAL_GAIN,     // Q12
+    REMOTE_F_IRON_CAL_OFFSET,   // 0.1°C
+    REMOTE_F_GUN_CAL_GAIN,
+    REMOTE_F_GUN_CAL_OFFSET,
+    REMOTE_F_IRON_KP,           // Q16
+    REMOTE_F_IRON_KI,
+    REMOTE_F_IRON_KD,
+    REMOTE_F_GUN_KP,
+    REMOTE_F_GUN_KI,
+    REMOTE_F_GUN_KD,
+    REMOTE_F_GUN_AIRFLOW,       // %
+    REMOTE_F_IRON_FF,           // Q16
+    REMOTE_F_PROFILE_SEGS,      // 风枪曲线段数
+    REMOTE_F_GUN_FIRE_MODE,     // 0 整周波, 1 移相
+    REMOTE_F_POWER_LIMIT,       // W, 0 = 不限制
+    REMOTE_F_IRON_WATTS,        // W (PWM 满量程)
+    REMOTE_F_GUN_WATTS,         // W
+    REMOTE_F_POWER_PRIORITY,    // 0 烙铁优先, 1 风枪优先, 2 按份额
+    REMOTE_F_IRON_SHARE,        // % (按份额时烙铁保底)
+    REMOTE_F_STANDBY_MIN,       // 分钟, 0 = 不待机
+    REMOTE_F_OFF_MIN,           // 分钟 (待机之后), 0 = 不自动关
+    REMOTE_F_STANDBY_TEMP,      // °C
+    REMOTE_F_COUNT
+} RemoteField_t;
+
+// Remote_Poll 的返回值: 本次改了哪些设置 (调用者据此让新值生效)
+#define REMOTE_CHG_SETTINGS     0x01    // 任意字段被写 (需要保存)
+#define REMOTE_CHG_IRON_PID     0x02    // 烙铁 PID 参数变了
+#define REMOTE_CHG_GUN_PID      0x04    // 风枪 PID 参数变了
+#define REMOTE_CHG_PROFILE_RUN  0x08    // 请求开始跑曲线 (不是设置改动)
+#define REMOTE_CHG_PROFILE_STOP 0x10    // 请求停止曲线
+
+void     Remote_Init(void);             // 在 Telemetry_Init 之后调用
+uint8_t  Remote_Poll(void);             // 在任务里周期调用
+uint16_t Remote_GetStreamPeriod(void);  // 采样帧周期 (ms), 0 = 不发
+
+// 在 USART1_IRQHandler 里调用
+void     Remote_UART_IRQHandler(void);
+
+#endif
@@ -0,0 +1,138 @@
+#include "scheduler.h"
+#include "py32f0xx_bsp_printf.h"
+
+static TIM_HandleTypeDef htim14;
+static SchedTask_t *sched_tasks;
+static uint8_t sched_count;
+static volatile uint32_t sched_ticks; // 1ms 计数
+
+// ============================================================
+//  初始化: TIM14 计数频率 1MHz，1000 跳溢出一次 = 1ms
+// ============================================================
+void Sched_Init(SchedTask_t *tasks, uint8_t count)
+{
+    sched_tasks = tasks;
+    sched_count = count;
+
+    for (uint8_t i = 0; i < count; i++) {
+        // 错开首次释放时间，避免所有任务挤在同一个 tick
+        tasks[i].countdown = i + 1;
+        tasks[i].pending = 0;
+        tasks[i].runs = 0;
+        tasks[i].overruns = 0;
+        tasks[i].long_runs = 0;
+        tasks[i].max_latency_us = 0;
+        tasks[i].max_exec_us = 0;
+    }
+
+    __HAL_RCC_TIM14_CLK_ENABLE();
+
+    htim14.Instance = TIM14;
+    htim14.Init.Prescaler = (SystemCoreClock / 1000000) - 1; // 1us 一跳
+    htim14.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim14.Init.Period = (1000000 / SCHED_TICK_HZ) - 1;
+    htim14.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim14.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(&htim14) != HAL_OK)
+    {
+        while(1);
+    }
+
+    // 优先级低于 SysTick / DMA，只是置标志，很短
+    HAL_NVIC_SetPriority(TIM14_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TIM14_IRQn);
+    HAL_TIM_Base_Start_IT(&htim14);
+}
+
+// ============================================================
+//  微秒时间戳 (tick * 1000 + 计数器)
+// ============================================================
+uint32_t Sched_Micros(void)
+{
+    uint32_t ticks, cnt;
+
+    do {
+        ticks = sched_ticks;
+        cnt = TIM14->CNT;
+    } while (ticks != sched_ticks);
+
+    // 计数器已经溢出但中断还没来得及处理
+    if (__HAL_TIM_GET_FLAG(&htim14, TIM_FLAG_UPDATE) && cnt < 500) {
+        ticks++;
+    }
+
+    return ticks * (1000000 / SCHED_TICK_HZ) + cnt;
+}
+
+// ============================================================
+//  中断: 只做计数和释放任务
+// ============================================================
+void Sched_TIM_IRQHandler(void)
+{
+    if (__HAL_TIM_GET_FLAG(&htim14, TIM_FLAG_UPDATE) == RESET) {
+        return;
+    }
+    __HAL_TIM_CLEAR_FLAG(&htim14, TIM_FLAG_UPDATE);
+
+    sched_ticks++;
+    uint32_t now = sched_ticks * (1000000 / SCHED_TICK_HZ);
+
+    for (uint8_t i = 0; i < sched_count; i++) {
+        SchedTask_t *t = &sched_tasks[i];
+        if (--t->countdown == 0) {
+            t->countdown = t->period_ms;
+            if (t->pending) {
+                t->overruns++;  // 上一次还没轮到执行
+            }
+            t->pending = 1;
+            t->release_us = now;
+        }
+    }
+}
+
+// ============================================================
+//  主循环调用: 执行优先级最高的一个到期任务，没有就睡眠等中断
+// ============================================================
+void Sched_Run(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        SchedTask_t *t = &sched_tasks[i];
+        if (!t->pending) {
+            continue;
+        }
+
+        uint32_t start = Sched_Micros();
+        uint32_t latency = start - t->release_us;
+        t->pending = 0;
+
+        t->fn();
+
+        uint32_t exec = Sched_Micros() - start;
+        t->runs++;
+        if (exec > t->period_ms * 1000U) t->long_runs++;
+        if (latency > 0xFFFF) latency = 0xFFFF;
+        if (exec > 0xFFFF)    exec = 0xFFFF;
+        t->last_latency_us = (uint16_t)latency;
+        t->last_exec_us    = (uint16_t)exec;
+        if (latency > t->max_latency_us) t->max_latency_us = latency;
+        if (exec > t->max_exec_us)       t->max_exec_us    = exec;
+        return;
+    }
+
+    __WFI(); // 没事做就睡，下一个中断 (最迟 1ms) 唤醒
+}
+
+// ============================================================
+//  打印统计 (最大值打印后清零，反映最近一个统计窗口)
+// ============================================================
+void Sched_PrintStats(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        SchedTask_t *t = &sched_tasks[i];
+        printf("[%s] %ums runs=%lu ovr=%lu long=%lu lat=%uus exec=%uus\r\n",
+               t->name, t->period_ms, t->runs, t->overruns, t->long_runs,
+               t->max_latency_us, t->max_exec_us);
+        t->max_latency_us = 0;
+        t->max_exec_us = 0;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include "py32f0xx_hal.h"
+
+// ==========================================
+//  节拍调度器 (TIM14, 1kHz)
+// ==========================================
+// TIM14 每 1ms 进一次中断，只负责给到期任务置 pending 标志；
+// 任务本身在主循环 Sched_Run() 里按表中顺序 (越靠前优先级越高) 执行，
+// 执行过程中可以被中断打断，但任务之间不会互相抢占。
+
+#define SCHED_TICK_HZ       1000    // 调度节拍 1kHz (1ms)
+
+typedef void (*SchedTaskFn)(void);
+
+typedef struct {
+    const char  *name;          // 任务名 (打印统计用)
+    SchedTaskFn  fn;            // 任务函数
+    uint16_t     period_ms;     // 运行周期 (ms)
+
+    // 运行时变量 (由调度器维护)
+    volatile uint16_t countdown;    // 距离下次释放还剩多少 tick
+    volatile uint8_t  pending;      // 已释放、等待执行
+    volatile uint32_t release_us;   // 释放时刻 (us 时间戳)
+
+    // 统计
+    uint32_t runs;              // 执行次数
+    uint32_t overruns;          // 漏释放次数 (上一次释放还没轮到执行就又到期了)
+    uint32_t long_runs;         // 执行时间超过周期的次数 (和 overruns 分开算, 同一次不会记两遍)
+    uint16_t max_latency_us;    // 释放 -> 开始执行 的最大延迟 (抖动)
+    uint16_t max_exec_us;       // 最长执行时间
+    uint16_t last_latency_us;   // 最近一次的延迟 (遥测用)
+    uint16_t last_exec_us;      // 最近一次的执行时间
+} SchedTask_t;
+
+void     Sched_Init(SchedTask_t *tasks, uint8_t count);
+void     Sched_Run(void);
+uint32_t Sched_Micros(void);
+void     Sched_PrintStats(void);
+
+// 在 TIM14_IRQHandler 里调用
+void     Sched_TIM_IRQHandler(void);
+
+#endif
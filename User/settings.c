@@ -1,85 +1,199 @@
 #include "settings.h"
+#include "crc16.h"
 #include "py32f0xx_bsp_printf.h"
-#include <string.h> // 需要用到 memset
+#include <stdbool.h>
+#include <stddef.h> // offsetof
+#include <string.h> // 需要用到 memset / memcpy / memcmp
 
 SystemSettings_t sys_settings;
 
-// 读取设置 (保持不变，可以直接读内存)
+// 一条记录 (放在页首，页内其余部分保持 0xFF)
+// data 按写入时的 length 存放: 结构体以后在末尾加字段时，旧记录照样能读，新字段取默认值
+typedef struct {
+    uint16_t magic;         // SETTINGS_MAGIC
+    uint16_t length;        // 数据长度 (写入时的 sizeof(SystemSettings_t))
+    uint16_t crc;           // seq + data[length] 的 CRC16
+    uint16_t reserved;
+    uint32_t seq;           // 递增序号，越大越新
+    SystemSettings_t data;
+} SettingsRecord_t;
+
+// 编译期检查: 一条记录必须放得进一页
+_Static_assert(sizeof(SettingsRecord_t) <= SETTINGS_PAGE_SIZE, "settings record must fit in one flash page");
+
+static int8_t   cur_page = -1;  // 最新记录所在页 (-1 = 没有记录)
+static uint32_t cur_seq  = 0;   // 最新记录的序号
+static SystemSettings_t saved;  // 最近一次写入 Flash 的内容 (没变化就不写)
+
+#define PAGE_ADDR(n)   (FLASH_USER_START_ADDR + (uint32_t)(n) * SETTINGS_PAGE_SIZE)
+
+static uint16_t Record_CRC(const SettingsRecord_t *rec)
+{
+    return CRC16((const uint8_t *)&rec->seq, sizeof(rec->seq) + rec->length);
+}
+
+static bool Record_IsValid(const SettingsRecord_t *rec)
+{
+    return rec->magic == SETTINGS_MAGIC
+        && rec->length > 0
+        && rec->length <= SETTINGS_PAGE_SIZE - offsetof(SettingsRecord_t, data)
+        && rec->crc == Record_CRC(rec);
+}
+
+// 默认值 (新加字段时在这里补上)
+static void Settings_Defaults(void)
+{
+    memset(&sys_settings, 0, sizeof(sys_settings));
+    sys_settings.iron_target = 300;
+    sys_settings.gun_target  = 350;
+    sys_settings.magic_num   = SETTINGS_MAGIC;
+    sys_settings.iron_cal.gain = TC_CAL_GAIN_ONE;
+    sys_settings.gun_cal.gain  = TC_CAL_GAIN_ONE;
+    // 误差单位是 0.1°C (1 个 ADC 码约 1.6 个单位)
+    sys_settings.iron_pid.Kp = Q16(1.2);
+    sys_settings.iron_pid.Ki = Q16(0.3);
+    sys_settings.iron_pid.Kd = Q16(0.06);
+    sys_settings.gun_pid.Kp  = Q16(3.0);
+    sys_settings.gun_pid.Ki  = Q16(0.8);    // 测量值带超前补偿 (见 main), 积分可以比原来快一倍
+    sys_settings.gun_pid.Kd  = 0;           // 风枪热惯量大、测温有滞后, 不用微分
+    sys_settings.gun_airflow = 60;
+    sys_settings.iron_ff     = Q16(0.07);   // 约 40W 发热芯 300°C 时 8W 散热, 自整定后用实测值
+
+    // 风枪曲线: 有铅回流 (出风温度, 比板上温度高一些)
+    static const GunProfile_t default_profile = {
+        .n_seg = 4,
+        .seg = {
+            { 150, 60, 30 },    // 预热: 60s 升到 150°C, 停 30s
+            { 180, 60, 60 },    // 保温: 60s 升到 180°C, 停 60s (助焊剂活化)
+            { 240, 30, 20 },    // 峰值: 30s 升到 240°C, 停 20s
+            { 120, 60, 0  },    // 降温: 60s 降到 120°C, 之后风枪进冷却
+        },
+    };
+    sys_settings.gun_profile = default_profile;
+    sys_settings.gun_fire_mode = 0;         // 整周波: 原来的过零型光耦就能用, 移相要换随机相位光耦
+
+    // 功率仲裁默认不限制 (limit_w = 0), 按实际电源填上限后生效
+    sys_settings.power.limit_w    = 0;
+    sys_settings.power.iron_w     = 40;
+    sys_settings.power.gun_w      = 700;
+    sys_settings.power.priority   = PWR_PRIO_IRON;  // 烙铁升温只要几秒, 风枪热惯量大, 晚一点不明显
+    sys_settings.power.iron_share = 30;
+
+    // 10 分钟没动作降到 200°C (烙铁头氧化慢得多, 拿起来十几秒就能回温), 再过 20 分钟关掉
+    sys_settings.standby.standby_min  = 10;
+    sys_settings.standby.off_min      = 20;
+    sys_settings.standby.standby_temp = 200;
+}
+
+static bool Page_IsErased(uint32_t addr)
+{
+    for (uint32_t i = 0; i < SETTINGS_PAGE_SIZE; i += 4) {
+        if (*(__IO uint32_t *)(addr + i) != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 读取设置: 扫描整个环，找序号最大的有效记录
 void Settings_Load(void)
 {
-    uint32_t addr = FLASH_USER_START_ADDR;
-    
-    // 读取偏移 4 字节处的 Magic Number
-    uint16_t stored_magic = *(__IO uint16_t*)(addr + 4);
+    cur_page = -1;
+    cur_seq = 0;
 
-    // 如果 Magic 不对，说明是新芯片或数据为空
-    if (stored_magic != SETTINGS_MAGIC) {
-        printf("Flash Empty! Using Defaults.\r\n");
-        // 加载默认值
-        sys_settings.iron_target = 300;
-        sys_settings.gun_target  = 350;
-        sys_settings.magic_num   = SETTINGS_MAGIC;
-        
-        // 第一次顺便保存一下
-        Settings_Save();
-    } else {
-        printf("Settings Loaded.\r\n");
-        // 直接读取地址
+    for (uint8_t n = 0; n < SETTINGS_RING_PAGES; n++) {
+        const SettingsRecord_t *rec = (const SettingsRecord_t *)PAGE_ADDR(n);
+        if (!Record_IsValid(rec)) {
+            continue;
+        }
+        if (cur_page < 0 || (int32_t)(rec->seq - cur_seq) > 0) {
+            cur_page = n;
+            cur_seq = rec->seq;
+        }
+    }
+
+    Settings_Defaults();
+
+    if (cur_page >= 0) {
+        const SettingsRecord_t *rec = (const SettingsRecord_t *)PAGE_ADDR(cur_page);
+        uint16_t len = rec->length;
+        if (len > sizeof(sys_settings)) len = sizeof(sys_settings);
+        memcpy(&sys_settings, &rec->data, len);
+        saved = sys_settings;
+        printf("Settings Loaded. (page %d, seq %lu)\r\n", cur_page, cur_seq);
+        return;
+    }
+
+    // 旧版格式 (单页，地址 +4 处是 Magic): 读出来迁移到新格式
+    uint32_t addr = FLASH_USER_START_ADDR;
+    if (*(__IO uint16_t*)(addr + 4) == SETTINGS_MAGIC) {
+        printf("Legacy Settings Found, Migrating.\r\n");
         sys_settings.iron_target = *(__IO uint16_t*)(addr);
         sys_settings.gun_target  = *(__IO uint16_t*)(addr + 2);
+    } else {
+        printf("Flash Empty! Using Defaults.\r\n");
     }
+
+    // 第一次顺便保存一下
+    Settings_Save();
 }
 
-// 保存设置 (核心修改：改为页编程)
+// 保存设置: 追加一条记录到环里的下一页
 void Settings_Save(void)
 {
-    FLASH_EraseInitTypeDef EraseInitStruct = {0};
-    uint32_t PAGEError = 0;
-    
-    // PY32F030 的一页通常是 128 字节
-    // 我们准备一个 32 个 uint32_t 的缓存数组 (32 * 4 = 128 bytes)
-    uint32_t flash_buffer[32];
-
-    // 1. 初始化缓冲区为 0xFF (擦除后的状态)
-    // 这样没用到的地方保持空白，不会乱写
-    for(int i=0; i<32; i++) {
-        flash_buffer[i] = 0xFFFFFFFF;
+    uint32_t flash_buffer[SETTINGS_PAGE_SIZE / 4];
+    SettingsRecord_t *rec = (SettingsRecord_t *)flash_buffer;
+
+    sys_settings.magic_num = SETTINGS_MAGIC;
+
+    // 内容没变就不写，省一次擦写
+    if (cur_page >= 0 && memcmp(&saved, &sys_settings, sizeof(sys_settings)) == 0) {
+        return;
     }
 
-    // 2. 将数据“打包”进缓冲区
-    // 我们的读取逻辑是：
-    // addr + 0 : iron (16bit)
-    // addr + 2 : gun  (16bit)
-    // addr + 4 : magic (16bit)
-    
-    // Word 0 (低16位存iron, 高16位存gun)
-    flash_buffer[0] = (uint32_t)sys_settings.iron_target | ((uint32_t)sys_settings.gun_target << 16);
-    
-    // Word 1 (低16位存magic)
-    flash_buffer[1] = (uint32_t)SETTINGS_MAGIC;
-
-    // 3. 解锁 Flash
+    // 1. 组装记录，页内其余部分保持 0xFF (擦除后的状态)
+    memset(flash_buffer, 0xFF, sizeof(flash_buffer));
+    rec->magic  = SETTINGS_MAGIC;
+    rec->length = sizeof(SystemSettings_t);
+    rec->reserved = 0xFFFF;
+    rec->seq    = cur_seq + 1;
+    rec->data   = sys_settings;
+    rec->crc    = Record_CRC(rec);
+
+    uint8_t page = (cur_page < 0) ? 0 : (cur_page + 1) % SETTINGS_RING_PAGES;
+    uint32_t addr = PAGE_ADDR(page);
+
+    // 2. 解锁 Flash
     HAL_FLASH_Unlock();
 
-    // 4. 擦除页
-    EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGEERASE;
-    EraseInitStruct.PageAddress = FLASH_USER_START_ADDR;
-    EraseInitStruct.NbPages     = 1;
+    // 3. 只有目标页不是空白时才擦除 (第一圈之后每次都要擦, 见 settings.h)
+    if (!Page_IsErased(addr)) {
+        FLASH_EraseInitTypeDef EraseInitStruct = {0};
+        uint32_t PAGEError = 0;
 
-    if (HAL_FLASHEx_Erase(&EraseInitStruct, &PAGEError) != HAL_OK) {
-        printf("Flash Erase Failed!\r\n");
-        HAL_FLASH_Lock();
-        return;
+        EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGEERASE;
+        EraseInitStruct.PageAddress = addr;
+        EraseInitStruct.NbPages     = 1;
+
+        if (HAL_FLASHEx_Erase(&EraseInitStruct, &PAGEError) != HAL_OK) {
+            printf("Flash Erase Failed!\r\n");
+            HAL_FLASH_Lock();
+            return;
+        }
     }
 
-    // 5. 写入一整页 (Page Program)
-    // 注意参数：FLASH_TYPEPROGRAM_PAGE, 地址, 缓冲区指针
-    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_PAGE, FLASH_USER_START_ADDR, flash_buffer) != HAL_OK) {
+    // 4. 写入一整页 (Page Program)
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_PAGE, addr, flash_buffer) != HAL_OK) {
         printf("Flash Write Failed!\r\n");
+    } else if (!Record_IsValid((const SettingsRecord_t *)addr)) {
+        printf("Flash Verify Failed!\r\n");
     } else {
-        printf("Settings Saved: Iron=%d, Gun=%d\r\n", sys_settings.iron_target, sys_settings.gun_target);
+        cur_page = page;
+        cur_seq  = rec->seq;
+        saved    = sys_settings;
+        printf("Settings Saved: Iron=%d, Gun=%d (page %d)\r\n", sys_settings.iron_target, sys_settings.gun_target, page);
     }
 
-    // 6. 上锁
+    // 5. 上锁
     HAL_FLASH_Lock();
 }
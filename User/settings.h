@@ -2,6 +2,11 @@
 #define __SETTINGS_H
 
 #include "py32f0xx_hal.h"
+#include "iron_pid.h"
+#include "thermocouple.h"
+#include "profile.h"
+#include "power_arb.h"
+#include "power_mgr.h"
 
 // Flash 存储地址 (PY32F030F18P6 是 64KB Flash)
 // 我们选倒数第 2 页，防止跟程序代码冲突，也留点余量
@@ -9,11 +14,40 @@
 // 最后一页通常在 0x0800 Fxxx 附近。我们选 0x0800 F000 绝对安全。
 #define FLASH_USER_START_ADDR   0x0800F000 
 
-// 数据结构
+// ==========================================
+//  日志式存储 (磨损均衡)
+// ==========================================
+// 从 FLASH_USER_START_ADDR 开始的 SETTINGS_RING_PAGES 页组成一个环。
+// 每次保存写入下一页 (PY32 只支持整页编程，一页就是一条记录)，
+// 记录带递增序号和 CRC，上电扫描一遍取序号最大且 CRC 正确的那条。
+// 目标页里是旧记录时先擦除: 第一圈不擦，环绕之后每次保存都要擦一页 (一页只放得下一条记录，
+// PY32 编程前必须擦除，不能在页内追加)。所以 "只在环绕时擦除" 只对第一圈成立，
+// 之后每次保存仍有一次擦除的停顿，只是分摊到 N 页上，每页的擦写次数降为原来的 1/N。
+#define SETTINGS_RING_PAGES     8
+#define SETTINGS_PAGE_SIZE      FLASH_PAGE_SIZE     // 128 字节
+
+// PID 参数 (Q16, 误差单位 0.1°C)，出厂值见 Settings_Defaults，自整定后会覆盖
+typedef struct {
+    q16_t Kp;
+    q16_t Ki;
+    q16_t Kd;
+} PID_Gains_t;
+
+// 数据结构 (只能在末尾加字段，旧记录读出来时新字段取默认值)
 typedef struct {
     uint16_t iron_target; // 烙铁设定温度
     uint16_t gun_target;  // 风枪设定温度
     uint16_t magic_num;   // 这是一个标记，用来判断Flash是不是第一次用 (是不是空的)
+    TC_Cal_t iron_cal;    // 烙铁热电偶校准
+    TC_Cal_t gun_cal;     // 风枪热电偶校准
+    PID_Gains_t iron_pid; // 烙铁 PID 参数
+    PID_Gains_t gun_pid;  // 风枪 PID 参数
+    uint8_t  gun_airflow; // 风枪风量 (%)
+    q16_t    iron_ff;     // 烙铁前馈: 维持温度所需占空比 / (温度 - 室温), Q16, 单位 计数/0.1°C
+    GunProfile_t gun_profile; // 风枪温度曲线 (预热/回流)
+    uint8_t  gun_fire_mode;   // 风枪触发方式 (GunFireMode_t: 0 整周波, 1 移相)
+    PwrConfig_t power;        // 供电上限与两路分配 (见 power_arb.h)
+    PmConfig_t  standby;      // 烙铁待机 / 自动关机 (见 power_mgr.h)
 } SystemSettings_t;
 
 // 标记值 (随便写个特殊的数)
@@ -0,0 +1,143 @@
+#include "supervisor.h"
+#include "py32f0xx_hal.h"
+
+// ============================================================
+//  加热通道检查
+// ============================================================
+void Sup_ChannelInit(SupChannel_t *c, const SupLimits_t *lim)
+{
+    c->lim = lim;
+    c->latency_ms = 0;
+    Sup_ChannelClear(c);
+}
+
+// 只清计时, 不动锁存
+static void Sup_ResetTimers(SupChannel_t *c)
+{
+    c->full_ms = 0;
+    c->full_temp = 0;
+    c->last_sum = 0;
+    c->same_ms = 0;
+    c->rail_ms = 0;
+}
+
+void Sup_ChannelClear(SupChannel_t *c)
+{
+    c->fault = SUP_OK;
+    Sup_ResetTimers(c);
+}
+
+static SupFault_t Sup_Latch(SupChannel_t *c, SupFault_t f, uint32_t latency_ms)
+{
+    c->fault = f;
+    c->latency_ms = latency_ms;
+    return f;
+}
+
+SupFault_t Sup_ChannelCheck(SupChannel_t *c, bool enabled, int16_t temp, uint16_t adc_sum, uint16_t duty,
+                            uint16_t period_ms)
+{
+    const SupLimits_t *lim = c->lim;
+
+    if (c->fault != SUP_OK) return c->fault;
+    if (!enabled) {
+        Sup_ResetTimers(c);
+        return SUP_OK;
+    }
+
+    // 1. 顶满量程 / 超温: 开关开着就查 (不管 PID 输出多少), 去抖 SUP_RAIL_MS
+    bool railed = (adc_sum >= SUP_ADC_RAIL_SUM);
+    if (railed || temp > lim->temp_max) {
+        c->rail_ms += period_ms;
+        if (c->rail_ms >= SUP_RAIL_MS) {
+            return Sup_Latch(c, railed ? SUP_FAULT_RAIL : SUP_FAULT_OVERTEMP, c->rail_ms);
+        }
+    } else {
+        c->rail_ms = 0;
+    }
+
+    // 2. 卡死: 加热中, 读数离开地电平, 和值却一直不变
+    if (duty > 0 && adc_sum >= lim->adc_stuck_min && adc_sum == c->last_sum) {
+        c->same_ms += period_ms;
+        if (c->same_ms >= lim->stuck_ms) {
+            return Sup_Latch(c, SUP_FAULT_STUCK, c->same_ms);
+        }
+    } else {
+        c->same_ms = 0;
+    }
+    c->last_sum = adc_sum;
+
+    // 3. 热失控: 满载期间每 window_ms 至少升 min_rise; 升够了就从当前温度重新计
+    if (duty >= lim->duty_high) {
+        if (c->full_ms == 0) c->full_temp = temp;
+        c->full_ms += period_ms;
+        if (temp - c->full_temp >= lim->min_rise) {
+            c->full_ms = period_ms;
+            c->full_temp = temp;
+        } else if (c->full_ms >= lim->window_ms) {
+            return Sup_Latch(c, SUP_FAULT_RUNAWAY, c->full_ms);
+        }
+    } else {
+        c->full_ms = 0;
+    }
+
+    return SUP_OK;
+}
+
+const char *Sup_FaultName(SupFault_t f)
+{
+    static const char *const names[] = { "ok", "runaway", "stuck", "rail", "overtemp" };
+    return (f <= SUP_FAULT_OVERTEMP) ? names[f] : "?";
+}
+
+// ============================================================
+//  看门狗
+// ============================================================
+static IWDG_HandleTypeDef hiwdg;
+static uint32_t wdg_required = 0;
+// 报到和喂狗都只在线程模式里调用 (Sched_Run 的任务, 互不抢占), 没有中断碰它, |= 才不用关中断。
+// 要在中断里报到的话, Sup_CheckIn 和 Sup_WatchdogService 的读改写都得关中断
+static uint32_t wdg_checkin = 0;
+
+bool Sup_WasWatchdogReset(void)
+{
+    bool wdg = (__HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) != RESET);
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+    return wdg;
+}
+
+void Sup_WatchdogInit(uint32_t required_mask)
+{
+    wdg_required = required_mask;
+    wdg_checkin = 0;
+
+    __HAL_DBGMCU_FREEZE_IWDG();     // 调试器暂停内核时看门狗也暂停
+
+    hiwdg.Instance = IWDG;
+    hiwdg.Init.Prescaler = IWDG_PRESCALER_32;
+    hiwdg.Init.Reload = (uint32_t)SUP_WDG_TIMEOUT_MS * (LSI_VALUE / 32) / 1000;
+    if (HAL_IWDG_Init(&hiwdg) != HAL_OK)
+    {
+        while(1);
+    }
+}
+
+void Sup_CheckIn(uint32_t task_bit)
+{
+    wdg_checkin |= task_bit;
+}
+
+bool Sup_WatchdogService(void)
+{
+    if ((wdg_checkin & wdg_required) != wdg_required) return false;
+
+    wdg_checkin = 0;
+    HAL_IWDG_Refresh(&hiwdg);
+    return true;
+}
+
+// 调用者 (LowPower_Sleep) 已经用 Board_Heaters_Cut 断了两路加热, 这里只证明休眠循环本身还在转
+void Sup_WatchdogKick(void)
+{
+    HAL_IWDG_Refresh(&hiwdg);
+}
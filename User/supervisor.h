@@ -0,0 +1,76 @@
+#ifndef __SUPERVISOR_H
+#define __SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  安全监控 (热失控 / 传感器故障 / 主循环卡死)
+// ============================================================
+// 每个加热通道一份 SupChannel_t, 由监控任务按固定周期调用 Sup_ChannelCheck:
+//   RUNAWAY  : 占空比接近满载持续 window_ms, 温度却没有上升 min_rise
+//              (热电偶开路读数偏低 -> PID 一直全功率, 就是这种情况)
+//   STUCK    : 加热中 ADC 原始和值 (8 次采样之和) 一点都不变 -> ADC/DMA 停了
+//   RAIL     : ADC 顶到满量程 -> 运放饱和或输入断线
+//   OVERTEMP : 温度超过绝对上限 -> 加热管常通 (MOS 击穿) 或失控
+// 读数贴地 (0) 在冷机时是正常的, 不单独判; 加热时贴地就是 RUNAWAY。
+// 只在通道开关打开时检查 (关着的时候加热已经强制停了, 手柄拔掉读数乱跳也不报)。
+// 故障锁存, 只有 Sup_ChannelClear 才解除。
+//
+// 看门狗: 各任务每次运行调用 Sup_CheckIn, 监控任务只有在 required_mask 里的
+// 任务都报到过才喂 IWDG。主循环卡死或任何一个任务不再运行, IWDG 超时复位。
+
+typedef enum {
+    SUP_OK = 0,
+    SUP_FAULT_RUNAWAY,
+    SUP_FAULT_STUCK,
+    SUP_FAULT_RAIL,
+    SUP_FAULT_OVERTEMP,
+} SupFault_t;
+
+// 每个通道的门限 (温度 0.1°C, 占空比千分比)
+typedef struct {
+    uint16_t duty_high;     // 占空比 >= 这个值才算 "满载"
+    uint16_t window_ms;     // 满载观察窗口
+    int16_t  min_rise;      // 窗口内至少要升这么多
+    int16_t  temp_max;      // 绝对温度上限
+    uint16_t stuck_ms;      // 加热中 ADC 不变超过这个时间 -> STUCK
+    uint16_t adc_stuck_min; // 和值低于它不判卡死 (贴地时没有噪声)
+} SupLimits_t;
+
+typedef struct {
+    const SupLimits_t *lim;
+    SupFault_t fault;       // 锁存的故障
+    uint32_t full_ms;       // 满载已持续时间
+    int16_t  full_temp;     // 满载窗口起点温度
+    uint16_t last_sum;      // 上一次 ADC 和值
+    uint32_t same_ms;       // ADC 和值保持不变的时间
+    uint16_t rail_ms;       // 顶满量程 / 超温持续时间 (去抖)
+    uint32_t latency_ms;    // 最近一次故障: 异常开始 -> 判定 的时间
+} SupChannel_t;
+
+#define SUP_ADC_RAIL_SUM    (4080 * 8)  // 8 次采样和, 接近 12 位满量程
+#define SUP_RAIL_MS         300         // RAIL / OVERTEMP 去抖
+
+void       Sup_ChannelInit(SupChannel_t *c, const SupLimits_t *lim);
+void       Sup_ChannelClear(SupChannel_t *c);
+
+// enabled: 通道开关是否打开, temp: 实测温度 (0.1°C), adc_sum: Board_ADC_ReadSum, duty: 本周期输出 (千分比)
+SupFault_t Sup_ChannelCheck(SupChannel_t *c, bool enabled, int16_t temp, uint16_t adc_sum, uint16_t duty,
+                            uint16_t period_ms);
+
+const char *Sup_FaultName(SupFault_t f);
+
+// ---------------- 看门狗 ----------------
+#define SUP_WDG_TIMEOUT_MS  500     // IWDG 超时 (LSI 32.768kHz / 32 -> 1.024 计数/ms)
+
+void Sup_WatchdogInit(uint32_t required_mask);
+void Sup_CheckIn(uint32_t task_bit);
+bool Sup_WatchdogService(void);     // 全部报到则喂狗并返回 true
+// 只给 STOP 休眠用: 任务都停着没法报到, 由休眠循环直接喂。
+// 前提: 两路加热已经在硬件上断开 (LowPower_Sleep 进来先调 Board_Heaters_Cut),
+// 否则控制任务停了、看门狗却照样被喂, 加热输出就没人管了
+void Sup_WatchdogKick(void);
+bool Sup_WasWatchdogReset(void);    // 上次复位是不是看门狗造成的 (在 Init 之前调用, 只能读一次)
+
+#endif
@@ -0,0 +1,178 @@
+#include "tach.h"
+#include "board_config.h"
+#include "gun_heater.h"
+#include "scheduler.h"
+
+#define TACH_US_PER_TICK    (1000000 / TACH_TICK_HZ)
+#define TACH_SPINUP_TICKS   ((uint32_t)TACH_SPINUP_MS * TACH_TICK_HZ / 1000)
+// 最慢允许的脉冲周期 (计数值)
+#define TACH_MAX_PERIOD     ((uint32_t)TACH_TICK_HZ * 60 / (TACH_MIN_RPM * TACH_PULSES_PER_REV))
+
+_Static_assert(TACH_SPINUP_TICKS <= 0xFFFF, "TIM17 is 16 bit");
+_Static_assert(TACH_MAX_PERIOD * 3 / 2 <= 0xFFFF, "TIM17 is 16 bit");
+
+static TIM_HandleTypeDef htim17;
+
+static volatile bool     tach_enabled = false;
+static volatile bool     tach_stalled = false;
+static volatile bool     tach_synced  = false;  // 窗口里的第一个沿只用来对齐, 不算周期
+static volatile bool     tach_measuring = false;
+static volatile uint32_t window_us    = 0;      // 窗口打开的时刻 (Sched_Micros)
+static volatile uint16_t tach_period  = 0;      // 最近一次周期 (计数值), 0 = 还没测到
+static volatile uint16_t tach_rpm     = 0;
+static volatile uint32_t tach_edge_us = 0;      // 最近一次沿的时刻 (Sched_Micros)
+static volatile uint32_t stall_latency_us = 0;
+
+void Tach_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    TIM_IC_InitTypeDef sConfigIC = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM17_CLK_ENABLE();
+
+    // PA7 -> TIM17_CH1 (风扇测速线一般是开漏, 开内部上拉)
+    GPIO_InitStruct.Pin = GUN_TACH_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = GUN_TACH_AF;
+    HAL_GPIO_Init(GUN_TACH_PORT, &GPIO_InitStruct);
+
+    htim17.Instance = TIM17;
+    htim17.Init.Prescaler = (SystemCoreClock / TACH_TICK_HZ) - 1;
+    htim17.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim17.Init.Period = TACH_SPINUP_TICKS - 1;
+    htim17.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim17.Init.RepetitionCounter = 0;
+    htim17.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE; // ARR 在中断里改, 要立即生效
+    if (HAL_TIM_IC_Init(&htim17) != HAL_OK)
+    {
+        while(1);
+    }
+
+    sConfigIC.ICPolarity = TIM_ICPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = 0x0F;      // 最大数字滤波, 滤掉电机换相毛刺
+    if (HAL_TIM_IC_ConfigChannel(&htim17, &sConfigIC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        while(1);
+    }
+
+    // 最高优先级: 堵转要在一个脉冲周期内切断加热
+    HAL_NVIC_SetPriority(TIM17_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM17_IRQn);
+}
+
+static void Tach_Window_Open(uint32_t timeout)
+{
+    tach_synced = false;
+    window_us = Sched_Micros();
+    tach_edge_us = window_us;
+    __HAL_TIM_SET_AUTORELOAD(&htim17, timeout - 1);
+    __HAL_TIM_SET_COUNTER(&htim17, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim17, TIM_FLAG_UPDATE | TIM_FLAG_CC1);
+    tach_measuring = true;
+    __HAL_TIM_ENABLE_IT(&htim17, TIM_IT_UPDATE);
+    HAL_TIM_IC_Start_IT(&htim17, TIM_CHANNEL_1);
+}
+
+static void Tach_Window_Close(void)
+{
+    HAL_TIM_IC_Stop_IT(&htim17, TIM_CHANNEL_1);
+    __HAL_TIM_DISABLE_IT(&htim17, TIM_IT_UPDATE);
+    tach_measuring = false;
+}
+
+void Tach_Enable(bool fan_on)
+{
+    if (fan_on == tach_enabled) return;
+
+    if (fan_on) {
+        // 起转宽限期: 1s 内必须出现第一个沿
+        tach_period = 0;
+        tach_rpm = 0;
+        tach_enabled = true;
+        Tach_Window_Open(TACH_SPINUP_TICKS);
+    } else {
+        tach_enabled = false;
+        Tach_Window_Close();
+        tach_period = 0;
+        tach_rpm = 0;
+    }
+}
+
+void Tach_Measure(void)
+{
+    if (!tach_enabled || tach_measuring) return;
+
+    // 下一个沿最晚在 1.5 个周期内到来 (对齐沿前面还有 TACH_SETTLE_US)
+    uint32_t timeout = (uint32_t)tach_period * 3 / 2;
+    if (timeout > TACH_MAX_PERIOD * 3 / 2 || timeout == 0) timeout = TACH_MAX_PERIOD * 3 / 2;
+    Tach_Window_Open(timeout + TACH_SETTLE_US / TACH_US_PER_TICK);
+}
+
+bool Tach_IsMeasuring(void)             { return tach_measuring; }
+bool Tach_HasRPM(void)                  { return tach_period != 0 || tach_stalled; }
+
+uint16_t Tach_GetRPM(void)              { return tach_rpm; }
+bool     Tach_IsStalled(void)           { return tach_stalled; }
+uint32_t Tach_GetStallLatencyUs(void)   { return stall_latency_us; }
+
+void Tach_ClearStall(void)
+{
+    tach_stalled = false;
+}
+
+void Tach_TIM_IRQHandler(void)
+{
+    // --- 捕获: 一个新的测速沿 ---
+    if (__HAL_TIM_GET_FLAG(&htim17, TIM_FLAG_CC1) != RESET) {
+        uint16_t ccr = (uint16_t)htim17.Instance->CCR1;     // 读 CCR1 同时清 CC1IF
+        // 把计数器对齐到边沿时刻, 下次的捕获值直接就是周期 (TIM17 没有从模式复位)
+        htim17.Instance->CNT -= ccr;
+        uint32_t now = Sched_Micros();
+
+        if (!tach_measuring) {
+            // 窗口刚关, 挂起的沿不算
+        } else if (now - window_us < TACH_SETTLE_US) {
+            // 风扇刚切到全速, 这个沿可能是 PWM 关断相留下的: 计数器对齐到它, 但不算对齐沿
+        } else if (tach_synced && ccr > 0) {
+            tach_edge_us = now;
+            tach_period = ccr;
+            tach_rpm = (uint16_t)((uint32_t)TACH_TICK_HZ * 60 / ((uint32_t)ccr * TACH_PULSES_PER_REV));
+            Tach_Window_Close();    // 测到一个周期就够了, 风扇回到 PWM
+        } else {
+            tach_edge_us = now;
+            tach_synced = true;
+        }
+
+        if (tach_measuring) {
+            // 下一个沿最晚在 1.5 个周期内到来, 否则判堵转
+            uint32_t timeout = (uint32_t)tach_period * 3 / 2;
+            if (timeout > TACH_MAX_PERIOD * 3 / 2 || timeout == 0) timeout = TACH_MAX_PERIOD * 3 / 2;
+            htim17.Instance->ARR = timeout - 1;
+        }
+    }
+
+    // --- 溢出: 等不到下一个沿 = 堵转 ---
+    if (__HAL_TIM_GET_FLAG(&htim17, TIM_FLAG_UPDATE) != RESET) {
+        __HAL_TIM_CLEAR_FLAG(&htim17, TIM_FLAG_UPDATE);
+
+        if (tach_enabled && tach_measuring && !tach_stalled) {
+            GunHeater_Trip();               // 先断电, 其余交给状态机
+            tach_stalled = true;
+            tach_rpm = 0;
+            Tach_Window_Close();
+
+            // 反应时间 = 现在 - (上个沿 + 一个正常周期); 起转阶段没有周期, 从开风扇算起无意义, 记 0
+            if (tach_period) {
+                uint32_t due = tach_edge_us + (uint32_t)tach_period * TACH_US_PER_TICK;
+                stall_latency_us = Sched_Micros() - due;
+            } else {
+                stall_latency_us = 0;
+            }
+        }
+    }
+}
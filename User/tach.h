@@ -0,0 +1,41 @@
+#ifndef __TACH_H
+#define __TACH_H
+
+#include "py32f0xx_hal.h"
+#include <stdbool.h>
+
+// ============================================================
+//  风扇测速 (TIM17_CH1 输入捕获, PA7) + 堵转检测
+// ============================================================
+// 每个上升沿进捕获中断: 捕获值就是周期 (中断里把计数器对齐到边沿), 顺便算 RPM。
+// ARR 设成 "上一个周期的 1.5 倍", 没等到下一个沿就溢出 = 堵转:
+// 更新中断里直接关风枪加热 (GunHeater_Trip) 并锁存, 不经过主循环。
+//
+// 风扇是低边 PWM 调速 (fan.c), 关断相里风扇的测速电路没电, 测速线被上拉拉高,
+// 每个 PWM 周期都多出一对沿, 数字滤波滤不掉 (1kHz 远比滤波时间长)。所以只在风扇
+// 全速供电时测: 测量窗口 (Tach_Measure) 由 fan.c 打开, 期间风扇强制 100%,
+// 跳过 TACH_SETTLE_US 后的第一个沿对齐, 第二个沿得到一个周期就关掉捕获, 窗口结束。
+// 窗口里照样用 ARR 超时判堵转; 窗口外捕获和超时都关着, RPM 保持上一次的测量值。
+
+#define TACH_TICK_HZ            50000   // 计数频率 50kHz (20us 分辨率, 最长 1.3s)
+#define TACH_PULSES_PER_REV     2       // 常见无刷风扇每转 2 个脉冲
+#define TACH_SPINUP_MS          1000    // 开风扇后给 1s 起转时间
+#define TACH_MIN_RPM            600     // 低于此转速视为堵转 (限制最长等待时间)
+#define TACH_SETTLE_US          2000    // 窗口开头这段时间的沿不要 (刚切到全速, PWM 最后一个关断沿)
+
+void     Tach_Init(void);
+void     Tach_Enable(bool fan_on);      // 风扇开关时调用 (控制任务), 开启时进入起转宽限期 (也是一个测量窗口)
+void     Tach_Measure(void);            // 打开一个测量窗口 (风扇没开或窗口已开着时不动)
+bool     Tach_IsMeasuring(void);        // 窗口开着: 风扇必须全速
+bool     Tach_HasRPM(void);             // 开风扇以来测到过转速 (或者已判堵转, RPM = 0 也是真值)
+uint16_t Tach_GetRPM(void);             // 最近一个窗口的转速
+bool     Tach_IsStalled(void);          // 堵转锁存标志
+void     Tach_ClearStall(void);
+
+// 最近一次堵转的反应时间: 从 "应该出现的那个沿" 到加热关断 (us)
+uint32_t Tach_GetStallLatencyUs(void);
+
+// 在 TIM17_IRQHandler 里调用
+void     Tach_TIM_IRQHandler(void);
+
+#endif
@@ -0,0 +1,175 @@
+#include "telemetry.h"
+#include "crc16.h"
+#include "py32f0xx_bsp_printf.h"
+#include <string.h>
+
+static DMA_HandleTypeDef hdma_tx;
+
+// 环形缓冲: head 由主循环 (生产者) 推进, tail 由 DMA 完成中断 (消费者) 推进
+static uint8_t           tx_buf[TELEM_TX_BUF_SIZE];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+static volatile uint16_t tx_dma_len = 0;    // 正在发送的字节数, 0 = DMA 空闲
+static volatile uint32_t tx_dropped = 0;
+
+#define TX_MASK     (TELEM_TX_BUF_SIZE - 1)
+
+// ============================================================
+//  DMA 发送
+// ============================================================
+// 发送 tail 开始的一段连续数据 (到缓冲区末尾为止, 绕回的部分下一次再发)
+// 调用前必须关中断 (主循环和更高优先级的中断都可能是生产者)
+static void TX_Kick(void)
+{
+    uint16_t head = tx_head;
+    uint16_t tail = tx_tail;
+
+    if (tx_dma_len != 0 || head == tail) return;
+
+    uint16_t len = (head > tail) ? (head - tail) : (TELEM_TX_BUF_SIZE - tail);
+    tx_dma_len = len;
+    // Telemetry_Init 之前 (Board_Init 里的 printf) DMA 还没初始化, HAL 返回 BUSY:
+    // 数据留在缓冲区里等 Init 再发, 不能把 tx_dma_len 留着, 否则以后永远不会再启动
+    if (HAL_DMA_Start_IT(&hdma_tx, (uint32_t)&tx_buf[tail], (uint32_t)&DebugUartHandle.Instance->DR, len) != HAL_OK) {
+        tx_dma_len = 0;
+    }
+}
+
+static void TX_DmaDone(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    __disable_irq();
+    tx_tail = (tx_tail + tx_dma_len) & TX_MASK;
+    tx_dma_len = 0;
+    TX_Kick();
+    __enable_irq();
+}
+
+void Telemetry_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_tx);
+}
+
+void Telemetry_Init(void)
+{
+    // 提高波特率 (BSP 默认 115200)
+    DebugUartHandle.Init.BaudRate = TELEM_BAUDRATE;
+    if (HAL_UART_Init(&DebugUartHandle) != HAL_OK)
+    {
+        while(1);
+    }
+
+    __HAL_RCC_DMA_CLK_ENABLE();
+    hdma_tx.Instance = DMA1_Channel2;
+    hdma_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_tx.Init.Mode = DMA_NORMAL;
+    hdma_tx.Init.Priority = DMA_PRIORITY_LOW;   // ADC 采样优先
+    if (HAL_DMA_Init(&hdma_tx) != HAL_OK)
+    {
+        while(1);
+    }
+    HAL_DMA_ChannelMap(&hdma_tx, DMA_CHANNEL_MAP_USART1_TX);
+    hdma_tx.XferCpltCallback = TX_DmaDone;
+
+    SET_BIT(DebugUartHandle.Instance->CR3, USART_CR3_DMAT);
+
+    HAL_NVIC_SetPriority(DMA1_Channel2_3_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);
+
+    // 发出 Init 之前攒下的输出
+    __disable_irq();
+    TX_Kick();
+    __enable_irq();
+}
+
+// ============================================================
+//  组帧
+// ============================================================
+// COBS: 每个 0x00 换成 "到下一个 0x00 的距离", 每段最长 254 字节 (这里单帧远小于此)
+static uint16_t COBS_Encode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+    uint16_t code_pos = 0;
+    uint16_t out = 1;
+    uint8_t  code = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            dst[out++] = src[i];
+            code++;
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+bool Telemetry_Send(uint8_t type, const void *payload, uint8_t len)
+{
+    uint8_t raw[1 + TELEM_MAX_PAYLOAD + 2];
+    uint8_t enc[sizeof(raw) + 2];   // COBS 开销 1 字节 + 分隔符
+
+    if (len > TELEM_MAX_PAYLOAD) return false;
+
+    raw[0] = type;
+    memcpy(&raw[1], payload, len);
+    uint16_t crc = CRC16(raw, 1 + len);
+    raw[1 + len] = (uint8_t)crc;
+    raw[2 + len] = (uint8_t)(crc >> 8);
+
+    uint16_t n = COBS_Encode(raw, 3 + len, enc);
+    enc[n++] = 0x00;
+
+    // 整帧放得下才写, 否则丢帧 (不能半帧, 也不能等)
+    // 关中断写入: 主循环和中断里都可能 printf, 帧最长 ~55 字节, 关中断时间几 us
+    __disable_irq();
+    uint16_t head = tx_head;
+    uint16_t used = (head - tx_tail) & TX_MASK;
+    if (TELEM_TX_BUF_SIZE - 1 - used < n) {
+        tx_dropped++;
+        __enable_irq();
+        return false;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        tx_buf[head] = enc[i];
+        head = (head + 1) & TX_MASK;
+    }
+    tx_head = head;
+    TX_Kick();
+    __enable_irq();
+    return true;
+}
+
+uint32_t Telemetry_GetDropped(void)
+{
+    return tx_dropped;
+}
+
+// DMA 搬完不等于发完: 移位寄存器里还有最后一个字节, 要看 TC
+bool Telemetry_IsIdle(void)
+{
+    return tx_dma_len == 0 && tx_head == tx_tail && __HAL_UART_GET_FLAG(&DebugUartHandle, UART_FLAG_TC);
+}
+
+// ============================================================
+//  printf 重定向 (覆盖 BSP 里的弱定义 _write)
+// ============================================================
+int _write(int file, char *ptr, int len)
+{
+    (void)file;
+    int sent = 0;
+
+    while (sent < len) {
+        int chunk = len - sent;
+        if (chunk > TELEM_MAX_PAYLOAD) chunk = TELEM_MAX_PAYLOAD;
+        Telemetry_Send(TELEM_TYPE_TEXT, ptr + sent, (uint8_t)chunk);
+        sent += chunk;
+    }
+    return len;
+}
@@ -0,0 +1,49 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  二进制遥测 (USART1 TX, DMA 发送环形缓冲区)
+// ============================================================
+// 帧格式: COBS( type[1] + payload[n] + CRC16[2, 小端] ) + 0x00
+//   - COBS 编码后数据里没有 0x00，0x00 只作帧分隔，丢字节后下一帧自动重新同步
+//   - CRC16-CCITT-FALSE (crc16.c)，覆盖 type + payload
+// printf 也走这里 (TELEM_TYPE_TEXT 帧)，不再逐字节阻塞发送。
+// 上位机解码脚本: Misc/telemetry_decode.py (采样写 CSV，文本原样打印)
+
+#define TELEM_BAUDRATE      460800  // 1kHz 采样约 29kB/s, 115200 不够
+#define TELEM_TX_BUF_SIZE   512     // 发送环形缓冲 (2 的幂)
+#define TELEM_MAX_PAYLOAD   48      // 单帧最大负载 (文本超过会拆成多帧)
+
+typedef enum {
+    TELEM_TYPE_SAMPLE = 0x01,       // TelemSample_t
+    TELEM_TYPE_TEXT   = 0x02,       // printf 文本
+} TelemType_t;
+
+// 控制环采样 (固定布局, 小端, 上位机按同样顺序解析)
+typedef struct __attribute__((packed)) {
+    uint32_t t_us;              // Sched_Micros 时间戳
+    int16_t  iron_sp;           // 烙铁设定 (0.1°C)
+    int16_t  iron_temp;         // 烙铁实测 (0.1°C)
+    int16_t  gun_sp;            // 风枪设定 (0.1°C)
+    int16_t  gun_temp;          // 风枪实测 (0.1°C)
+    uint16_t iron_pwm;          // 烙铁 PWM (0 ~ IRON_PWM_PERIOD)
+    uint16_t gun_duty;          // 风枪占空比 (0 ~ GUN_DUTY_MAX)
+    uint8_t  gun_state;         // GunState_t
+    uint8_t  fan_percent;       // 风扇风量 (%)
+    uint16_t fan_rpm;
+    uint16_t loop_latency_us;   // 控制任务 释放 -> 开始 (上一次)
+    uint16_t loop_exec_us;      // 控制任务执行时间 (上一次)
+} TelemSample_t;
+
+void     Telemetry_Init(void);      // 在 BSP_USART_Config 之后调用
+bool     Telemetry_Send(uint8_t type, const void *payload, uint8_t len);    // 缓冲区满返回 false (丢帧)
+uint32_t Telemetry_GetDropped(void);
+bool     Telemetry_IsIdle(void);    // 缓冲区发空且最后一个字节已经移出 (可以停时钟了)
+
+// 在 DMA1_Channel2_3_IRQHandler 里调用
+void     Telemetry_DMA_IRQHandler(void);
+
+#endif
@@ -0,0 +1,80 @@
+#include "thermocouple.h"
+
+// ==========================================
+//  编译期生成分度表
+// ==========================================
+// 热电偶电势 (uV，已减去冷端) -> 12 位 ADC 码
+#define TC_ADC(uv)          ((int16_t)((((int64_t)(uv) - TC_CJ_UV) * TC_AMP_GAIN * 4096) / ((int64_t)TC_VREF_MV * 1000)))
+
+#define TC_STEP_TENTHS      500     // 表格步长 50°C = 500 (0.1°C)
+
+// 一行: 本段起点 ADC 码 + 斜率 (0.1°C / ADC码, Q16)，斜率也在编译期算好
+#define TC_ROW(uv0, uv1)    { TC_ADC(uv0), (TC_STEP_TENTHS * 65536) / (TC_ADC(uv1) - TC_ADC(uv0)) }
+
+typedef struct {
+    int16_t  adc;       // 本段起点的 ADC 码
+    int32_t  slope;     // 0.1°C / ADC 码 (Q16)
+} TC_Row_t;
+
+// NIST ITS-90 K 型参考电势 (冷端 0°C)，0°C ~ 600°C，每 50°C 一点
+static const TC_Row_t tc_table[] = {
+    TC_ROW(    0,  2023),   //   0°C
+    TC_ROW( 2023,  4096),   //  50°C
+    TC_ROW( 4096,  6138),   // 100°C
+    TC_ROW( 6138,  8138),   // 150°C
+    TC_ROW( 8138, 10153),   // 200°C
+    TC_ROW(10153, 12209),   // 250°C
+    TC_ROW(12209, 14293),   // 300°C
+    TC_ROW(14293, 16397),   // 350°C
+    TC_ROW(16397, 18516),   // 400°C
+    TC_ROW(18516, 20644),   // 450°C
+    TC_ROW(20644, 22776),   // 500°C
+    TC_ROW(22776, 24905),   // 550°C (最后一段一直外推到 ADC 满量程)
+};
+
+#define TC_ROWS     (sizeof(tc_table) / sizeof(tc_table[0]))
+
+// 放大后 600°C 不能超过 ADC 量程，否则高温段没有意义
+_Static_assert(TC_ADC(24905) <= 4095, "TC_AMP_GAIN too high for 600C full scale");
+
+int16_t TC_AdcToTenths(uint16_t adc)
+{
+    uint8_t i = 0;
+
+    // 12 行，顺序查找就够了
+    while (i + 1 < TC_ROWS && adc >= tc_table[i + 1].adc) {
+        i++;
+    }
+
+    int32_t t = (int32_t)i * TC_STEP_TENTHS
+              + (((int32_t)adc - tc_table[i].adc) * tc_table[i].slope >> 16);
+
+    return (int16_t)t;
+}
+
+int16_t TC_Read(const TC_Cal_t *cal, uint16_t adc)
+{
+    int32_t t = TC_AdcToTenths(adc);
+
+    t = ((t * cal->gain) >> 12) + cal->offset;
+
+    return (int16_t)t;
+}
+
+void TC_Calibrate(TC_Cal_t *cal, int16_t raw1, int16_t ref1, int16_t raw2, int16_t ref2)
+{
+    if (raw2 == raw1) {
+        // 只有一个点: 只修正偏移
+        cal->gain = TC_CAL_GAIN_ONE;
+        cal->offset = ref1 - raw1;
+        return;
+    }
+
+    // gain = (ref2 - ref1) / (raw2 - raw1), offset = ref1 - raw1 * gain
+    int32_t gain = ((int32_t)(ref2 - ref1) * TC_CAL_GAIN_ONE) / (raw2 - raw1);
+    if (gain < TC_CAL_GAIN_ONE / 2) gain = TC_CAL_GAIN_ONE / 2;   // 超出 0.5~1.5 倍说明测量有误
+    if (gain > TC_CAL_GAIN_ONE * 3 / 2) gain = TC_CAL_GAIN_ONE * 3 / 2;
+
+    cal->gain = (uint16_t)gain;
+    cal->offset = (int16_t)(ref1 - (((int32_t)raw1 * gain) >> 12));
+}
@@ -0,0 +1,37 @@
+#ifndef __THERMOCOUPLE_H
+#define __THERMOCOUPLE_H
+
+#include <stdint.h>
+
+// ==========================================
+//  K 型热电偶: ADC 值 -> 温度 (0.1°C)
+// ==========================================
+// 分度表在编译期由 NIST 参考电势 (uV) 换算成 ADC 码，
+// 运行时只做查表 + 整数线性插值，不用浮点、不用除法。
+// 本模块不依赖 HAL / sys_settings，校准参数由调用者传入。
+
+// 放大电路 (按实际板子改)
+#define TC_VREF_MV          3300    // ADC 参考电压 (VCC)
+#define TC_AMP_GAIN         120     // 运放放大倍数，两个通道相同
+#define TC_CJ_UV            1000    // 冷端按 25°C 估算 (K 型 25°C 约 1.000mV)，误差由两点校准吸收
+#define TC_AMBIENT_TENTHS   250     // 同一个假设: 室温 25°C (0.1°C)，前馈模型也用它
+
+#define TC_CAL_GAIN_ONE     4096    // 校准增益 1.0 (Q12)
+
+// 两点校准参数: T = T_table * gain / 4096 + offset (保存在 SystemSettings_t 里)
+typedef struct {
+    uint16_t gain;        // Q12, 4096 = 1.0
+    int16_t  offset;      // 0.1°C
+} TC_Cal_t;
+
+// 未校准的查表结果 (0.1°C)
+int16_t TC_AdcToTenths(uint16_t adc);
+
+// 带校准的温度 (0.1°C)
+int16_t TC_Read(const TC_Cal_t *cal, uint16_t adc);
+
+// 两点校准: 在两个温度点分别记录 未校准读数 raw 和 参考温度计读数 ref (都是 0.1°C)
+// 计算出的 gain/offset 写入 cal，由调用者决定何时 Settings_Save()
+void TC_Calibrate(TC_Cal_t *cal, int16_t raw1, int16_t ref1, int16_t raw2, int16_t ref2);
+
+#endif
@@ -2,14 +2,12 @@
 #include "board_config.h"
 
 // ==========================================
-//  底层 GPIO
+//  底层 GPIO (直接写 BSRR/BRR，一条指令)
 // ==========================================
-#define CLK_LOW()   HAL_GPIO_WritePin(TM1637_CLK_PORT, TM1637_CLK_PIN, GPIO_PIN_RESET)
-#define CLK_HIGH()  HAL_GPIO_WritePin(TM1637_CLK_PORT, TM1637_CLK_PIN, GPIO_PIN_SET)
-#define DIO_LOW()   HAL_GPIO_WritePin(TM1637_DIO_PORT, TM1637_DIO_PIN, GPIO_PIN_RESET)
-#define DIO_HIGH()  HAL_GPIO_WritePin(TM1637_DIO_PORT, TM1637_DIO_PIN, GPIO_PIN_SET)
-
-static void TM1637_Delay(void) { for(volatile int i = 0; i < 50; i++) { __NOP(); } }
+#define CLK_LOW()   BOARD_PIN_LOW(TM1637_CLK_PORT, TM1637_CLK_PIN)
+#define CLK_HIGH()  BOARD_PIN_HIGH(TM1637_CLK_PORT, TM1637_CLK_PIN)
+#define DIO_LOW()   BOARD_PIN_LOW(TM1637_DIO_PORT, TM1637_DIO_PIN)
+#define DIO_HIGH()  BOARD_PIN_HIGH(TM1637_DIO_PORT, TM1637_DIO_PIN)
 
 // ==========================================
 //  1. 段码表 (Bit 5 = 小数点)
@@ -17,80 +15,328 @@ static void TM1637_Delay(void) { for(volatile int i = 0; i < 50; i++) { __NOP();
 static const uint8_t SegmentMap[] = {
     0x5F, 0x44, 0x9D, 0xD5, 0xC6, 0xD3, 0xDB, 0x45, 0xDF, 0xD7, 0x00, 0x40
 };
-static uint8_t _brightness = 2;
+#define SEG_BLANK   10  // SegmentMap 里的空白
+
+static uint8_t _brightness = TM1637_BRIGHTNESS_DEF;
 
 // ==========================================
-//  2. 底层通讯
+//  2. 异步发送引擎 (TIM16 中断驱动)
 // ==========================================
-void TM1637_Start(void) {
-    CLK_HIGH(); DIO_HIGH(); TM1637_Delay();
-    DIO_LOW(); TM1637_Delay();
-    CLK_LOW();
+// 一帧数据先"编译"成 token 序列，再由 TIM16 每半个位周期执行一步:
+//   TOK_START / TOK_STOP 是起止条件，TOK_READ 读回一个字节 (键值)，其余是要发送的字节。
+// 主循环只负责填显存/请求读键，不再在 NOP 延时里空转。
+#define TOK_START       0x100
+#define TOK_STOP        0x200
+#define TOK_READ        0x300
+#define TX_SEQ_MAX      20
+
+// 半位周期 10us (时钟 50kHz，TM1637 最高支持 250kHz)
+#define TM1637_HALF_BIT_US  10
+
+typedef enum {
+    PH_IDLE = 0,
+    PH_NEXT,        // 取下一个 token
+    PH_START,       // DIO 拉低 (CLK 为高) = 起始条件
+    PH_BIT_LOW,     // CLK 拉低，放数据位
+    PH_BIT_HIGH,    // CLK 拉高，芯片采样
+    PH_ACK_LOW,     // CLK 拉低，释放 DIO
+    PH_ACK_HIGH,    // CLK 拉高 (第 9 个时钟，应答位)
+    PH_ACK_END,     // CLK 拉低，字节结束
+    PH_RD_LOW,      // 读键: CLK 拉低，芯片在下降沿输出数据
+    PH_RD_HIGH,     // 读键: CLK 拉高，采样 DIO
+    PH_STOP_DIO,    // DIO 低 (CLK 已为低)
+    PH_STOP_CLK,    // CLK 高
+    PH_STOP_END     // DIO 高 = 停止条件
+} TxPhase_t;
+
+static TIM_HandleTypeDef htim16;
+
+static uint16_t tx_seq[TX_SEQ_MAX];
+static uint8_t  tx_len;
+static volatile uint8_t tx_pos;
+static volatile TxPhase_t tx_phase = PH_IDLE;
+static uint8_t  tx_byte;
+static uint8_t  tx_bit;
+
+// 显存 (待显示) 和 已发送的影子副本，用来判断是否需要刷新
+static uint8_t fb_pending[6];
+static uint8_t fb_sent[6];
+static uint8_t bright_sent;
+static bool    fb_valid = false;   // 影子副本是否有效 (上电后第一帧强制发送)
+static volatile bool frame_pending = false;
+static volatile bool keys_pending  = false;
+
+// 读键结果
+static volatile uint8_t key_raw = 0xFF;
+static void (*key_callback)(uint8_t raw) = 0;
+
+static void TM1637_TimerStart(void) {
+    __HAL_TIM_SET_COUNTER(&htim16, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim16, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE(&htim16);
 }
-void TM1637_Stop(void) {
-    CLK_LOW(); TM1637_Delay();
-    DIO_LOW(); TM1637_Delay();
-    CLK_HIGH(); TM1637_Delay();
-    DIO_HIGH();
+
+static void TM1637_TimerStop(void) {
+    __HAL_TIM_DISABLE(&htim16);
+}
+
+// 把挂起的请求 (显存刷新 / 读键) 编译成 token 序列并启动发送
+// 只在总线空闲时调用: 主循环里关中断调用，或传输结束时在中断里调用
+static void TM1637_Kick(void) {
+    uint8_t n = 0;
+
+    if (frame_pending) {
+        frame_pending = false;
+
+        // 数据命令: 自动地址递增
+        tx_seq[n++] = TOK_START; tx_seq[n++] = 0x40; tx_seq[n++] = TOK_STOP;
+        // 地址命令 0xC0 + 6 字节显存
+        tx_seq[n++] = TOK_START; tx_seq[n++] = 0xC0;
+        for (uint8_t i = 0; i < 6; i++) {
+            tx_seq[n++] = fb_pending[i];
+            fb_sent[i] = fb_pending[i];
+        }
+        tx_seq[n++] = TOK_STOP;
+        // 显示控制: 开显示 + 亮度
+        tx_seq[n++] = TOK_START; tx_seq[n++] = 0x88 | _brightness; tx_seq[n++] = TOK_STOP;
+
+        bright_sent = _brightness;
+        fb_valid = true;
+    }
+
+    if (keys_pending) {
+        keys_pending = false;
+
+        // 读键命令 0x42，随后读回 1 字节
+        tx_seq[n++] = TOK_START; tx_seq[n++] = 0x42; tx_seq[n++] = TOK_READ; tx_seq[n++] = TOK_STOP;
+    }
+
+    if (n == 0) {
+        return;
+    }
+
+    tx_len = n;
+    tx_pos = 0;
+    tx_phase = PH_NEXT;
+    TM1637_TimerStart();
+}
+
+// ==========================================
+//  TIM16 中断: 每次只推进一步
+// ==========================================
+void TM1637_TIM_IRQHandler(void) {
+    if (__HAL_TIM_GET_FLAG(&htim16, TIM_FLAG_UPDATE) == RESET) {
+        return;
+    }
+    __HAL_TIM_CLEAR_FLAG(&htim16, TIM_FLAG_UPDATE);
+
+    switch (tx_phase) {
+        case PH_NEXT:
+            if (tx_pos >= tx_len) {
+                tx_phase = PH_IDLE;
+                TM1637_TimerStop();
+                // 传输期间又有新请求 -> 接着发
+                if (frame_pending || keys_pending) {
+                    TM1637_Kick();
+                }
+                break;
+            }
+            {
+                uint16_t tok = tx_seq[tx_pos++];
+                if (tok == TOK_READ) {
+                    TM1637_DIO_IN();    // 释放 DIO，交给芯片驱动
+                    tx_byte = 0;
+                    tx_bit = 0;
+                    CLK_LOW();
+                    tx_phase = PH_RD_HIGH;
+                } else if (tok == TOK_START) {
+                    CLK_HIGH(); DIO_HIGH();
+                    tx_phase = PH_START;
+                } else if (tok == TOK_STOP) {
+                    CLK_LOW();
+                    tx_phase = PH_STOP_DIO;
+                } else {
+                    tx_byte = (uint8_t)tok;
+                    tx_bit = 0;
+                    CLK_LOW();
+                    if (tx_byte & 0x01) DIO_HIGH(); else DIO_LOW();
+                    tx_phase = PH_BIT_HIGH;
+                }
+            }
+            break;
+
+        case PH_START:
+            DIO_LOW();
+            tx_phase = PH_NEXT;
+            break;
+
+        case PH_BIT_LOW:
+            CLK_LOW();
+            if (tx_byte & 0x01) DIO_HIGH(); else DIO_LOW();
+            tx_phase = PH_BIT_HIGH;
+            break;
+
+        case PH_BIT_HIGH:
+            CLK_HIGH();
+            tx_byte >>= 1;
+            tx_phase = (++tx_bit < 8) ? PH_BIT_LOW : PH_ACK_LOW;
+            break;
+
+        case PH_ACK_LOW:
+            CLK_LOW(); DIO_HIGH();
+            tx_phase = PH_ACK_HIGH;
+            break;
+
+        case PH_ACK_HIGH:
+            CLK_HIGH();
+            tx_phase = PH_ACK_END;
+            break;
+
+        case PH_ACK_END:
+            CLK_LOW();
+            tx_phase = PH_NEXT;
+            break;
+
+        case PH_RD_LOW:
+            CLK_LOW();
+            tx_phase = PH_RD_HIGH;
+            break;
+
+        case PH_RD_HIGH:
+            CLK_HIGH();
+            // 低位在前
+            tx_byte >>= 1;
+            if (TM1637_DIO_READ()) tx_byte |= 0x80;
+            if (++tx_bit < 8) {
+                tx_phase = PH_RD_LOW;
+            } else {
+                key_raw = tx_byte;
+                if (key_callback) key_callback(tx_byte);
+                // 第 9 个时钟 (应答)，之后 DIO 收回为输出
+                CLK_LOW();
+                DIO_HIGH();
+                TM1637_DIO_OUT();
+                tx_phase = PH_ACK_HIGH;
+            }
+            break;
+
+        case PH_STOP_DIO:
+            DIO_LOW();
+            tx_phase = PH_STOP_CLK;
+            break;
+
+        case PH_STOP_CLK:
+            CLK_HIGH();
+            tx_phase = PH_STOP_END;
+            break;
+
+        case PH_STOP_END:
+            DIO_HIGH();
+            tx_phase = PH_NEXT;
+            break;
+
+        default:
+            tx_phase = PH_IDLE;
+            TM1637_TimerStop();
+            break;
+    }
 }
-void TM1637_WriteByte(uint8_t data) {
-    for (uint8_t i = 0; i < 8; i++) {
-        CLK_LOW();
-        if (data & 0x01) DIO_HIGH(); else DIO_LOW();
-        TM1637_Delay();
-        CLK_HIGH(); TM1637_Delay();
-        data >>= 1;
+
+void TM1637_Init(void) {
+    CLK_HIGH(); DIO_HIGH();
+
+    // DIO 上拉 (读键时芯片是开漏输出)，切换方向时不再改动
+    MODIFY_REG(TM1637_DIO_PORT->PUPDR, GPIO_PUPDR_PUPD0 << (TM1637_DIO_PIN_POS * 2),
+               GPIO_PUPDR_PUPD0_0 << (TM1637_DIO_PIN_POS * 2));
+
+    // TIM16: 1MHz 计数，TM1637_HALF_BIT_US 溢出一次；只在有数据要发时才运行
+    __HAL_RCC_TIM16_CLK_ENABLE();
+    htim16.Instance = TIM16;
+    htim16.Init.Prescaler = (SystemCoreClock / 1000000) - 1;
+    htim16.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim16.Init.Period = TM1637_HALF_BIT_US - 1;
+    htim16.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim16.Init.RepetitionCounter = 0;
+    htim16.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(&htim16) != HAL_OK)
+    {
+        while(1);
     }
-    CLK_LOW(); DIO_HIGH(); TM1637_Delay(); CLK_HIGH(); TM1637_Delay(); CLK_LOW();
+    __HAL_TIM_ENABLE_IT(&htim16, TIM_IT_UPDATE);
+
+    // 最低优先级: 时序对 TM1637 来说不敏感，晚一点也无所谓
+    HAL_NVIC_SetPriority(TIM16_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(TIM16_IRQn);
 }
-void TM1637_Init(void) { CLK_HIGH(); DIO_HIGH(); }
+
 void TM1637_SetBrightness(uint8_t brightness) { _brightness = brightness & 0x07; }
 
+bool TM1637_IsBusy(void) { return tx_phase != PH_IDLE; }
+
 // ==========================================
 //  3. 核心功能: 最终修正版
 // ==========================================
-void TM1637_Update(int iron_temp, int gun_temp)
+static void TM1637_Digits(int value, uint8_t *d100, uint8_t *d10, uint8_t *d1)
 {
-    uint8_t raw_buff[6]; // 物理显存 0xC0~0xC5
-
-    if(iron_temp > 999) iron_temp = 999;
-    if(gun_temp > 999)  gun_temp = 999;
+    if (value < 0) {
+        // 负数 = 灭灯/OFF
+        *d100 = *d10 = *d1 = SegmentMap[SEG_BLANK];
+        return;
+    }
+    if (value > 999) value = 999;
 
-    uint8_t iron_100 = SegmentMap[iron_temp / 100];
-    uint8_t iron_10  = SegmentMap[(iron_temp / 10) % 10];
-    uint8_t iron_1   = SegmentMap[iron_temp % 10];
+    *d100 = SegmentMap[value / 100];
+    *d10  = SegmentMap[(value / 10) % 10];
+    *d1   = SegmentMap[value % 10];
+}
 
-    uint8_t gun_100  = SegmentMap[gun_temp / 100];
-    uint8_t gun_10   = SegmentMap[(gun_temp / 10) % 10];
-    uint8_t gun_1    = SegmentMap[gun_temp % 10];
+void TM1637_Update(int iron_temp, int gun_temp)
+{
+    uint8_t raw_buff[6]; // 物理显存 0xC0~0xC5
 
     // --- 映射修正 (Swap Middle & Right) ---
-    
-    // 右侧 (风枪):
-    // 右1 (百位) -> 0xC2 (保持不变)
-    raw_buff[2] = gun_100;
-    // 右2 (十位) -> 改为 0xC1 (原先是 C0)
-    raw_buff[1] = gun_10; 
-    // 右3 (个位) -> 改为 0xC0 (原先是 C1)
-    raw_buff[0] = gun_1;
-
-    // 左侧 (烙铁):
-    // 左1 (百位) -> 0xC5 (保持不变)
-    raw_buff[5] = iron_100;
-    // 左2 (十位) -> 改为 0xC3 (原先是 C4)
-    raw_buff[3] = iron_10;
-    // 左3 (个位) -> 改为 0xC4 (原先是 C3)
-    raw_buff[4] = iron_1;
+    // 右侧 (风枪): 百位 -> 0xC2, 十位 -> 0xC1, 个位 -> 0xC0
+    TM1637_Digits(gun_temp,  &raw_buff[2], &raw_buff[1], &raw_buff[0]);
+    // 左侧 (烙铁): 百位 -> 0xC5, 十位 -> 0xC3, 个位 -> 0xC4
+    TM1637_Digits(iron_temp, &raw_buff[5], &raw_buff[3], &raw_buff[4]);
 
     // --- 发送 ---
     TM1637_WriteRaw(raw_buff);
 }
 
+// 空闲就立即启动，忙则等当前传输结束后由中断接着发
+static void TM1637_Flush(void) {
+    if (!TM1637_IsBusy()) {
+        TM1637_Kick();
+    }
+}
+
+// 只更新显存；内容和亮度都没变就不产生任何总线传输
 void TM1637_WriteRaw(uint8_t *buff) {
-    TM1637_Start(); TM1637_WriteByte(0x40); TM1637_Stop();
-    TM1637_Start(); TM1637_WriteByte(0xC0); 
-    for(int i=0; i<6; i++) TM1637_WriteByte(buff[i]);
-    TM1637_Stop();
-    TM1637_Start(); TM1637_WriteByte(0x88 | _brightness); TM1637_Stop();
+    __disable_irq(); // fb_pending 可能正在被中断里的 TM1637_Kick 读取
+
+    bool dirty = !fb_valid || (bright_sent != _brightness);
+    for (uint8_t i = 0; i < 6; i++) {
+        fb_pending[i] = buff[i];
+        if (fb_pending[i] != fb_sent[i]) dirty = true;
+    }
+    if (dirty) {
+        frame_pending = true;
+        TM1637_Flush();
+    }
+
+    __enable_irq();
 }
-uint8_t TM1637_ReadKeys(void) { return 0xFF; }
+
+// 请求一次读键 (0x42)，结果在中断里交给回调 (见 keypad.c)
+void TM1637_ScanKeys(void) {
+    __disable_irq();
+    keys_pending = true;
+    TM1637_Flush();
+    __enable_irq();
+}
+
+void TM1637_SetKeyCallback(void (*cb)(uint8_t raw)) { key_callback = cb; }
+
+// 最近一次读回的原始键码 (0xFF = 无按键)，不阻塞
+uint8_t TM1637_ReadKeys(void) { return key_raw; }
@@ -2,6 +2,7 @@
 #define __TM1637_H
 
 #include "py32f0xx_hal.h"
+#include <stdbool.h>
 
 // 亮度设置 (0-7)
 #define TM1637_BRIGHTNESS_MIN   0
@@ -14,11 +15,21 @@ void TM1637_Init(void);
 // 设置亮度 (0~7)
 void TM1637_SetBrightness(uint8_t brightness);
 
-// 核心功能：刷新显示
-// iron_temp: 烙铁温度 (0-999)
-// gun_temp:  风枪温度 (0-999)
+// 核心功能：刷新显示 (非阻塞，内容没变时不发送)
+// iron_temp: 烙铁温度 (0-999, 负数 = 灭灯)
+// gun_temp:  风枪温度 (0-999, 负数 = 灭灯)
 void TM1637_Update(int iron_temp, int gun_temp);
 
+// 是否还有一帧在后台发送 (false = 已发送完成)
+bool TM1637_IsBusy(void);
+
+// 在 TIM16_IRQHandler 里调用
+void TM1637_TIM_IRQHandler(void);
+
+// 读键: TM1637_ScanKeys 在后台发起一次 0x42 读，结果通过回调送出
+void TM1637_ScanKeys(void);
+void TM1637_SetKeyCallback(void (*cb)(uint8_t raw));
+// 最近一次读到的原始键码 (0xFF = 无按键)
 uint8_t TM1637_ReadKeys(void);
 
 // 测试用：检查是否所有段都亮
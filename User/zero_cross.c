@@ -0,0 +1,104 @@
+#include "zero_cross.h"
+#include "board_config.h"
+#include "gun_heater.h"
+#include "scheduler.h"
+
+static volatile uint32_t last_edge = 0;     // 上一个有效沿 (Sched_Micros)
+static volatile bool     have_edge = false;
+static volatile uint8_t  good = 0;          // 连续合理间隔数 (到 ZC_LOCK_COUNT 为止)
+static volatile uint32_t half_q4 = 0;       // 半周期滤波值 (us, Q4)
+static volatile uint32_t zc_count = 0;
+
+void ZC_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+
+    // 门极脉冲用 TIM3_CH1 比较中断 (TIM3 在 Board_Init 里已经跑起来了, CH1 没接引脚)
+    // 时刻精度靠它, 比调度器 (2) 高, 比超温切断 (0) 低
+    HAL_NVIC_SetPriority(TIM3_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(TIM3_IRQn);
+
+    // PA1: 检测光耦集电极开路输出, 内部上拉, 下降沿中断
+    GPIO_InitStruct.Pin = GUN_ZC_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(GUN_ZC_PORT, &GPIO_InitStruct);
+
+    HAL_NVIC_SetPriority(EXTI0_1_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
+}
+
+void ZC_EXTI_IRQHandler(void)
+{
+    if (!(EXTI->PR & GUN_ZC_PIN)) return;
+
+    uint16_t phase = (uint16_t)TIM3->CNT;   // 先读, 门极时刻以它为准
+    uint32_t now = Sched_Micros();
+    EXTI->PR = GUN_ZC_PIN;
+
+    uint32_t dt = now - last_edge;
+    if (have_edge && dt < ZC_GLITCH_US) return;     // 毛刺, 不动 last_edge
+    last_edge = now;
+    have_edge = true;
+
+    if (dt >= ZC_HALF_MIN_US && dt <= ZC_HALF_MAX_US) {
+        // 一阶低通 (1/8), 锁定前直接取测量值, 收敛快
+        // 差值可正可负, 用有符号数算 (无符号相减在 dt 比估计值短时会绕回)
+        if (good == 0) {
+            half_q4 = dt << 4;
+        } else {
+            int32_t err = (int32_t)(dt << 4) - (int32_t)half_q4;
+            half_q4 = (uint32_t)((int32_t)half_q4 + err / 8);
+        }
+        if (good < ZC_LOCK_COUNT) good++;
+    } else {
+        // 间隔不对 (丢了一个沿, 或者是失锁后的第一个沿): 重新开始锁定
+        if (good >= ZC_LOCK_COUNT) GunHeater_ZeroCrossLost();
+        good = 0;
+        return;
+    }
+
+    if (good >= ZC_LOCK_COUNT) {
+        zc_count++;
+        // 沿比真正的过零点提前 ZC_EDGE_LEAD_US
+        GunHeater_ZeroCross(phase, ZC_EDGE_LEAD_US, (uint16_t)(half_q4 >> 4));
+    }
+}
+
+// 丢沿看门狗: 太久没有沿就失锁, 风枪退回无同步的节拍通断
+void ZC_Poll(void)
+{
+    __disable_irq();
+    if (have_edge && Sched_Micros() - last_edge > ZC_LOST_US) {
+        if (good >= ZC_LOCK_COUNT) GunHeater_ZeroCrossLost();
+        good = 0;
+        have_edge = false;
+    }
+    __enable_irq();
+}
+
+bool ZC_IsLocked(void)
+{
+    return good >= ZC_LOCK_COUNT;
+}
+
+uint16_t ZC_GetHalfPeriodUs(void)
+{
+    return (uint16_t)(half_q4 >> 4);
+}
+
+// f = 1 / (2 * 半周期), 单位 0.01Hz: 1e8 / (2 * half_us) = 8e8 / half_q4
+uint16_t ZC_GetFreq_x100(void)
+{
+    uint32_t h = half_q4;
+    if (!ZC_IsLocked() || h == 0) return 0;
+    return (uint16_t)(800000000UL / h);
+}
+
+uint32_t ZC_GetCount(void)
+{
+    return zc_count;
+}
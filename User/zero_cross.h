@@ -0,0 +1,37 @@
+#ifndef __ZERO_CROSS_H
+#define __ZERO_CROSS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================
+//  市电过零检测 (PA1 -> EXTI1)
+// ============================================================
+// 过零检测光耦每个半波出一个低脉冲, 下降沿进 EXTI 中断, 读 Sched_Micros 当时间戳。
+// 两个沿的间隔就是半周期: 在合理范围内就滤波进频率估计, 连续 ZC_LOCK_COUNT 个
+// 合理间隔算锁定, 锁定后每个沿调用 GunHeater_ZeroCross 决定本半波怎么触发。
+// 丢沿看门狗在 ZC_Poll 里 (控制任务 10ms 调一次): ZC_LOST_US 之内等不到下一个沿
+// 就失锁 (GunHeater_ZeroCrossLost), 风枪退回无同步的节拍通断。
+//
+// 门极脉冲由 gun_heater.c 用 TIM3_CH1 比较中断排 (TIM3 是烙铁 PWM 的 1MHz / 1ms 周期计数,
+// CH1 空着), 所以沿的时刻同时记一份 TIM3 计数交过去。TIM1 给了旋转编码器 (encoder.c)。
+
+#define ZC_HALF_MIN_US      8000    // 半周期合理范围: 62.5Hz ~ 41.7Hz (50/60Hz 各留余量)
+#define ZC_HALF_MAX_US      12000   // 范围外的间隔不进滤波器, 直接重新锁定
+#define ZC_GLITCH_US        4000    // 离上一个沿这么近的沿当毛刺丢掉
+#define ZC_LOCK_COUNT       8       // 连续这么多个合理间隔才算锁定
+#define ZC_LOST_US          30000   // 这么久没有沿 -> 失锁 (ZC_Poll 10ms 查一次, 实际 30~40ms)
+#define ZC_EDGE_LEAD_US     400     // 下降沿比真正过零早多少 (约为检测脉冲宽度的一半, 换检测电路要实测)
+
+void     ZC_Init(void);
+bool     ZC_IsLocked(void);
+uint16_t ZC_GetHalfPeriodUs(void);  // 滤波后的半周期 (us)
+uint16_t ZC_GetFreq_x100(void);     // 市电频率 (0.01Hz), 没锁定返回 0
+uint32_t ZC_GetCount(void);         // 有效过零沿计数
+
+void     ZC_Poll(void);                 // 控制任务里调用 (丢沿看门狗)
+
+// 在 EXTI0_1_IRQHandler 里调用
+void     ZC_EXTI_IRQHandler(void);
+
+#endif
@@ -57,7 +57,7 @@ TGT_LDFLAGS	?= $(ARCH_FLAGS) -specs=nano.specs -specs=nosys.specs -lc -lm \
 				-Wl,--gc-sections \
 				-Wl,--print-memory-usage
 
-GCC_VERSION := $(shell $(CC) -dumpversion)
+GCC_VERSION := $(shell $(CC) -dumpversion 2>/dev/null)
 IS_GCC_ABOVE_12 := $(shell expr "$(GCC_VERSION)" ">=" "12")
 ifeq "$(IS_GCC_ABOVE_12)" "1"
     TGT_LDFLAGS += -Wl,--no-warn-rwx-segments